@@ -0,0 +1,88 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+#include <stdint.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** First bytes of an archive file, "PBAS" in little-endian order **/
+#define ARCHIVE_MAGIC   0x53414250u
+#define ARCHIVE_VERSION 1
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The ARCHIVE_HEADER struct starts every archive file. It is followed by
+ ** the count entries and then by their packed bases, packed_basis_size()
+ ** bytes each and in the same order, so any one basis can be read without
+ ** the others.
+ **/
+typedef struct archive_header_struct {
+	uint32_t magic;
+	uint32_t version;
+	int32_t narcs;
+	int32_t nnodes;
+	int32_t count;
+	int32_t reserved;
+} ARCHIVE_HEADER;
+
+/** The ARCHIVE_ENTRY struct is one archived frontier point: the iteration
+ ** of the walk that reported it and its objective pair.
+ **/
+typedef struct archive_entry_struct {
+	int32_t iteration;
+	int32_t reserved;
+	double obj1;
+	double obj2;
+} ARCHIVE_ENTRY;
+
+/** The BASIS_ARCHIVE struct keeps the packed basis of every point reported
+ ** by a walk, collected by archive_record(), which then hands the iteration
+ ** on to the next callback. bases holds count bases of size bytes each.
+ **/
+typedef struct basis_archive_struct {
+	int narcs;
+	int nnodes;
+	size_t size;
+	ARCHIVE_ENTRY * entries;
+	unsigned char * bases;
+	int count;
+	int capacity;
+	int dropped;
+	SOLVER_CALLBACK next;
+	void * next_data;
+} BASIS_ARCHIVE;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+BASIS_ARCHIVE * create_archive(int, int, SOLVER_CALLBACK, void *);
+void free_archive(BASIS_ARCHIVE **);
+int archive_record(const SOLVER_ITERATION *, void *);
+int write_archive(const BASIS_ARCHIVE *, const char *);
+NET_BASIS * read_archived_basis(const char *, int, int, int, ARCHIVE_ENTRY *);
+int parse_archive_point(const char *, char **, int *);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef BASISTREE_H
+#define BASISTREE_H
+
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/*** Representations of the spanning tree of a basis ***/
+#define BASISTREE_NONE    -1	/* no tree, CPLEX refactors the basis */
+#define BASISTREE_ARRAY    0	/* parent and child arrays */
+
+/** Number of pivots after which the potentials are computed again from
+ ** scratch, so rounding errors don't build up.
+ **/
+#define BASISTREE_REFRESH 1024
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The BASIS_TREE struct keeps the spanning tree of a network basis and the
+ ** node potentials and reduced costs of one objective under that basis. It
+ ** replaces the refactorization of the secondary objective by CPLEX after
+ ** every pivot: only the potentials of the subtree moved by the pivot change.
+ **
+ ** Arcs go from the row with coefficient 1 to the row with coefficient -1, so
+ ** dj[a] = c[a] - pi[tail] + pi[head] as reported by CPXsolution(). Each
+ ** connected component has one node whose row is basic and whose potential
+ ** is zero.
+ **
+ ** Finding the side of the entering arc takes time proportional to the tree
+ ** depth and shifting the potentials time proportional to the moved subtree,
+ ** both below the O(narcs) the walk spends on pricing every iteration.
+ **/
+typedef struct basis_tree_struct {
+	int narcs;
+	int nnodes;
+
+	int * tail;
+	int * head;
+	double * costs;
+	int * adj_first;
+	int * adj_arc;
+
+	int * arc_basis;
+	int * node_basis;
+	double * pi;
+	double * dj;
+
+	int * parent;
+	int * parent_arc;
+	int * first_child;
+	int * next_sibling;
+	int * prev_sibling;
+
+	int * moved;
+	int * stack;
+	char * mark;
+
+	int max_depth;
+	unsigned long pivots;
+	unsigned long rebuilds;
+	unsigned long since_rebuild;
+	unsigned long long walked;
+} BASIS_TREE;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+BASIS_TREE * create_basis_tree(CPXENVptr, CPXLPptr);
+void free_basis_tree(BASIS_TREE **);
+int basis_tree_load(BASIS_TREE *, const NET_BASIS *);
+int basis_tree_update(BASIS_TREE *, const NET_SOLUTION *, NET_SOLUTION *);
+void basis_tree_report(FILE *, const BASIS_TREE *);
+int basis_tree_kind(const char *);
+
+#endif
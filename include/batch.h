@@ -0,0 +1,53 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Prefix of the frontier files when no output file is given. The frontier
+ ** of scenario k is written to PREFIX.k.
+ **/
+#define BATCH_DEFAULT_PREFIX "scenario"
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The SCENARIO struct holds one supply vector of a batch and, once solved,
+ ** the bases of its anchor and perturbation solves, which are the warm starts
+ ** of the scenarios solved after it. source is the scenario it was warm
+ ** started from, or -1 for a cold solve.
+ **/
+typedef struct scenario_struct {
+	const double * supply;
+	NET_BASIS * anchor;
+	NET_BASIS * perturb;
+	int solved;
+	int status;
+	int source;
+	int npoints;
+	double elapsed;
+} SCENARIO;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+int solve_batch(SOLVER_CTX *, const char *, const char *, int);
+
+#endif
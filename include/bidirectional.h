@@ -0,0 +1,17 @@
+#ifndef BIDIRECTIONAL_H
+#define BIDIRECTIONAL_H
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "frontier.h"
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+int solve_bidirectional(const char *, const char *, FRONTIER *);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef COSTSCALE_H
+#define COSTSCALE_H
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Factor epsilon is divided by between two refine passes **/
+#define COSTSCALE_ALPHA 8
+
+/** Largest power of ten the arc costs are multiplied by to make them
+ ** integral. Costs that stay fractional make the engine refuse the problem.
+ **/
+#define COSTSCALE_MAX_MULTIPLIER 1e6
+
+/** Tolerance used to decide if a flow is at one of the bounds of its arc **/
+#define COSTSCALE_TOL 1e-9
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+int cost_scaling_flow(const NET_TOPOLOGY *, const double *, double *, double *);
+int spanning_tree_basis(const NET_TOPOLOGY *, const double *, const double *, double *, int *, int *);
+
+#endif
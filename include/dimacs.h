@@ -0,0 +1,33 @@
+#ifndef DIMACS_H
+#define DIMACS_H
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Smallest chunk handed to a parsing thread, and the number of chunks made
+ ** per thread so that threads finishing early can take more work.
+ **/
+#define DIMACS_MIN_CHUNK (1UL << 20)
+#define DIMACS_CHUNKS_PER_THREAD 4
+
+/** Longest number accepted in a DIMACS line **/
+#define DIMACS_MAX_TOKEN 64
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+int read_dimacs(const char *, const char *, int, NET_TOPOLOGY **, double **, double **);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef FRONTIER_H
+#define FRONTIER_H
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "solver.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Two objective values closer than FRONTIER_TOL are taken as equal when
+ ** points of the frontier are compared.
+ **/
+#define FRONTIER_TOL 1e-9
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The FRONTIER_POINT struct holds one extreme non-dominated solution of the
+ ** bi-objective problem. lambda_lo and lambda_hi bound the interval of weights
+ ** w for which the point minimizes Z(x) = w*z1(x) + (1 - w)*z2(x), and they
+ ** are only valid after frontier_finalize() is called.
+ **/
+typedef struct frontier_point_struct {
+	double obj1;
+	double obj2;
+	double lambda_lo;
+	double lambda_hi;
+	int iteration;
+	int arc;
+} FRONTIER_POINT;
+
+/** The FRONTIER struct is a growing array of points, kept in the order they
+ ** were found. After frontier_finalize() the points are sorted by decreasing
+ ** objective 2 value, i.e., from the objective 1 end to the objective 2 end.
+ **/
+typedef struct frontier_struct {
+	FRONTIER_POINT * points;
+	int npoints;
+	int capacity;
+} FRONTIER;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+FRONTIER * create_frontier(void);
+void free_frontier(FRONTIER **);
+int frontier_add(FRONTIER *, double, double, int, int);
+int frontier_record(const SOLVER_ITERATION *, void *);
+void frontier_finalize(FRONTIER *);
+void print_frontier(const FRONTIER *);
+void fprint_frontier(FILE *, const FRONTIER *);
+
+#endif
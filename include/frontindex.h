@@ -0,0 +1,117 @@
+#ifndef FRONTINDEX_H
+#define FRONTINDEX_H
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+#include <stdint.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+#include "frontier.h"
+#include "reduce.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** First bytes of a frontier index file, "FIDX" in little-endian order **/
+#define INDEX_MAGIC   0x58444946u
+#define INDEX_VERSION 1
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The INDEX_HEADER struct starts every frontier index file. The flows of
+ ** the points follow it, narcs doubles per point in the order the walk
+ ** reported them, and the table of count entries starts at byte table.
+ ** Every offset is from the start of the file.
+ **/
+typedef struct index_header_struct {
+	uint32_t magic;
+	uint32_t version;
+	int32_t narcs;
+	int32_t count;
+	uint64_t table;
+} INDEX_HEADER;
+
+/** The INDEX_ENTRY struct is one point of the frontier. Entries are sorted by
+ ** increasing objective 2 value, so objective 1 decreases along the table and
+ ** the weight intervals [lambda_lo, lambda_hi] of w*z1 + (1 - w)*z2 increase.
+ **/
+typedef struct index_entry_struct {
+	double obj1;
+	double obj2;
+	double lambda_lo;
+	double lambda_hi;
+	uint64_t flow;
+	int32_t iteration;
+	int32_t reserved;
+} INDEX_ENTRY;
+
+/** The INDEX_WRITER struct builds an index file while the walk runs: the
+ ** flow of every point reported to index_record() is appended to the file
+ ** at once and only the objective pairs and the offsets are kept in memory.
+ ** The table is sorted and written by close_index_writer(). Flows of a
+ ** reduced network are expanded to the original arcs.
+ **/
+typedef struct index_writer_struct {
+	FILE * fp;
+	int narcs;
+	FRONTIER * frontier;
+	int * iterations;
+	uint64_t * offsets;
+	int nrecords;
+	int capacity;
+	uint64_t end;
+
+	const NET_REDUCTION * reduction;
+	double * slot_flow;
+	double * orig_flow;
+
+	SOLVER_CALLBACK next;
+	void * next_data;
+} INDEX_WRITER;
+
+/** The FRONTIER_INDEX struct is an index file mapped read-only into memory.
+ ** Queries only touch the pages of the table they search and the flow of
+ ** the point they return.
+ **/
+typedef struct frontier_index_struct {
+	const unsigned char * map;
+	size_t size;
+	const INDEX_HEADER * header;
+	const INDEX_ENTRY * entries;
+	int count;
+	int narcs;
+} FRONTIER_INDEX;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+INDEX_WRITER * open_index_writer(const char *, const SOLVER_CTX *, SOLVER_CALLBACK, void *);
+int index_record(const SOLVER_ITERATION *, void *);
+int close_index_writer(INDEX_WRITER **);
+FRONTIER_INDEX * open_frontier_index(const char *);
+void close_frontier_index(FRONTIER_INDEX **);
+int index_budget(const FRONTIER_INDEX *, double);
+int index_weight(const FRONTIER_INDEX *, double);
+double index_budget_bound(const FRONTIER_INDEX *, double);
+const double * index_flow(const FRONTIER_INDEX *, int);
+int index_query(const FRONTIER_INDEX *, const char *, FILE *);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef HUGEPAGE_H
+#define HUGEPAGE_H
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+#include <stddef.h>
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/*** Allocation policies of the large network arrays ***/
+#define MEM_DEFAULT 0	/* plain malloc */
+#define MEM_THP     1	/* 2 MB aligned, transparent huge pages requested by madvise */
+#define MEM_HUGETLB 2	/* explicit huge pages from the hugetlb pool, THP as fallback */
+
+/** Size of the huge pages assumed by the policies **/
+#define MEM_HUGE_PAGE (2UL << 20)
+
+/** Arrays smaller than this never use huge pages: they would waste most of
+ ** the page and barely reduce the TLB misses.
+ **/
+#define MEM_HUGE_THRESHOLD MEM_HUGE_PAGE
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+void mem_set_policy(int);
+int mem_policy(const char *);
+const char * mem_policy_name(int);
+void * mem_alloc(size_t);
+void mem_free(void *);
+void mem_report(FILE *);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef NETWORK_H
+#define NETWORK_H
+
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The NET_BASIS struct is made with two arrays of specific size and holds the
+ ** information of a basis associated to a given problem. The first array must
+ ** have a length equal to the number of arcs and the second array must have a
+ ** length equal to the number of nodes in the network problem.
+ **/
+typedef struct net_basis_struct {
+	int * arc_basis;
+	int * node_basis;
+} NET_BASIS;
+
+/** A status of the basis (CPX_AT_LOWER, CPX_BASIC, CPX_AT_UPPER or
+ ** CPX_FREE_SUPER) fits in 2 bits, so a packed basis stores four statuses per
+ ** byte: PACKED_SIZE(n) bytes for n statuses.
+ **/
+#define PACKED_SIZE(n) (((size_t) (n) + 3) / 4)
+
+/*** Methods to handle the NET_BASIS struct ***/
+NET_BASIS * create_basis(int, int);
+void free_basis(NET_BASIS **);
+void copy_basis(NET_BASIS *, const NET_BASIS *, int, int);
+size_t packed_basis_size(int, int);
+void pack_basis(unsigned char *, const NET_BASIS *, int, int);
+void unpack_basis(NET_BASIS *, const unsigned char *, int, int);
+
+
+/** The NET_SOLUTION struct holds all the information of a specific solution to
+ ** a network problem, including the basis associated. The arrays x and dj must
+ ** have a length equal to the number of arcs in the network and the arrays pi
+ ** and slack must have a length equal to the number of nodes. The integer value
+ ** solstat is an indicator of the status of the solution, with 1 being an
+ ** optimal solution and 10 indicating the optimization was stopped due to the
+ ** limit of iterations being reached.
+ **/
+typedef struct net_sol_struct {
+	double * x;
+	double * dj;
+	double * pi;
+	double * slack;
+	double objval;
+	int solstat;
+	NET_BASIS * basis;
+} NET_SOLUTION;
+
+/*** Methods to handle the NET_SOLUTION struct ***/
+NET_SOLUTION * create_solution(int, int);
+void free_solution(NET_SOLUTION **);
+void copy_solution(NET_SOLUTION *, const NET_SOLUTION *, int, int);
+void print_solution(const NET_SOLUTION *, int, int);
+void fprint_solution(FILE *, const NET_SOLUTION *, int, int);
+
+
+
+
+/** The NET_TOPOLOGY struct holds the data of a network problem as plain
+ ** arrays: the tail and head node of every arc (0-based), its lower and upper
+ ** bounds and the supply of every node. Infinite bounds are CPX_INFBOUND.
+ **/
+typedef struct net_topology_struct {
+	int narcs;
+	int nnodes;
+	int * tail;
+	int * head;
+	double * lb;
+	double * ub;
+	double * supply;
+} NET_TOPOLOGY;
+
+/*** Methods to handle the NET_TOPOLOGY struct ***/
+NET_TOPOLOGY * create_topology(int, int);
+void free_topology(NET_TOPOLOGY **);
+int read_network(CPXENVptr, const char *, NET_TOPOLOGY **, double **);
+int copy_topology_to_lp(CPXENVptr, CPXLPptr, const NET_TOPOLOGY *, const double *);
+int same_topology(const NET_TOPOLOGY *, const NET_TOPOLOGY *);
+int get_lp_network(CPXENVptr, CPXLPptr, NET_TOPOLOGY **, double **);
+
+
+
+
+/*************************
+ *** Utility Functions ***
+ *************************/
+void free_and_null(void **);
+double objective_value(double *, double *, int);
+int copy_cplex_problem(CPXENVptr, CPXNETptr, CPXLPptr, const char *);
+
+#endif
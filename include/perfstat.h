@@ -0,0 +1,83 @@
+#ifndef PERFSTAT_H
+#define PERFSTAT_H
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+#include <time.h>
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/*** Phases of one iteration of the bi-objective loop ***/
+#define PERF_PRICING  0
+#define PERF_PIVOT    1
+#define PERF_RETRIEVE 2
+#define PERF_UPDATE   3
+#define PERF_OUTPUT   4
+#define PERF_NPHASES  5
+
+/*** Hardware events sampled on every phase ***/
+#define PERF_CYCLES        0
+#define PERF_INSTRUCTIONS  1
+#define PERF_L1D_MISSES    2
+#define PERF_LLC_MISSES    3
+#define PERF_BRANCH_MISSES 4
+#define PERF_NEVENTS       5
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The PERF_PHASE struct accumulates the counts of every hardware event, the
+ ** wall-clock time and the number of times a phase was entered.
+ **/
+typedef struct perf_phase_struct {
+	unsigned long long counts[PERF_NEVENTS];
+	double seconds;
+	unsigned long calls;
+} PERF_PHASE;
+
+/** The PERF_STATS struct holds one group of Linux perf_event counters opened
+ ** for the calling thread and the totals of every phase. Events the kernel
+ ** refuses (in containers, virtual machines or with a restrictive
+ ** perf_event_paranoid setting) are left out and, if no event could be
+ ** opened, only the wall-clock time of each phase is kept.
+ **/
+typedef struct perf_stats_struct {
+	int fds[PERF_NEVENTS];
+	int slot[PERF_NEVENTS];
+	int nopen;
+	int leader;
+	int open_errno;
+
+	unsigned long long start[PERF_NEVENTS];
+	unsigned long long start_enabled;
+	unsigned long long start_running;
+	struct timespec start_time;
+	int current;
+
+	PERF_PHASE phases[PERF_NPHASES];
+} PERF_STATS;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+PERF_STATS * create_perf_stats(void);
+void free_perf_stats(PERF_STATS **);
+void perf_begin(PERF_STATS *, int);
+void perf_end(PERF_STATS *);
+void perf_report(FILE *, const PERF_STATS *);
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef PERTURBATION_H
+#define PERTURBATION_H
+
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Weight given to objective function 1 when blending both cost vectors to
+ ** find the initial extreme non-dominated solution:
+ **		Z(x) = w*z1(x) + (1 - w)*z2(x)
+ **/
+#define PERTURBATION_WEIGHT 0.999
+
+/*** Engines for the single-objective anchor solves ***/
+#define ANCHOR_SIMPLEX 0	/* primal simplex */
+#define ANCHOR_SCALING 1	/* cost scaling flow, basis finished by primal simplex */
+#define ANCHOR_DUAL    2	/* dual simplex */
+#define ANCHOR_NETWORK 3	/* network simplex on the arcs, finished by primal simplex */
+#define ANCHOR_BARRIER 4	/* barrier with crossover to a basis */
+#define ANCHOR_PORTFOLIO 5	/* race of configurations, see portfolio.h */
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The ANCHOR_STATS struct reports how an anchor solve went: the time taken
+ ** to build the starting basis (zero for ANCHOR_SIMPLEX), the time and the
+ ** iterations of the primal simplex run, and whether the basis from the cost
+ ** scaling engine was actually used. With ANCHOR_PORTFOLIO, config names the
+ ** configuration that solved it.
+ **/
+typedef struct anchor_stats_struct {
+	double seed_time;
+	double simplex_time;
+	int iterations;
+	int seeded;
+	const char * config;
+} ANCHOR_STATS;
+
+/** The PORTFOLIO_SETTINGS struct tells the ANCHOR_PORTFOLIO engine how many
+ ** configurations to race at once and which file, if any, keeps the winner
+ ** of every instance class. Each solver context has its own, and without
+ ** any the first configuration solves the problem alone.
+ **/
+typedef struct portfolio_settings_struct {
+	const char * database;
+	int threads;
+} PORTFOLIO_SETTINGS;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+NET_SOLUTION * get_initial_objective(const char *, int, const PORTFOLIO_SETTINGS *, ANCHOR_STATS *);
+NET_SOLUTION * get_objective_solution(CPXENVptr, CPXLPptr, int, const PORTFOLIO_SETTINGS *, const NET_BASIS *,
+                                      ANCHOR_STATS *);
+NET_SOLUTION * get_perturbation_solution(CPXENVptr, CPXENVptr, CPXLPptr, CPXLPptr, double, int,
+                                         const PORTFOLIO_SETTINGS *, const NET_BASIS *, ANCHOR_STATS *);
+NET_SOLUTION * get_weighted_solution(CPXENVptr, CPXLPptr, int, double * const *, const double *, int,
+                                     const PORTFOLIO_SETTINGS *, const NET_BASIS *, ANCHOR_STATS *);
+int solve_anchor(CPXENVptr, CPXLPptr, int, const PORTFOLIO_SETTINGS *, const NET_BASIS *, NET_SOLUTION *,
+                 ANCHOR_STATS *);
+const char * anchor_engine_name(int);
+int anchor_engine(const char *);
+
+#endif
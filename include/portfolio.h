@@ -0,0 +1,52 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "perturbation.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Longest line of a portfolio database, "CLASS CONFIG" **/
+#define PORTFOLIO_LINE 128
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The PORTFOLIO_CONFIG struct is one way of solving an anchor problem: an
+ ** ANCHOR_* engine and, when param is not zero, the value of one CPLEX
+ ** integer parameter (the pricing rule of the simplex engines).
+ **/
+typedef struct portfolio_config_struct {
+	const char * name;
+	int engine;
+	int param;
+	int value;
+} PORTFOLIO_CONFIG;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+int portfolio_solve(CPXENVptr, CPXLPptr, const PORTFOLIO_SETTINGS *, NET_SOLUTION *, ANCHOR_STATS *);
+int portfolio_class(CPXENVptr, CPXLPptr, char *, size_t);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/*** How the flow of an arc slot is obtained when expanding a solution ***/
+#define REDUCE_KEPT   0	/* the slot is an arc of the reduced network */
+#define REDUCE_SERIES 1	/* the slot carries the flow of its parent slot */
+#define REDUCE_FIXED  2	/* the slot carries a fixed flow */
+#define REDUCE_MEMBER 3	/* the slot gets a share of the flow of its parent */
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The NET_REDUCTION struct holds a reduced network equivalent to the
+ ** original one for both objectives and the information needed to map a flow
+ ** of the reduced network back to the original arcs.
+ **
+ ** Every original arc is a slot and each reduction rule creates a new slot
+ ** from the slots it replaces, so a parent slot always has a larger index than
+ ** its children:
+ **	- a series chain u->v->w through a transit node v becomes one arc u->w,
+ **	  both children carry the flow of the new arc;
+ **	- parallel arcs with equal costs in both objectives become one arc with
+ **	  the summed bounds, whose flow is shared by the members in order;
+ **	- a parallel arc dominated in both objectives by an uncapacitated arc,
+ **	  and every arc with equal bounds, is fixed at its lower bound.
+ **
+ ** offset1 and offset2 are the cost of the fixed flows in each objective,
+ ** which must be added to the objective values of the reduced network.
+ **/
+typedef struct net_reduction_struct {
+	int orig_narcs;
+	int orig_nnodes;
+
+	int nslots;
+	int * kind;
+	int * parent;
+	int * reduced;
+	int * first_member;
+	int * next_member;
+	double * value;
+	double * member_lb;
+	double * member_ub;
+
+	int * node_map;
+
+	NET_TOPOLOGY * topo;
+	double * costs1;
+	double * costs2;
+	double offset1;
+	double offset2;
+
+	int nseries;
+	int nparallel;
+	int ndominated;
+	int nfixed;
+} NET_REDUCTION;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+NET_REDUCTION * reduce_network(const NET_TOPOLOGY *, const double *, const double *);
+void free_reduction(NET_REDUCTION **);
+void expand_flow(const NET_REDUCTION *, const double *, double *, double *);
+void print_reduction(FILE *, const NET_REDUCTION *);
+
+#endif
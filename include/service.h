@@ -0,0 +1,31 @@
+#ifndef SERVICE_H
+#define SERVICE_H
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "solver.h"
+#include "frontier.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Longest request line accepted by the service **/
+#define SERVICE_LINE 256
+
+/** Pending connections queued by the listening socket **/
+#define SERVICE_BACKLOG 4
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+int run_service(SOLVER_CTX *, const char *);
+
+#endif
@@ -0,0 +1,257 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <signal.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "perfstat.h"
+#include "reduce.h"
+#include "perturbation.h"
+#include "basistree.h"
+#include "trace.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Direction of the walk along the frontier. The forward walk starts near the
+ ** objective 1 minimum and pivots on objective 2 until its minimum is reached.
+ ** The backward walk mirrors it, starting near the objective 2 minimum and
+ ** pivoting on objective 1.
+ **/
+#define SOLVER_FORWARD  0
+#define SOLVER_BACKWARD 1
+
+/** Relative gaps of the approximation mode are measured against the larger
+ ** of |z| and APPROX_FLOOR, so objective values near zero use absolute gaps.
+ **/
+#define APPROX_FLOOR 1.0
+
+/** Pivots after the last recorded point before the approximation mode stops
+ ** walking a flat stretch of the frontier and jumps by a weighted-sum solve.
+ **/
+#define APPROX_FLAT_PIVOTS 16
+
+/** A jump must improve the pivoted objective by more than APPROX_TOL **/
+#define APPROX_TOL 1e-9
+
+/*** Reasons for a walk to stop before reaching its anchor ***/
+#define SOLVER_STOP_NONE     0
+#define SOLVER_STOP_CALLBACK 1	/* the callback asked for it */
+#define SOLVER_STOP_BUDGET   2	/* the time or iteration budget ran out */
+#define SOLVER_STOP_SIGNAL   3	/* solver_interrupt() was called */
+
+/** Pivots the anytime mode walks between two jumps, however late it is **/
+#define ANYTIME_PIVOTS 16
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The SOLVER_ITERATION struct is handed to the iteration callback every time
+ ** a new basis of the bi-objective problem is reached. Iteration 0 is the
+ ** basis found by the perturbation method and the arc field is -1 in that case.
+ ** The solution objects belong to the solver context and are only valid until
+ ** the callback returns.
+ **/
+typedef struct solver_iteration_struct {
+	int iteration;
+	int arc;
+	double elapsed;
+	const NET_SOLUTION * solution1;
+	const NET_SOLUTION * solution2;
+} SOLVER_ITERATION;
+
+/** Iteration callback. A non-zero return value stops solver_run() after the
+ ** current iteration without flagging an error.
+ **/
+typedef int (*SOLVER_CALLBACK)(const SOLVER_ITERATION *, void *);
+
+
+/** The APPROX_STATE struct follows the approximation mode along the walk.
+ ** Objective values are kept as the pivoted one (p, decreasing along the
+ ** walk) and the secondary one (s, increasing). eps is the tolerance in use
+ ** and factor the approximation factor guaranteed so far: every point of the
+ ** frontier is within 1 + factor of a recorded point in both objectives.
+ **/
+typedef struct approx_state_struct {
+	double eps;
+	double last_p;
+	double last_s;
+	double anchor_s;
+	double factor;
+	int since;
+	int recorded;
+	int skipped;
+	int jumps;
+} APPROX_STATE;
+
+
+/** The SOLVER_GAP struct is a stretch of the frontier the anytime mode
+ ** jumped over or didn't reach, from the point (start1, start2) to the point
+ ** (end1, end2). Every frontier point of the stretch lies in the box they
+ ** span. basis is the packed basis of the start point, from which the
+ ** stretch is walked if the budget allows, until the pivoted objective
+ ** reaches target, and end_basis the one of the end point.
+ **/
+typedef struct solver_gap_struct {
+	double start1;
+	double start2;
+	double end1;
+	double end2;
+	double target;
+	unsigned char * basis;
+	unsigned char * end_basis;
+} SOLVER_GAP;
+
+
+/** The SOLVER_CTX struct holds every piece of state used to compute the set of
+ ** extreme non-dominated solutions of one bi-objective network problem: the
+ ** CPLEX environments and LP objects of both objective functions, the current
+ ** solutions, the anchor solutions and the scratch buffers of the pivot loop.
+ ** After solver_reset() the bases of the last anchor solutions are kept as
+ ** warm starts for the next run, which re-optimizes with primal simplex if
+ ** costs changed since then and with dual simplex if only supplies or bounds
+ ** did.
+ ** With a time or iteration budget the walk runs in anytime mode: when it
+ ** falls behind the pace that reaches the anchor within the budget, it jumps
+ ** ahead by a weighted-sum solve and keeps the stretch it skipped as a gap,
+ ** walked once the anchor is reached. Whatever is left when the budget runs
+ ** out stays in gaps, as it does when solver_interrupt() sets interrupted,
+ ** which solver_reset() clears.
+ ** Nothing is shared between two contexts so independent contexts may be
+ ** driven concurrently from different threads.
+ **/
+typedef struct solver_ctx_struct {
+	CPXENVptr env1;
+	CPXENVptr env2;
+	CPXLPptr lp1;
+	CPXLPptr lp2;
+
+	char * net_file1;
+	char * net_file2;
+	int narcs;
+	int nnodes;
+
+	NET_SOLUTION * solution1;
+	NET_SOLUTION * solution2;
+	NET_SOLUTION * perturbsol;
+	NET_SOLUTION * initial_sol1;
+	NET_SOLUTION * initial_sol2;
+
+	double * ratios;
+
+	int direction;
+	int iteration;
+	int pivots;
+	int flips;
+	int finished;
+
+	SOLVER_CALLBACK callback;
+	void * cbdata;
+
+	PERF_STATS * perf;
+
+	int reduce;
+	NET_REDUCTION * reduction;
+	int load_threads;
+
+	int initial_engine;
+	int perturb_engine;
+	PORTFOLIO_SETTINGS portfolio;
+	ANCHOR_STATS initial_stats;
+	ANCHOR_STATS perturb_stats;
+
+	int tree_kind;
+	BASIS_TREE * tree;
+
+	int changed_costs;
+	int changed_bounds;
+	int supply_sign;
+	NET_BASIS * warm_anchor;
+	NET_BASIS * warm_perturb;
+
+	double approx_eps;
+	int approx_points;
+	APPROX_STATE approx;
+
+	TRACE * trace;
+	NET_BASIS * trace_basis;
+
+	double time_budget;
+	double deadline;
+	int iteration_budget;
+	double walk_start;
+	double start_p;
+	int last_jump;
+	int stop;
+	SOLVER_GAP * gaps;
+	int ngaps;
+	int cgaps;
+	int gap;
+	int gaps_walked;
+	volatile sig_atomic_t interrupted;
+} SOLVER_CTX;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+SOLVER_CTX * solver_create(void);
+void solver_free(SOLVER_CTX **);
+void solver_set_callback(SOLVER_CTX *, SOLVER_CALLBACK, void *);
+void solver_set_direction(SOLVER_CTX *, int);
+void solver_set_perf(SOLVER_CTX *, PERF_STATS *);
+void solver_set_reduce(SOLVER_CTX *, int);
+void solver_set_loader(SOLVER_CTX *, int);
+void solver_set_engines(SOLVER_CTX *, int, int);
+void solver_set_portfolio(SOLVER_CTX *, const char *, int);
+void solver_set_basis_tree(SOLVER_CTX *, int);
+void solver_set_approximation(SOLVER_CTX *, double, int);
+void solver_approx_report(FILE *, const SOLVER_CTX *);
+void solver_pivot_report(FILE *, const SOLVER_CTX *);
+void solver_set_trace(SOLVER_CTX *, TRACE *);
+void solver_set_budget(SOLVER_CTX *, double, int);
+void solver_interrupt(SOLVER_CTX *);
+void solver_anytime_report(FILE *, const SOLVER_CTX *);
+
+int solver_load(SOLVER_CTX *, const char *, const char *);
+SOLVER_CTX * solver_clone(SOLVER_CTX *);
+int solver_initial_solve(SOLVER_CTX *);
+int solver_perturbation(SOLVER_CTX *);
+int solver_resume(SOLVER_CTX *, const NET_BASIS *);
+int solver_step(SOLVER_CTX *);
+int solver_pivot(SOLVER_CTX *, int, TRACE_RECORD *);
+int solver_replay(SOLVER_CTX *, TRACE *, FILE *);
+int solver_run(SOLVER_CTX *);
+int solver_finished(const SOLVER_CTX *);
+int solver_benchmark_anchors(SOLVER_CTX *, FILE *);
+int solver_reset(SOLVER_CTX *);
+int solver_set_warm_start(SOLVER_CTX *, const NET_BASIS *, const NET_BASIS *);
+int solver_change_costs(SOLVER_CTX *, int, int, const int *, const double *);
+int solver_change_supplies(SOLVER_CTX *, int, const int *, const double *);
+int solver_change_bounds(SOLVER_CTX *, int, const int *, const char *, const double *);
+
+int update_solution(CPXENVptr, CPXLPptr, const NET_BASIS *, NET_SOLUTION *);
+int entering_arc(double *, double *, int *, double *, int);
+
+#endif
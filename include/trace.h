@@ -0,0 +1,95 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+#include <stdint.h>
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** First bytes of a trace file, "PTRC" in little-endian order **/
+#define TRACE_MAGIC   0x43525450u
+#define TRACE_VERSION 1
+
+/*** Phases of an iteration timed in a trace record ***/
+#define TRACE_PRICING  0
+#define TRACE_PIVOT    1
+#define TRACE_RETRIEVE 2
+#define TRACE_UPDATE   3
+#define TRACE_NPHASES  4
+
+/*** Leaving variable codes other than an arc index ***/
+#define TRACE_NO_LEAVING -1	/* the entering arc moved to its other bound */
+#define TRACE_ROW(i)     (-2 - (i))	/* the slack of row i left the basis */
+
+/** Objective values of two traces closer than TRACE_TOL (relative) are taken
+ ** as equal when the traces are compared.
+ **/
+#define TRACE_TOL 1e-9
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The TRACE_HEADER struct starts every trace file. **/
+typedef struct trace_header_struct {
+	uint32_t magic;
+	uint32_t version;
+	int32_t narcs;
+	int32_t nnodes;
+	int32_t direction;
+	int32_t reserved;
+} TRACE_HEADER;
+
+/** The TRACE_RECORD struct is written for every pivot of the walk: the arc
+ ** entering the basis, the variable leaving it, the change of flow on the
+ ** entering arc, the objective pair reached and the time spent in every
+ ** phase of the iteration, in microseconds. Records are fixed-size and
+ ** written in the byte order of the machine.
+ **/
+typedef struct trace_record_struct {
+	int32_t iteration;
+	int32_t entering;
+	int32_t leaving;
+	int32_t reserved;
+	double step;
+	double obj1;
+	double obj2;
+	float usec[TRACE_NPHASES];
+} TRACE_RECORD;
+
+/** The TRACE struct is an open trace file, either being written by a walk or
+ ** read back for a replay or a comparison.
+ **/
+typedef struct trace_struct {
+	FILE * fp;
+	int writing;
+	TRACE_HEADER header;
+	long records;
+} TRACE;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+TRACE * open_trace_writer(const char *, int, int, int);
+TRACE * open_trace_reader(const char *);
+int close_trace(TRACE **);
+int trace_write(TRACE *, const TRACE_RECORD *);
+int trace_read(TRACE *, TRACE_RECORD *);
+int trace_diff(const char *, const char *, FILE *);
+double trace_clock(void);
+
+#endif
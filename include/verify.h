@@ -0,0 +1,145 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+#include <pthread.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+#include "frontier.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Relative tolerance of every check, scaled by 1 + |value| **/
+#define VERIFY_TOL 1e-6
+
+/*** Checks made on every point, as bits of its failure mask ***/
+#define VERIFY_FLOW      0x01	/* flow conservation at every node */
+#define VERIFY_BOUNDS    0x02	/* arc bounds and nonbasic arcs at a bound */
+#define VERIFY_OBJECTIVE 0x04	/* objective values recomputed from the flow */
+#define VERIFY_DUALS     0x08	/* zero reduced costs on basic arcs */
+#define VERIFY_WEIGHTS   0x10	/* optimal over the weights claimed for the point */
+#define VERIFY_ORDER     0x20	/* monotone objectives along the walk */
+
+/** Most threads checking points while the walk runs. Each of them needs two
+ ** slots, each slot a full certificate, so this bounds the memory taken. **/
+#define VERIFY_MAX_THREADS 4
+
+/*** States of a slot ***/
+#define VERIFY_SLOT_FREE     0
+#define VERIFY_SLOT_FILLING  1	/* the walk copies a certificate into it */
+#define VERIFY_SLOT_READY    2	/* waiting for a checker */
+#define VERIFY_SLOT_CHECKING 3
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The VERIFY_POINT struct is what is kept of one reported point once its
+ ** certificate is checked: its objective pair, the interval [lo, hi] of
+ ** weights w for which its basis is optimal for w*z1 + (1 - w)*z2, computed
+ ** from the reduced costs, and [claim_lo, claim_hi], the one the frontier
+ ** claims for the point.
+ **/
+typedef struct verify_point_struct {
+	int iteration;
+	double obj1;
+	double obj2;
+
+	double lo;
+	double hi;
+	double claim_lo;
+	double claim_hi;
+	int failures;
+	double violation;
+} VERIFY_POINT;
+
+/** The VERIFY_SLOT struct holds the certificate of a point until a checker
+ ** is done with it: its flow, the node potentials of both objectives and the
+ ** status of every arc. point is the index of the point it belongs to.
+ **/
+typedef struct verify_slot_struct {
+	double * x;
+	double * pi1;
+	double * pi2;
+	char * status;
+	int point;
+	int state;
+} VERIFY_SLOT;
+
+/** The VERIFY_CHECKER struct is one checking thread and its scratch memory **/
+typedef struct verify_checker_struct {
+	struct verifier_struct * verifier;
+	double * residual;
+	pthread_t thread;
+	int started;
+} VERIFY_CHECKER;
+
+/** The VERIFIER struct checks the certificates of the points reported by a
+ ** walk. verify_record() copies each one to a free slot, waiting for one if
+ ** needed, and hands the iteration on to the next callback, while the
+ ** checkers check the slots as they fill, so only the points and a few
+ ** certificates are kept. If no checker could start, the walk checks every
+ ** point itself. The network is read back from the LP objects once.
+ ** The claimed weight intervals are only checked if the walk reported every
+ ** breakpoint (exact), since the approximation mode skips some of them.
+ ** The anytime mode may skip some too, and walks the stretches it jumped
+ ** over later, so its points are put back in walk order before the checks.
+ **/
+typedef struct verifier_struct {
+	NET_TOPOLOGY * topo;
+	double * costs1;
+	double * costs2;
+	double offset1;
+	double offset2;
+	double wmin;
+	double wmax;
+	int direction;
+	int exact;
+	int anytime;
+	int dropped;
+
+	VERIFY_POINT * points;
+	int npoints;
+	int capacity;
+
+	VERIFY_SLOT * slots;
+	int nslots;
+	VERIFY_CHECKER * checkers;
+	int ncheckers;
+	int nstarted;
+	int closing;
+	pthread_mutex_t lock;
+	pthread_cond_t filled;
+	pthread_cond_t freed;
+
+	SOLVER_CALLBACK next;
+	void * next_data;
+} VERIFIER;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+VERIFIER * create_verifier(const SOLVER_CTX *, int, SOLVER_CALLBACK, void *);
+void free_verifier(VERIFIER **);
+int verify_record(const SOLVER_ITERATION *, void *);
+int verify_frontier(VERIFIER *, FILE *);
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef WEIGHTSPACE_H
+#define WEIGHTSPACE_H
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "perturbation.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Most objective functions handled by the weight-space decomposition **/
+#define WS_MAX_OBJECTIVES 16
+
+/** Smallest weight given to any objective function, so every weighted-sum
+ ** solution is non-dominated. It plays the part of 1 - PERTURBATION_WEIGHT
+ ** in the bi-objective walk.
+ **/
+#define WS_FLOOR 0.001
+
+/** A weighted-sum value has to beat the envelope by more than WS_TOL
+ ** (relative) to give a new extreme point.
+ **/
+#define WS_TOL 1e-7
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The WS_POINT struct is an extreme supported point: its objective vector,
+ ** the weights of the solve that found it and the optimal basis of that
+ ** solve, which warm starts the solves of the neighbouring cells. facets is
+ ** the number of envelope vertices lying on the cell of the point.
+ **/
+typedef struct ws_point_struct {
+	double values[WS_MAX_OBJECTIVES];
+	double weights[WS_MAX_OBJECTIVES];
+	NET_BASIS * basis;
+	int facets;
+} WS_POINT;
+
+/** The WS_VERTEX struct is a vertex of the lower envelope of the weighted
+ ** sums over the weight simplex. u holds the first K-1 weights followed by
+ ** the envelope value at them; the last weight is 1 minus the others. tight
+ ** lists the constraints met with equality: 0..K-1 are the floors of the
+ ** weights and K+p the cut of point p. A vertex is confirmed once a solve at
+ ** its weights found nothing below the envelope.
+ **/
+typedef struct ws_vertex_struct {
+	double u[WS_MAX_OBJECTIVES];
+	int * tight;
+	int ntight;
+	long id;
+	int confirmed;
+} WS_VERTEX;
+
+/** The WEIGHT_SPACE struct holds the K objective functions of a network,
+ ** the extreme points found so far and the vertices of their envelope, from
+ ** which the weights of the next solves are taken.
+ **/
+typedef struct weight_space_struct {
+	int nobjs;
+	int narcs;
+	int nnodes;
+	NET_TOPOLOGY * topo;
+	double * costs[WS_MAX_OBJECTIVES];
+
+	WS_POINT * points;
+	int npoints;
+	int cpoints;
+
+	WS_VERTEX * vertices;
+	int nvertices;
+	int cvertices;
+	long next_id;
+
+	int engine;
+	PORTFOLIO_SETTINGS portfolio;
+	int nthreads;
+
+	/*** statistics ***/
+	int rounds;
+	int degenerate;
+	long solves;
+	long warm_solves;
+	long iterations;
+	double elapsed;
+} WEIGHT_SPACE;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+WEIGHT_SPACE * create_weight_space(int, char **, int, int, const PORTFOLIO_SETTINGS *);
+void free_weight_space(WEIGHT_SPACE **);
+int weight_space_solve(WEIGHT_SPACE *);
+void fprint_weight_space(FILE *, const WEIGHT_SPACE *);
+void weight_space_report(FILE *, const WEIGHT_SPACE *);
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef WRITER_H
+#define WRITER_H
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+#include "reduce.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Default number of slots of the ring buffer. Each slot holds a full copy of
+ ** both solutions so the value is kept small. It must be a power of two.
+ **/
+#define WRITER_DEFAULT_SLOTS 16
+
+/** Length of the text carried by a WRITER_TEXT record **/
+#define WRITER_TEXT_SIZE 256
+
+/*** Kinds of records ***/
+#define WRITER_ITERATION 0
+#define WRITER_TEXT      1
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The WRITER_RECORD struct is one slot of the ring buffer. The solution
+ ** objects are alloc'd once when the writer is created and the producer only
+ ** copies the current solutions into them.
+ **/
+typedef struct writer_record_struct {
+	int kind;
+	int iteration;
+	int arc;
+	double elapsed;
+	NET_SOLUTION * solution1;
+	NET_SOLUTION * solution2;
+	char text[WRITER_TEXT_SIZE];
+} WRITER_RECORD;
+
+/** The WRITER struct is a bounded single-producer/single-consumer ring buffer
+ ** of records drained by a dedicated I/O thread. The producer (the pivot
+ ** thread) owns head and the I/O thread owns tail, so no lock is taken on
+ ** either side. When the buffer is full the producer waits for a free slot,
+ ** which is the only point where the pivot loop can be held back by output.
+ **/
+typedef struct writer_struct {
+	WRITER_RECORD * slots;
+	unsigned long capacity;
+	atomic_ulong head;
+	atomic_ulong tail;
+	atomic_int closing;
+
+	FILE * out;
+	int owns_out;
+	int narcs;
+	int nnodes;
+
+	const NET_REDUCTION * reduction;
+	double * slot_flow;
+	double * orig_flow;
+
+	unsigned long stalls;
+	pthread_t thread;
+	int running;
+} WRITER;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+WRITER * create_writer(const char *, int, int, unsigned long);
+int close_writer(WRITER **);
+int writer_iteration(const SOLVER_ITERATION *, void *);
+int writer_text(WRITER *, const char *, ...);
+int writer_set_reduction(WRITER *, const NET_REDUCTION *);
+
+#endif
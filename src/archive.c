@@ -0,0 +1,246 @@
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+#include "archive.h"
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: create_archive
+ ** Creates an empty archive for bases of a network of the given size. Every
+ ** iteration reported to archive_record() is handed on to next with
+ ** next_data. Returns NULL on error.
+ **/
+BASIS_ARCHIVE * create_archive(int narcs, int nnodes, SOLVER_CALLBACK next, void * next_data)
+{
+	BASIS_ARCHIVE * archive = calloc(1, sizeof(BASIS_ARCHIVE));
+	if(!archive) {
+		fprintf(stderr, "Unable to alloc basis archive.\n");
+		return NULL;
+	}
+
+	archive->narcs = narcs;
+	archive->nnodes = nnodes;
+	archive->size = packed_basis_size(narcs, nnodes);
+	archive->next = next;
+	archive->next_data = next_data;
+
+	return archive;
+}
+
+
+/** Function: free_archive
+ ** Frees the archive and sets the pointer to NULL.
+ **/
+void free_archive(BASIS_ARCHIVE ** archive_p)
+{
+	if(!archive_p || !*archive_p) {
+		return;
+	}
+
+	free((*archive_p)->entries);
+	free((*archive_p)->bases);
+	free(*archive_p);
+	*archive_p = NULL;
+}
+
+
+/** Function: archive_record
+ ** Iteration callback that packs the basis of the reported point, with its
+ ** objective pair, and hands the iteration on to the next callback. A point
+ ** that can't be kept is counted as dropped rather than stopping the walk.
+ **/
+int archive_record(const SOLVER_ITERATION * it, void * data)
+{
+	BASIS_ARCHIVE * archive = data;
+	ARCHIVE_ENTRY * entry;
+
+	if(archive->count == archive->capacity) {
+		int capacity = archive->capacity ? 2 * archive->capacity : 64;
+		ARCHIVE_ENTRY * entries = realloc(archive->entries, capacity * sizeof(ARCHIVE_ENTRY));
+		unsigned char * bases = entries ? realloc(archive->bases, capacity * archive->size) : NULL;
+
+		if(entries) {
+			archive->entries = entries;
+		}
+		if(!bases) {
+			archive->dropped++;
+			goto NEXT;
+		}
+		archive->bases = bases;
+		archive->capacity = capacity;
+	}
+
+	entry = &archive->entries[archive->count];
+	entry->iteration = it->iteration;
+	entry->reserved = 0;
+	entry->obj1 = it->solution1->objval;
+	entry->obj2 = it->solution2->objval;
+	pack_basis(archive->bases + archive->count * archive->size, it->solution1->basis,
+	           archive->narcs, archive->nnodes);
+	archive->count++;
+
+NEXT:
+
+	return archive->next ? archive->next(it, archive->next_data) : 0;
+}
+
+
+/** Function: write_archive
+ ** Writes the archive to the file at path: the header, the entries and the
+ ** packed bases, in the byte order of the machine.
+ **/
+int write_archive(const BASIS_ARCHIVE * archive, const char * path)
+{
+	ARCHIVE_HEADER header;
+	FILE * out;
+	int status = 0;
+
+	out = fopen(path, "wb");
+	if(!out) {
+		fprintf(stderr, "Unable to create archive file %s.\n", path);
+		return -1;
+	}
+
+	memset(&header, 0, sizeof(ARCHIVE_HEADER));
+	header.magic = ARCHIVE_MAGIC;
+	header.version = ARCHIVE_VERSION;
+	header.narcs = archive->narcs;
+	header.nnodes = archive->nnodes;
+	header.count = archive->count;
+
+	if(fwrite(&header, sizeof(ARCHIVE_HEADER), 1, out) != 1 ||
+	   (archive->count &&
+	    (fwrite(archive->entries, sizeof(ARCHIVE_ENTRY), archive->count, out) != (size_t) archive->count ||
+	     fwrite(archive->bases, archive->size, archive->count, out) != (size_t) archive->count))) {
+		fprintf(stderr, "Unable to write archive file %s.\n", path);
+		status = -1;
+	}
+
+	if(fclose(out)) {
+		fprintf(stderr, "Unable to close archive file %s.\n", path);
+		status = -1;
+	}
+
+	return status;
+}
+
+
+/** Function: read_archived_basis
+ ** Reads the basis of point k of the archive file at path, which must have
+ ** been written for a network with narcs arcs and nnodes nodes, into a new
+ ** NET_BASIS object. A negative k counts from the last point. Only that
+ ** basis is read from the file. If entry is not NULL it receives the entry
+ ** of the point. Returns NULL on error.
+ **/
+NET_BASIS * read_archived_basis(const char * path, int k, int narcs, int nnodes, ARCHIVE_ENTRY * entry)
+{
+	ARCHIVE_HEADER header;
+	ARCHIVE_ENTRY local;
+	NET_BASIS * basis = NULL;
+	unsigned char * packed = NULL;
+	size_t size = packed_basis_size(narcs, nnodes);
+	FILE * in;
+	long offset;
+
+	in = fopen(path, "rb");
+	if(!in) {
+		fprintf(stderr, "Unable to open archive file %s.\n", path);
+		return NULL;
+	}
+
+	if(fread(&header, sizeof(ARCHIVE_HEADER), 1, in) != 1 ||
+	   header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION) {
+		fprintf(stderr, "%s is not a basis archive.\n", path);
+		goto TERMINATE;
+	}
+
+	if(header.narcs != narcs || header.nnodes != nnodes) {
+		fprintf(stderr, "Archive %s holds bases of a network with %d arcs and %d nodes.\n",
+		        path, header.narcs, header.nnodes);
+		goto TERMINATE;
+	}
+
+	if(k < 0) {
+		k += header.count;
+	}
+	if(k < 0 || k >= header.count) {
+		fprintf(stderr, "Archive %s holds %d points.\n", path, header.count);
+		goto TERMINATE;
+	}
+
+	offset = (long) sizeof(ARCHIVE_HEADER) + (long) k * sizeof(ARCHIVE_ENTRY);
+	if(fseek(in, offset, SEEK_SET) || fread(&local, sizeof(ARCHIVE_ENTRY), 1, in) != 1) {
+		fprintf(stderr, "Unable to read point %d of archive %s.\n", k, path);
+		goto TERMINATE;
+	}
+
+	packed = malloc(size);
+	basis = create_basis(narcs, nnodes);
+	if(!packed || !basis) {
+		fprintf(stderr, "Unable to alloc archived basis.\n");
+		free_basis(&basis);
+		goto TERMINATE;
+	}
+
+	offset = (long) sizeof(ARCHIVE_HEADER) + (long) header.count * sizeof(ARCHIVE_ENTRY) + (long) (k * size);
+	if(fseek(in, offset, SEEK_SET) || fread(packed, size, 1, in) != 1) {
+		fprintf(stderr, "Unable to read basis %d of archive %s.\n", k, path);
+		free_basis(&basis);
+		goto TERMINATE;
+	}
+
+	unpack_basis(basis, packed, narcs, nnodes);
+	if(entry) {
+		*entry = local;
+	}
+
+
+TERMINATE:
+
+	free(packed);
+	fclose(in);
+
+	return basis;
+}
+
+
+/** Function: parse_archive_point
+ ** Splits an option of the form FILE or FILE:K into a new copy of the file
+ ** name and the point index, -1 (the last point) if none is given. Returns
+ ** a non-zero value if K is not an integer.
+ **/
+int parse_archive_point(const char * arg, char ** path_p, int * k_p)
+{
+	const char * colon = strrchr(arg, ':');
+	char * end;
+	size_t length = colon ? (size_t) (colon - arg) : strlen(arg);
+
+	*k_p = -1;
+	if(colon) {
+		*k_p = (int) strtol(colon + 1, &end, 10);
+		if(end == colon + 1 || *end) {
+			return -1;
+		}
+	}
+
+	*path_p = malloc(length + 1);
+	if(!*path_p) {
+		return -1;
+	}
+	memcpy(*path_p, arg, length);
+	(*path_p)[length] = '\0';
+
+	return 0;
+}
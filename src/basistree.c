@@ -0,0 +1,552 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "basistree.h"
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int build_tree(BASIS_TREE *);
+static int pivot_array(BASIS_TREE *, int, int, int *, int *, int *);
+static void shift_potentials(BASIS_TREE *, int, int, double);
+static int walk_up(const BASIS_TREE *, int, int, int *);
+static void detach_child(BASIS_TREE *, int);
+static void attach_child(BASIS_TREE *, int, int, int);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: create_basis_tree
+ ** Creates an empty basis tree for the network held by the LP object, with
+ ** the costs of that LP. Returns NULL if the LP is not a network or if any
+ ** allocation fails.
+ **/
+BASIS_TREE * create_basis_tree(CPXENVptr env, CPXLPptr lp)
+{
+	BASIS_TREE * tree = NULL;
+	NET_TOPOLOGY * topo = NULL;
+	double * costs = NULL;
+	int narcs, nnodes, i, a;
+
+	if(get_lp_network(env, lp, &topo, &costs)) {
+		fprintf(stderr, "Basis tree: the LP object is not a network.\n");
+		return NULL;
+	}
+
+	narcs = topo->narcs;
+	nnodes = topo->nnodes;
+
+	tree = calloc(1, sizeof(BASIS_TREE));
+	if(!tree) {
+		fprintf(stderr, "Unable to alloc basis tree.\n");
+		free_topology(&topo);
+		free(costs);
+		return NULL;
+	}
+
+	tree->narcs = narcs;
+	tree->nnodes = nnodes;
+	tree->costs = costs;
+
+	tree->tail = malloc(narcs * sizeof(int));
+	tree->head = malloc(narcs * sizeof(int));
+	tree->adj_first = calloc(nnodes + 1, sizeof(int));
+	tree->adj_arc = malloc(2 * narcs * sizeof(int));
+	tree->arc_basis = malloc(narcs * sizeof(int));
+	tree->node_basis = malloc(nnodes * sizeof(int));
+	tree->pi = malloc(nnodes * sizeof(double));
+	tree->dj = malloc(narcs * sizeof(double));
+	tree->parent = malloc(nnodes * sizeof(int));
+	tree->parent_arc = malloc(nnodes * sizeof(int));
+	tree->first_child = malloc(nnodes * sizeof(int));
+	tree->next_sibling = malloc(nnodes * sizeof(int));
+	tree->prev_sibling = malloc(nnodes * sizeof(int));
+	tree->moved = malloc(nnodes * sizeof(int));
+	tree->stack = malloc(nnodes * sizeof(int));
+	tree->mark = calloc(nnodes, sizeof(char));
+
+	if(!tree->tail || !tree->head || !tree->adj_first || !tree->adj_arc || !tree->arc_basis ||
+	   !tree->node_basis || !tree->pi || !tree->dj || !tree->parent || !tree->parent_arc ||
+	   !tree->first_child || !tree->next_sibling || !tree->prev_sibling ||
+	   !tree->moved || !tree->stack || !tree->mark) {
+		fprintf(stderr, "Unable to alloc basis tree.\n");
+		free_topology(&topo);
+		free_basis_tree(&tree);
+		return NULL;
+	}
+
+	memcpy(tree->tail, topo->tail, narcs * sizeof(int));
+	memcpy(tree->head, topo->head, narcs * sizeof(int));
+	free_topology(&topo);
+
+	/* incidence lists, used to fix the reduced costs around a moved subtree */
+	for(a = 0; a < narcs; a++) {
+		tree->adj_first[tree->tail[a] + 1]++;
+		tree->adj_first[tree->head[a] + 1]++;
+	}
+	for(i = 0; i < nnodes; i++) {
+		tree->adj_first[i + 1] += tree->adj_first[i];
+		tree->moved[i] = tree->adj_first[i];
+	}
+	for(a = 0; a < narcs; a++) {
+		tree->adj_arc[tree->moved[tree->tail[a]]++] = a;
+		tree->adj_arc[tree->moved[tree->head[a]]++] = a;
+	}
+
+	return tree;
+}
+
+
+/** Function: free_basis_tree
+ ** Frees the basis tree, setting the pointer to NULL.
+ **/
+void free_basis_tree(BASIS_TREE ** tree_p)
+{
+	BASIS_TREE * tree;
+
+	if(!tree_p || !*tree_p) {
+		return;
+	}
+
+	tree = *tree_p;
+
+	free(tree->tail);
+	free(tree->head);
+	free(tree->costs);
+	free(tree->adj_first);
+	free(tree->adj_arc);
+	free(tree->arc_basis);
+	free(tree->node_basis);
+	free(tree->pi);
+	free(tree->dj);
+	free(tree->parent);
+	free(tree->parent_arc);
+	free(tree->first_child);
+	free(tree->next_sibling);
+	free(tree->prev_sibling);
+	free(tree->moved);
+	free(tree->stack);
+	free(tree->mark);
+
+	free(tree);
+	*tree_p = NULL;
+}
+
+
+/** Function: basis_tree_load
+ ** Builds the tree of the given basis from scratch and computes the
+ ** potentials and reduced costs. Returns a non-zero value if the basis is
+ ** not a spanning forest with exactly one basic row per component.
+ **/
+int basis_tree_load(BASIS_TREE * tree, const NET_BASIS * basis)
+{
+	if(!tree || !basis) {
+		return -1;
+	}
+
+	memcpy(tree->arc_basis, basis->arc_basis, tree->narcs * sizeof(int));
+	memcpy(tree->node_basis, basis->node_basis, tree->nnodes * sizeof(int));
+
+	if(build_tree(tree)) {
+		return -1;
+	}
+
+	tree->rebuilds++;
+	tree->since_rebuild = 0;
+
+	return 0;
+}
+
+
+/** Function: basis_tree_update
+ ** Moves the tree to the basis of the primary solution, which differs from the
+ ** current one by at most one pivot, and fills the secondary solution: the
+ ** flow, slacks, status and basis are those of the primary solution, the
+ ** potentials, reduced costs and objective value are computed with the costs
+ ** of the tree. Any other change of basis makes the tree build again.
+ **/
+int basis_tree_update(BASIS_TREE * tree, const NET_SOLUTION * primary, NET_SOLUTION * secondary)
+{
+	const NET_BASIS * basis;
+	int entering = -1, leaving = -1, changes = 0;
+	int w, nmoved, walked = 0;
+	int status = 0;
+	int a, i;
+
+	if(!tree || !primary || !secondary) {
+		return -1;
+	}
+
+	basis = primary->basis;
+
+	for(a = 0; a < tree->narcs; a++) {
+		int was_basic = tree->arc_basis[a] == CPX_BASIC;
+		int is_basic = basis->arc_basis[a] == CPX_BASIC;
+
+		if(was_basic != is_basic) {
+			changes++;
+			if(is_basic) {
+				entering = a;
+			} else {
+				leaving = a;
+			}
+		}
+	}
+
+	for(i = 0; i < tree->nnodes; i++) {
+		if((tree->node_basis[i] == CPX_BASIC) != (basis->node_basis[i] == CPX_BASIC)) {
+			changes = -1;
+			break;
+		}
+	}
+
+	if(changes == 2 && entering >= 0 && leaving >= 0 && tree->since_rebuild < BASISTREE_REFRESH) {
+		status = pivot_array(tree, entering, leaving, &w, &nmoved, &walked);
+
+		if(!status) {
+			shift_potentials(tree, entering, nmoved, w == tree->tail[entering] ? tree->dj[entering] : -tree->dj[entering]);
+			memcpy(tree->arc_basis, basis->arc_basis, tree->narcs * sizeof(int));
+			tree->pivots++;
+			tree->since_rebuild++;
+			tree->walked += walked;
+		}
+	} else if(changes != 0) {
+		status = -1;
+	} else {
+		/* a bound flip: the tree is the same, only the flow changed */
+		memcpy(tree->arc_basis, basis->arc_basis, tree->narcs * sizeof(int));
+	}
+
+	if(status) {
+		status = basis_tree_load(tree, basis);
+		if(status) {
+			fprintf(stderr, "Basis tree: the basis is not a spanning tree.\n");
+			return status;
+		}
+	}
+
+	memcpy(secondary->x, primary->x, tree->narcs * sizeof(double));
+	memcpy(secondary->slack, primary->slack, tree->nnodes * sizeof(double));
+	memcpy(secondary->pi, tree->pi, tree->nnodes * sizeof(double));
+	memcpy(secondary->dj, tree->dj, tree->narcs * sizeof(double));
+	copy_basis(secondary->basis, basis, tree->narcs, tree->nnodes);
+	secondary->solstat = primary->solstat;
+	secondary->objval = objective_value(tree->costs, secondary->x, tree->narcs);
+
+	return 0;
+}
+
+
+/** Function: basis_tree_report
+ ** Prints the depth of the tree and the counts of pivots and rebuilds.
+ **/
+void basis_tree_report(FILE * out, const BASIS_TREE * tree)
+{
+	if(!out || !tree) {
+		return;
+	}
+
+	fprintf(out, "Basis tree: depth %d, %lu pivots, %lu rebuilds", tree->max_depth, tree->pivots, tree->rebuilds);
+	if(tree->pivots && tree->walked) {
+		fprintf(out, ", %.1lf nodes walked per pivot", (double) tree->walked / tree->pivots);
+	}
+	fprintf(out, "\n");
+}
+
+
+/** Function: basis_tree_kind
+ ** Returns the representation with the given name, or -2 if there is none.
+ **/
+int basis_tree_kind(const char * name)
+{
+	if(!name) {
+		return -2;
+	}
+
+	if(!strcmp(name, "none")) {
+		return BASISTREE_NONE;
+	}
+	if(!strcmp(name, "array")) {
+		return BASISTREE_ARRAY;
+	}
+
+	return -2;
+}
+
+
+/** Function: build_tree
+ ** Hangs every component of the basic arcs from its basic row with a
+ ** breadth-first search, filling the parent and child arrays, the depth and
+ ** the potentials, and computes every reduced cost.
+ **/
+static int build_tree(BASIS_TREE * tree)
+{
+	int * queue = tree->moved;
+	int qhead = 0, qtail = 0, reached = 0, nbasic = 0;
+	int i, a;
+
+	for(i = 0; i < tree->nnodes; i++) {
+		tree->parent[i] = -1;
+		tree->parent_arc[i] = -1;
+		tree->first_child[i] = -1;
+		tree->next_sibling[i] = -1;
+		tree->prev_sibling[i] = -1;
+		tree->mark[i] = 0;
+	}
+
+	for(a = 0; a < tree->narcs; a++) {
+		nbasic += tree->arc_basis[a] == CPX_BASIC;
+	}
+
+	/* stack holds the depth of each node during the search */
+	tree->max_depth = 0;
+	for(i = 0; i < tree->nnodes; i++) {
+		if(tree->node_basis[i] == CPX_BASIC) {
+			tree->pi[i] = 0.0;
+			tree->mark[i] = 1;
+			tree->stack[i] = 0;
+			queue[qtail++] = i;
+			nbasic++;
+		}
+	}
+
+	while(qhead < qtail) {
+		int u = queue[qhead++];
+		int k;
+
+		reached++;
+
+		for(k = tree->adj_first[u]; k < tree->adj_first[u + 1]; k++) {
+			int b = tree->adj_arc[k];
+			int v = tree->tail[b] == u ? tree->head[b] : tree->tail[b];
+
+			if(tree->arc_basis[b] != CPX_BASIC || tree->parent_arc[u] == b) {
+				continue;
+			}
+
+			/* a basic cycle or two basic rows in one component */
+			if(tree->mark[v]) {
+				goto FAIL;
+			}
+
+			tree->mark[v] = 1;
+			tree->pi[v] = v == tree->tail[b] ? tree->pi[u] + tree->costs[b] : tree->pi[u] - tree->costs[b];
+			tree->stack[v] = tree->stack[u] + 1;
+			if(tree->stack[v] > tree->max_depth) {
+				tree->max_depth = tree->stack[v];
+			}
+			attach_child(tree, u, v, b);
+			queue[qtail++] = v;
+		}
+	}
+
+	if(reached != tree->nnodes || nbasic != tree->nnodes) {
+		goto FAIL;
+	}
+
+	for(i = 0; i < tree->nnodes; i++) {
+		tree->mark[i] = 0;
+	}
+
+	for(a = 0; a < tree->narcs; a++) {
+		tree->dj[a] = tree->arc_basis[a] == CPX_BASIC ? 0.0 :
+		              tree->costs[a] - tree->pi[tree->tail[a]] + tree->pi[tree->head[a]];
+	}
+
+	return 0;
+
+FAIL:
+
+	for(i = 0; i < tree->nnodes; i++) {
+		tree->mark[i] = 0;
+	}
+
+	return -1;
+}
+
+
+/** Function: pivot_array
+ ** Pivot on the parent and child arrays. The leaving arc cuts the subtree of
+ ** its lower node q, the endpoint w of the entering arc inside that subtree is
+ ** found by walking up towards q, and the path from w to q is reversed so the
+ ** subtree hangs from the other endpoint of the entering arc. The moved nodes
+ ** are left marked in tree->moved and the nodes walked are counted.
+ **/
+static int pivot_array(BASIS_TREE * tree, int entering, int leaving, int * w_p, int * nmoved_p, int * walked_p)
+{
+	int q, w, z, steps = 0;
+	int prev, prev_arc, cur, nmoved = 0, top = 0;
+
+	if(tree->parent_arc[tree->head[leaving]] == leaving) {
+		q = tree->head[leaving];
+	} else if(tree->parent_arc[tree->tail[leaving]] == leaving) {
+		q = tree->tail[leaving];
+	} else {
+		return -1;
+	}
+
+	if(walk_up(tree, tree->tail[entering], q, &steps)) {
+		w = tree->tail[entering];
+		z = tree->head[entering];
+	} else if(walk_up(tree, tree->head[entering], q, &steps)) {
+		w = tree->head[entering];
+		z = tree->tail[entering];
+	} else {
+		*walked_p = steps;
+		return -1;
+	}
+
+	*walked_p = steps;
+
+	/* reverse the path from w up to q, hanging it from z */
+	detach_child(tree, q);
+	prev = z;
+	prev_arc = entering;
+	cur = w;
+	while(1) {
+		int next = tree->parent[cur];
+		int next_arc = tree->parent_arc[cur];
+
+		if(cur != q) {
+			detach_child(tree, cur);
+		}
+		attach_child(tree, prev, cur, prev_arc);
+
+		if(cur == q) {
+			break;
+		}
+
+		prev = cur;
+		prev_arc = next_arc;
+		cur = next;
+	}
+
+	/* collect the subtree now hanging from w */
+	tree->stack[top++] = w;
+	while(top > 0) {
+		int u = tree->stack[--top];
+		int c;
+
+		tree->moved[nmoved++] = u;
+		tree->mark[u] = 1;
+		for(c = tree->first_child[u]; c >= 0; c = tree->next_sibling[c]) {
+			tree->stack[top++] = c;
+		}
+	}
+
+	*w_p = w;
+	*nmoved_p = nmoved;
+
+	return tree->mark[z] ? -1 : 0;
+}
+
+
+/** Function: walk_up
+ ** Returns 1 if node q is an ancestor of node x (or x itself), adding the
+ ** nodes visited to steps.
+ **/
+static int walk_up(const BASIS_TREE * tree, int x, int q, int * steps)
+{
+	while(x >= 0 && x != q) {
+		x = tree->parent[x];
+		(*steps)++;
+	}
+
+	return x == q;
+}
+
+
+/** Function: shift_potentials
+ ** Adds shift to the potential of the nmoved nodes of tree->moved, which are
+ ** marked, and fixes the reduced cost of the arcs with exactly one moved
+ ** endpoint. The marks are cleared afterwards.
+ **/
+static void shift_potentials(BASIS_TREE * tree, int entering, int nmoved, double shift)
+{
+	int i;
+
+	for(i = 0; i < nmoved; i++) {
+		int u = tree->moved[i];
+		int k;
+
+		tree->pi[u] += shift;
+
+		for(k = tree->adj_first[u]; k < tree->adj_first[u + 1]; k++) {
+			int b = tree->adj_arc[k];
+
+			if(tree->tail[b] == u && !tree->mark[tree->head[b]]) {
+				tree->dj[b] -= shift;
+			} else if(tree->head[b] == u && !tree->mark[tree->tail[b]]) {
+				tree->dj[b] += shift;
+			}
+		}
+	}
+
+	for(i = 0; i < nmoved; i++) {
+		tree->mark[tree->moved[i]] = 0;
+	}
+
+	tree->dj[entering] = 0.0;
+}
+
+
+/** Function: detach_child
+ ** Removes node v from the child list of its parent.
+ **/
+static void detach_child(BASIS_TREE * tree, int v)
+{
+	int p = tree->parent[v];
+
+	if(p < 0) {
+		return;
+	}
+
+	if(tree->prev_sibling[v] >= 0) {
+		tree->next_sibling[tree->prev_sibling[v]] = tree->next_sibling[v];
+	} else {
+		tree->first_child[p] = tree->next_sibling[v];
+	}
+
+	if(tree->next_sibling[v] >= 0) {
+		tree->prev_sibling[tree->next_sibling[v]] = tree->prev_sibling[v];
+	}
+
+	tree->parent[v] = -1;
+	tree->parent_arc[v] = -1;
+	tree->next_sibling[v] = -1;
+	tree->prev_sibling[v] = -1;
+}
+
+
+/** Function: attach_child
+ ** Hangs node v from node p through the given arc.
+ **/
+static void attach_child(BASIS_TREE * tree, int p, int v, int arc)
+{
+	tree->parent[v] = p;
+	tree->parent_arc[v] = arc;
+	tree->prev_sibling[v] = -1;
+	tree->next_sibling[v] = tree->first_child[p];
+	if(tree->first_child[p] >= 0) {
+		tree->prev_sibling[tree->first_child[p]] = v;
+	}
+	tree->first_child[p] = v;
+}
@@ -0,0 +1,437 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+#include "frontier.h"
+#include "batch.h"
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The BATCH struct is shared by every worker. Workers take the scenarios in
+ ** order under the lock, which also guards the bases of the solved ones.
+ **/
+typedef struct batch_struct {
+	pthread_mutex_t lock;
+	SCENARIO * scenarios;
+	int nscenarios;
+	int next;
+	int nnodes;
+	const int * nodes;
+	const char * prefix;
+} BATCH;
+
+/** The WORKER struct holds the private context of one thread. **/
+typedef struct worker_struct {
+	BATCH * batch;
+	SOLVER_CTX * ctx;
+	FRONTIER * frontier;
+	pthread_t thread;
+	int started;
+} WORKER;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int read_scenarios(const char *, int, double **, int *);
+static void * run_worker(void *);
+static int solve_scenario(WORKER *, int);
+static int nearest_scenario(const BATCH *, int);
+static int write_scenario(const BATCH *, int, const FRONTIER *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: solve_batch
+ ** Solves every scenario of the file on the network loaded into ctx, which
+ ** only differ by the supplies of the nodes. The file holds one supply per
+ ** node for each scenario, with the sign of the network files, separated by
+ ** white space. The problem is loaded once and cloned into one context per
+ ** thread, and each scenario is warm started from the bases of the solved
+ ** scenario with the closest supplies: their bases stay dual feasible, so
+ ** dual simplex needs few pivots to reach the new anchors. The frontier of
+ ** scenario k is written to the file PREFIX.k.
+ **/
+int solve_batch(SOLVER_CTX * ctx, const char * filename, const char * prefix, int nthreads)
+{
+	int status = 0;
+	int i, nworkers = 0;
+	double * supplies = NULL;
+	int * nodes = NULL;
+	WORKER * workers = NULL;
+	BATCH batch;
+
+	memset(&batch, 0, sizeof(BATCH));
+	pthread_mutex_init(&batch.lock, NULL);
+
+	if(!ctx || !ctx->lp1 || !filename) {
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = read_scenarios(filename, ctx->nnodes, &supplies, &batch.nscenarios);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	batch.nnodes = ctx->nnodes;
+	batch.prefix = prefix ? prefix : BATCH_DEFAULT_PREFIX;
+
+	batch.scenarios = calloc(batch.nscenarios, sizeof(SCENARIO));
+	nodes = malloc(ctx->nnodes * sizeof(int));
+	if(!batch.scenarios || !nodes) {
+		fprintf(stderr, "Unable to alloc scenarios.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	for(i = 0; i < ctx->nnodes; i++) {
+		nodes[i] = i;
+	}
+	batch.nodes = nodes;
+
+	for(i = 0; i < batch.nscenarios; i++) {
+		batch.scenarios[i].supply = supplies + (size_t) i * ctx->nnodes;
+		batch.scenarios[i].source = -1;
+	}
+
+	/* read_scenarios() returns at least one scenario */
+	nworkers = nthreads < batch.nscenarios ? nthreads : batch.nscenarios;
+	if(nworkers < 1) {
+		nworkers = 1;
+	}
+
+	workers = calloc(nworkers, sizeof(WORKER));
+	if(!workers) {
+		fprintf(stderr, "Unable to alloc workers.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	/* The clones are made here, one at a time, as they read the LP objects
+	 * of ctx. CPLEX is kept to one thread per context as the scenarios
+	 * already use every core, and the portfolio racers of ctx are shared
+	 * among the workers for the same reason.
+	 */
+	for(i = 0; i < nworkers; i++) {
+		workers[i].batch = &batch;
+		workers[i].ctx = solver_clone(ctx);
+		workers[i].frontier = create_frontier();
+		if(!workers[i].ctx || !workers[i].frontier ||
+		   CPXsetintparam(workers[i].ctx->env1, CPX_PARAM_THREADS, 1) ||
+		   CPXsetintparam(workers[i].ctx->env2, CPX_PARAM_THREADS, 1)) {
+			fprintf(stderr, "Unable to set up worker %d.\n", i);
+			status = -1;
+			goto TERMINATE;
+		}
+		solver_set_callback(workers[i].ctx, frontier_record, workers[i].frontier);
+		solver_set_portfolio(workers[i].ctx, ctx->portfolio.database, ctx->portfolio.threads / nworkers);
+	}
+
+	for(i = 0; i < nworkers; i++) {
+		if(pthread_create(&workers[i].thread, NULL, run_worker, &workers[i])) {
+			fprintf(stderr, "Unable to start worker %d.\n", i);
+			status = -1;
+			break;
+		}
+		workers[i].started = 1;
+	}
+
+	for(i = 0; i < nworkers; i++) {
+		if(workers[i].started) {
+			pthread_join(workers[i].thread, NULL);
+		}
+	}
+
+	fprintf(stderr, "********************************************************************\n");
+	fprintf(stderr, "Scenario Batch (%d scenarios, %d threads):\n\n", batch.nscenarios, nworkers);
+
+	for(i = 0; i < batch.nscenarios; i++) {
+		const SCENARIO * sc = &batch.scenarios[i];
+
+		if(!sc->solved) {
+			fprintf(stderr, "Scenario %d\tfailed\n", i);
+			status = status ? status : -1;
+			continue;
+		}
+
+		if(sc->source < 0) {
+			fprintf(stderr, "Scenario %d\tpoints: %d\ttime: %lf\tcold start\n", i, sc->npoints, sc->elapsed);
+		} else {
+			fprintf(stderr, "Scenario %d\tpoints: %d\ttime: %lf\twarm start from %d\n",
+			        i, sc->npoints, sc->elapsed, sc->source);
+		}
+	}
+
+	fprintf(stderr, "\n");
+
+
+TERMINATE:
+
+	if(workers) {
+		for(i = 0; i < nworkers; i++) {
+			solver_free(&workers[i].ctx);
+			free_frontier(&workers[i].frontier);
+		}
+		free(workers);
+	}
+
+	if(batch.scenarios) {
+		for(i = 0; i < batch.nscenarios; i++) {
+			free_basis(&batch.scenarios[i].anchor);
+			free_basis(&batch.scenarios[i].perturb);
+		}
+		free(batch.scenarios);
+	}
+
+	free(supplies);
+	free(nodes);
+	pthread_mutex_destroy(&batch.lock);
+
+	return status;
+}
+
+
+/** Function: read_scenarios
+ ** Reads the supply vectors of the scenario file, nnodes values each, into a
+ ** new array. Returns a non-zero value if the file can't be read or its
+ ** number of values is not a multiple of nnodes.
+ **/
+static int read_scenarios(const char * filename, int nnodes, double ** supplies_p, int * count_p)
+{
+	FILE * in;
+	double * supplies = NULL;
+	size_t n = 0, capacity = 0;
+	double value;
+
+	in = fopen(filename, "r");
+	if(!in) {
+		fprintf(stderr, "Unable to open scenario file %s.\n", filename);
+		return -1;
+	}
+
+	while(fscanf(in, "%lf", &value) == 1) {
+		if(n == capacity) {
+			size_t grown = capacity ? 2 * capacity : (size_t) nnodes;
+			double * tmp = realloc(supplies, grown * sizeof(double));
+			if(!tmp) {
+				fprintf(stderr, "Unable to alloc scenario supplies.\n");
+				free(supplies);
+				fclose(in);
+				return -1;
+			}
+			supplies = tmp;
+			capacity = grown;
+		}
+		supplies[n++] = value;
+	}
+
+	if(!feof(in) || n == 0 || n % nnodes) {
+		fprintf(stderr, "Scenario file %s must hold %d supplies per scenario.\n", filename, nnodes);
+		free(supplies);
+		fclose(in);
+		return -1;
+	}
+
+	fclose(in);
+
+	*supplies_p = supplies;
+	*count_p = (int) (n / nnodes);
+
+	return 0;
+}
+
+
+/** Function: run_worker
+ ** Thread routine: solves the next unsolved scenario until none is left.
+ **/
+static void * run_worker(void * arg)
+{
+	WORKER * worker = arg;
+	BATCH * batch = worker->batch;
+	int k;
+
+	for(;;) {
+		pthread_mutex_lock(&batch->lock);
+		k = batch->next < batch->nscenarios ? batch->next++ : -1;
+		pthread_mutex_unlock(&batch->lock);
+
+		if(k < 0) {
+			break;
+		}
+
+		batch->scenarios[k].status = solve_scenario(worker, k);
+		if(batch->scenarios[k].status) {
+			fprintf(stderr, "Unable to solve scenario %d.\n", k);
+		}
+	}
+
+	return NULL;
+}
+
+
+/** Function: solve_scenario
+ ** Loads the supplies of scenario k into the context of the worker, warm
+ ** starts it from the closest solved scenario, walks the frontier and keeps
+ ** the anchor bases for the scenarios still to come.
+ **/
+static int solve_scenario(WORKER * worker, int k)
+{
+	int status = 0;
+	BATCH * batch = worker->batch;
+	SCENARIO * sc = &batch->scenarios[k];
+	SOLVER_CTX * ctx = worker->ctx;
+	const NET_SOLUTION * anchor;
+	NET_BASIS * anchor_basis = NULL;
+	NET_BASIS * perturb_basis = NULL;
+	double start, end;
+
+	CPXgettime(ctx->env1, &start);
+
+	/* keeps the bases of the previous scenario of this worker as a fallback */
+	status = solver_reset(ctx);
+	if(status) {
+		return status;
+	}
+
+	pthread_mutex_lock(&batch->lock);
+	sc->source = nearest_scenario(batch, k);
+	if(sc->source >= 0) {
+		status = solver_set_warm_start(ctx, batch->scenarios[sc->source].anchor,
+		                               batch->scenarios[sc->source].perturb);
+	}
+	pthread_mutex_unlock(&batch->lock);
+	if(status) {
+		return status;
+	}
+
+	status = solver_change_supplies(ctx, batch->nnodes, batch->nodes, sc->supply);
+	if(status) {
+		return status;
+	}
+
+	worker->frontier->npoints = 0;
+
+	status = solver_run(ctx);
+	if(status) {
+		return status;
+	}
+
+	frontier_finalize(worker->frontier);
+
+	status = write_scenario(batch, k, worker->frontier);
+	if(status) {
+		return status;
+	}
+
+	anchor = ctx->direction == SOLVER_BACKWARD ? ctx->initial_sol1 : ctx->initial_sol2;
+
+	anchor_basis = create_basis(ctx->narcs, ctx->nnodes);
+	perturb_basis = create_basis(ctx->narcs, ctx->nnodes);
+	if(!anchor_basis || !perturb_basis) {
+		fprintf(stderr, "Unable to alloc bases of scenario %d.\n", k);
+		free_basis(&anchor_basis);
+		free_basis(&perturb_basis);
+		return -1;
+	}
+
+	copy_basis(anchor_basis, anchor->basis, ctx->narcs, ctx->nnodes);
+	copy_basis(perturb_basis, ctx->perturbsol->basis, ctx->narcs, ctx->nnodes);
+
+	CPXgettime(ctx->env1, &end);
+
+	pthread_mutex_lock(&batch->lock);
+	sc->anchor = anchor_basis;
+	sc->perturb = perturb_basis;
+	sc->npoints = worker->frontier->npoints;
+	sc->elapsed = end - start;
+	sc->solved = 1;
+	pthread_mutex_unlock(&batch->lock);
+
+	return 0;
+}
+
+
+/** Function: nearest_scenario
+ ** Returns the solved scenario whose supplies are the closest to those of
+ ** scenario k in the L1 norm, or -1 if none is solved yet. The caller must
+ ** hold the lock of the batch.
+ **/
+static int nearest_scenario(const BATCH * batch, int k)
+{
+	const double * supply = batch->scenarios[k].supply;
+	double best = HUGE_VAL;
+	int nearest = -1;
+	int i, j;
+
+	for(i = 0; i < batch->nscenarios; i++) {
+		const double * other = batch->scenarios[i].supply;
+		double dist = 0.0;
+
+		if(!batch->scenarios[i].solved) {
+			continue;
+		}
+
+		for(j = 0; j < batch->nnodes && dist < best; j++) {
+			dist += fabs(supply[j] - other[j]);
+		}
+
+		if(dist < best) {
+			best = dist;
+			nearest = i;
+		}
+	}
+
+	return nearest;
+}
+
+
+/** Function: write_scenario
+ ** Writes the frontier of scenario k to the file PREFIX.k.
+ **/
+static int write_scenario(const BATCH * batch, int k, const FRONTIER * frontier)
+{
+	char filename[FILENAME_MAX];
+	FILE * out;
+
+	snprintf(filename, sizeof(filename), "%s.%d", batch->prefix, k);
+
+	out = fopen(filename, "w");
+	if(!out) {
+		fprintf(stderr, "Unable to open %s.\n", filename);
+		return -1;
+	}
+
+	fprint_frontier(out, frontier);
+
+	if(fclose(out)) {
+		fprintf(stderr, "Unable to write %s.\n", filename);
+		return -1;
+	}
+
+	return 0;
+}
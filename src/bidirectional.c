@@ -0,0 +1,235 @@
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "solver.h"
+#include "frontier.h"
+#include "bidirectional.h"
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The MEETING struct is shared by both walks. Each walk publishes the
+ ** objective 2 value of its last basis and the walks stop as soon as the
+ ** forward walk (decreasing z2) is at or below the backward walk (increasing
+ ** z2), i.e., when both reached a common point or crossed each other.
+ **/
+typedef struct meeting_struct {
+	pthread_mutex_t lock;
+	double obj2[2];
+	int started[2];
+	int met;
+} MEETING;
+
+/** The WALK struct holds the input and the output of one of the threads. **/
+typedef struct walk_struct {
+	const char * net_file1;
+	const char * net_file2;
+	int direction;
+	FRONTIER * frontier;
+	MEETING * meeting;
+	int status;
+} WALK;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static void * run_walk(void *);
+static int record_and_meet(const SOLVER_ITERATION *, void *);
+static void stop_walks(MEETING *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: solve_bidirectional
+ ** Computes the frontier walking from both extreme points at the same time.
+ ** The forward walk starts near the objective 1 minimum and the backward walk
+ ** starts from the objective 2 end, perturbed toward objective 1, using the
+ ** mirrored ratio rule. Each walk runs on its own thread with its own solver
+ ** context and both stop when they meet. The points of both halves are merged
+ ** into the frontier passed as argument, which is left finalized. Returns a
+ ** non-zero value if any of the walks failed.
+ **/
+int solve_bidirectional(const char * net_file1, const char * net_file2, FRONTIER * frontier)
+{
+	MEETING meeting;
+	WALK walks[2];
+	pthread_t threads[2];
+	int created[2] = {0, 0};
+	int status = 0;
+	int i, j;
+
+	if(!net_file1 || !net_file2 || !frontier) {
+		fprintf(stderr, "Unable to start bidirectional solve due to NULL argument.\n");
+		return -1;
+	}
+
+	memset(&meeting, 0, sizeof(MEETING));
+	pthread_mutex_init(&meeting.lock, NULL);
+
+	for(i = 0; i < 2; i++) {
+		walks[i].net_file1 = net_file1;
+		walks[i].net_file2 = net_file2;
+		walks[i].direction = (i == 0) ? SOLVER_FORWARD : SOLVER_BACKWARD;
+		walks[i].meeting = &meeting;
+		walks[i].status = 0;
+		walks[i].frontier = create_frontier();
+		if(!walks[i].frontier) {
+			status = -1;
+		}
+	}
+
+	for(i = 0; i < 2 && !status; i++) {
+		if(pthread_create(&threads[i], NULL, run_walk, &walks[i])) {
+			fprintf(stderr, "Unable to start walk thread %d.\n", i);
+			stop_walks(&meeting);
+			status = -1;
+			break;
+		}
+		created[i] = 1;
+	}
+
+	for(i = 0; i < 2; i++) {
+		if(created[i]) {
+			pthread_join(threads[i], NULL);
+			if(walks[i].status) {
+				status = walks[i].status;
+			}
+		}
+	}
+
+	if(!status && !meeting.met) {
+		fprintf(stderr, "The forward and backward walks did not meet.\n");
+		status = -1;
+	}
+
+	/* Merge both halves. The overlap around the meeting point holds the same
+	 * points twice and is removed when the frontier is finalized.
+	 */
+	for(i = 0; i < 2 && !status; i++) {
+		for(j = 0; j < walks[i].frontier->npoints; j++) {
+			const FRONTIER_POINT * p = &walks[i].frontier->points[j];
+			status = frontier_add(frontier, p->obj1, p->obj2, p->iteration, p->arc);
+			if(status) {
+				break;
+			}
+		}
+	}
+
+	if(!status) {
+		frontier_finalize(frontier);
+	}
+
+	free_frontier(&walks[0].frontier);
+	free_frontier(&walks[1].frontier);
+	pthread_mutex_destroy(&meeting.lock);
+
+	return status;
+}
+
+
+/** Function: run_walk
+ ** Thread routine of one walk. A private solver context is loaded, both
+ ** anchor solves are made and the loop runs until the walks meet or the
+ ** pivoted objective reaches its minimum.
+ **/
+static void * run_walk(void * data)
+{
+	WALK * walk = data;
+	SOLVER_CTX * ctx = NULL;
+	int status = 0;
+
+	ctx = solver_create();
+	if(!ctx) {
+		status = -1;
+		goto TERMINATE;
+	}
+
+	solver_set_direction(ctx, walk->direction);
+	solver_set_callback(ctx, record_and_meet, walk);
+
+	status = solver_load(ctx, walk->net_file1, walk->net_file2);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	status = solver_run(ctx);
+	if(!status && walk->status) {
+		status = walk->status;
+	}
+
+TERMINATE:
+
+	/* A failed walk must not leave the other one waiting for the meeting */
+	if(status) {
+		fprintf(stderr, "The %s walk failed.\n", walk->direction == SOLVER_FORWARD ? "forward" : "backward");
+		stop_walks(walk->meeting);
+	}
+
+	solver_free(&ctx);
+	walk->status = status;
+
+	return NULL;
+}
+
+
+/** Function: record_and_meet
+ ** Iteration callback of both walks. The point is stored in the frontier of
+ ** the walk and its objective 2 value published to the other walk. Returns a
+ ** non-zero value, which stops the walk, once both walks met.
+ **/
+static int record_and_meet(const SOLVER_ITERATION * it, void * data)
+{
+	WALK * walk = data;
+	MEETING * meeting = walk->meeting;
+	int met;
+
+	if(frontier_record(it, walk->frontier)) {
+		walk->status = -1;
+		stop_walks(meeting);
+		return 1;
+	}
+
+	pthread_mutex_lock(&meeting->lock);
+
+	meeting->obj2[walk->direction] = it->solution2->objval;
+	meeting->started[walk->direction] = 1;
+
+	if(meeting->started[SOLVER_FORWARD] && meeting->started[SOLVER_BACKWARD] &&
+	   meeting->obj2[SOLVER_FORWARD] <= meeting->obj2[SOLVER_BACKWARD] + FRONTIER_TOL) {
+		meeting->met = 1;
+	}
+
+	met = meeting->met;
+
+	pthread_mutex_unlock(&meeting->lock);
+
+	return met;
+}
+
+
+/** Function: stop_walks
+ ** Forces both walks to stop at their next iteration.
+ **/
+static void stop_walks(MEETING * meeting)
+{
+	pthread_mutex_lock(&meeting->lock);
+	meeting->met = 1;
+	pthread_mutex_unlock(&meeting->lock);
+}
@@ -0,0 +1,760 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "costscale.h"
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The RESIDUAL struct is the residual graph used by the cost scaling engine.
+ ** Residual arc 2a is arc a of the network and 2a+1 is its reverse. The arcs
+ ** leaving node i are order[first[i]] to order[first[i+1] - 1]. Capacities,
+ ** costs and potentials are integers so the engine is exact.
+ **/
+typedef struct residual_struct {
+	int nnodes;
+	int narcs;
+	int * first;
+	int * order;
+	int * to;
+	long long * cap;
+	long long * cost;
+	long long * excess;
+	long long * pi;
+
+	/* work arrays of refine() */
+	int * cur;
+	int * queue;
+	int * relabels;
+	char * queued;
+} RESIDUAL;
+
+/** Non-tree arc ordered by the absolute value of its reduced cost **/
+typedef struct tree_candidate_struct {
+	double key;
+	int arc;
+} TREE_CANDIDATE;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int alloc_residual(RESIDUAL *, int, int);
+static void free_residual(RESIDUAL *);
+static double cost_multiplier(const double *, int);
+static int is_integral(double);
+static int refine(RESIDUAL *, long long);
+static int find_root(int *, int);
+static int tree_cycle(const NET_TOPOLOGY *, const int *, const int *, int, int, int *, char *);
+static void hang_subtree(const NET_TOPOLOGY *, const int *, const int *, const char *, int, int, int,
+                         int *, int *, int *);
+static double arc_room(const NET_TOPOLOGY *, const double *, int, int);
+static int compare_candidates(const void *, const void *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: cost_scaling_flow
+ ** Finds a minimum cost flow of the network with Goldberg's cost scaling
+ ** push-relabel algorithm. Bounds and supplies must be integral and the costs
+ ** must become integral once multiplied by a power of ten no larger than
+ ** COSTSCALE_MAX_MULTIPLIER. Costs are multiplied by nnodes + 1 so the flow
+ ** of the last refine pass (epsilon = 1) is optimal.
+ **
+ ** The flow of every arc is stored in x. If pi is not NULL it receives node
+ ** potentials for which the reduced cost c[a] + pi[tail] - pi[head] is
+ ** non-negative on every arc that can still increase its flow. Returns a
+ ** non-zero value if the problem does not meet the requirements above or if
+ ** it is infeasible or unbounded.
+ **/
+int cost_scaling_flow(const NET_TOPOLOGY * topo, const double * costs, double * x, double * pi)
+{
+	int status = 0;
+	RESIDUAL res;
+	double multiplier;
+	long long scale, maxcost = 0, big = 1, balance = 0, eps;
+	int narcs, nnodes;
+	int i, a;
+
+	memset(&res, 0, sizeof(RESIDUAL));
+
+	if(!topo || !costs || !x || topo->nnodes <= 0) {
+		return -1;
+	}
+
+	narcs = topo->narcs;
+	nnodes = topo->nnodes;
+	scale = nnodes + 1;
+
+	multiplier = cost_multiplier(costs, narcs);
+	if(multiplier <= 0.0) {
+		fprintf(stderr, "Cost scaling: arc costs are not integral after scaling by %g.\n", COSTSCALE_MAX_MULTIPLIER);
+		return -1;
+	}
+
+	for(a = 0; a < narcs; a++) {
+		if(topo->lb[a] <= -CPX_INFBOUND || !is_integral(topo->lb[a]) ||
+		   (topo->ub[a] < CPX_INFBOUND && !is_integral(topo->ub[a])) || topo->ub[a] < topo->lb[a]) {
+			fprintf(stderr, "Cost scaling: arc %d has fractional, infinite or crossed bounds.\n", a);
+			return -1;
+		}
+
+		if(llabs(llround(costs[a] * multiplier)) > maxcost) {
+			maxcost = llabs(llround(costs[a] * multiplier));
+		}
+	}
+
+	for(i = 0; i < nnodes; i++) {
+		if(!is_integral(topo->supply[i])) {
+			fprintf(stderr, "Cost scaling: node %d has a fractional supply.\n", i);
+			return -1;
+		}
+	}
+
+	/* the potentials fall by at most (alpha + 2)(n + 1) epsilon per refine */
+	if((double) maxcost * scale * scale * 2.0 * (COSTSCALE_ALPHA + 2) > 4e18) {
+		fprintf(stderr, "Cost scaling: costs are too large for exact integer arithmetic.\n");
+		return -1;
+	}
+
+	status = alloc_residual(&res, narcs, nnodes);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	/* Lower bounds are moved into the supplies, so every residual capacity
+	 * starts at zero. Uncapacitated arcs get a capacity no basic flow can
+	 * reach, which is used afterwards to detect unbounded problems.
+	 */
+	for(i = 0; i < nnodes; i++) {
+		res.excess[i] = llround(topo->supply[i]);
+	}
+
+	for(a = 0; a < narcs; a++) {
+		long long lb = llround(topo->lb[a]);
+
+		res.excess[topo->tail[a]] -= lb;
+		res.excess[topo->head[a]] += lb;
+		if(topo->ub[a] < CPX_INFBOUND) {
+			big += llround(topo->ub[a]) - lb;
+		}
+	}
+
+	for(i = 0; i < nnodes; i++) {
+		balance += res.excess[i];
+		if(res.excess[i] > 0) {
+			big += res.excess[i];
+		}
+	}
+
+	if(balance != 0) {
+		fprintf(stderr, "Cost scaling: supplies do not add up to zero.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	for(i = 0; i <= nnodes; i++) {
+		res.first[i] = 0;
+	}
+	for(a = 0; a < narcs; a++) {
+		res.first[topo->tail[a] + 1]++;
+		res.first[topo->head[a] + 1]++;
+	}
+	for(i = 0; i < nnodes; i++) {
+		res.first[i + 1] += res.first[i];
+		res.cur[i] = res.first[i];
+	}
+
+	for(a = 0; a < narcs; a++) {
+		res.order[res.cur[topo->tail[a]]++] = 2 * a;
+		res.order[res.cur[topo->head[a]]++] = 2 * a + 1;
+
+		res.to[2 * a] = topo->head[a];
+		res.to[2 * a + 1] = topo->tail[a];
+		res.cap[2 * a] = topo->ub[a] < CPX_INFBOUND ? llround(topo->ub[a]) - llround(topo->lb[a]) : big;
+		res.cap[2 * a + 1] = 0;
+		res.cost[2 * a] = llround(costs[a] * multiplier) * scale;
+		res.cost[2 * a + 1] = -res.cost[2 * a];
+	}
+
+	/* any flow is maxcost-optimal, each pass divides epsilon by alpha */
+	eps = maxcost * scale;
+	do {
+		eps /= COSTSCALE_ALPHA;
+		if(eps < 1) {
+			eps = 1;
+		}
+
+		status = refine(&res, eps);
+		if(status) {
+			fprintf(stderr, "Cost scaling: the network has no feasible flow.\n");
+			goto TERMINATE;
+		}
+	} while(eps > 1);
+
+	for(a = 0; a < narcs; a++) {
+		if(topo->ub[a] >= CPX_INFBOUND && res.cap[2 * a] == 0) {
+			fprintf(stderr, "Cost scaling: the problem is unbounded.\n");
+			status = -1;
+			goto TERMINATE;
+		}
+
+		x[a] = topo->lb[a] + (double) res.cap[2 * a + 1];
+	}
+
+	if(pi) {
+		for(i = 0; i < nnodes; i++) {
+			pi[i] = (double) res.pi[i] / (multiplier * scale);
+		}
+	}
+
+TERMINATE:
+
+	free_residual(&res);
+
+	return status;
+}
+
+
+/** Function: spanning_tree_basis
+ ** Turns an optimal flow into a spanning tree basis in the CPLEX format of
+ ** CPXcopybase(). The arcs strictly between their bounds must all be basic,
+ ** so every cycle they close is cancelled first by moving flow around it
+ ** until one of its arcs reaches a bound. Cycles of free arcs cost nothing on
+ ** an optimal flow, so x stays optimal. The forest keeps the parent arc and
+ ** the depth of every node, so a cycle is found by walking up from both ends
+ ** of the arc to their common ancestor, and only the subtree that an arc
+ ** exchange cuts off is hung again. The forest is then completed with the
+ ** arcs of smallest reduced cost under the potentials pi (which may be NULL),
+ ** as those are the degenerate basic arcs least likely to need a pivot. The
+ ** row of one node of every connected component is left basic.
+ **/
+int spanning_tree_basis(const NET_TOPOLOGY * topo, const double * costs, const double * pi,
+                        double * x, int * arc_basis, int * node_basis)
+{
+	int status = 0;
+	int * uf = NULL;
+	int * adj_first = NULL;
+	int * adj_arc = NULL;
+	int * parent = NULL;
+	int * depth = NULL;
+	int * size = NULL;
+	int * queue = NULL;
+	int * cycle = NULL;
+	char * along = NULL;
+	char * in_tree = NULL;
+	TREE_CANDIDATE * candidates = NULL;
+	int narcs, nnodes, ncandidates = 0;
+	int i, a;
+
+	if(!topo || !costs || !x || !arc_basis || !node_basis) {
+		return -1;
+	}
+
+	narcs = topo->narcs;
+	nnodes = topo->nnodes;
+
+	uf = malloc(nnodes * sizeof(int));
+	adj_first = calloc(nnodes + 1, sizeof(int));
+	adj_arc = malloc((2 * narcs + 1) * sizeof(int));
+	parent = malloc(nnodes * sizeof(int));
+	depth = malloc(nnodes * sizeof(int));
+	size = malloc(nnodes * sizeof(int));
+	queue = malloc(nnodes * sizeof(int));
+	cycle = malloc((nnodes + 1) * sizeof(int));
+	along = malloc(nnodes + 1);
+	in_tree = calloc(narcs + 1, sizeof(char));
+	candidates = malloc((narcs + 1) * sizeof(TREE_CANDIDATE));
+	if(!uf || !adj_first || !adj_arc || !parent || !depth || !size || !queue || !cycle || !along ||
+	   !in_tree || !candidates) {
+		fprintf(stderr, "Unable to alloc spanning tree.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	for(a = 0; a < narcs; a++) {
+		adj_first[topo->tail[a] + 1]++;
+		adj_first[topo->head[a] + 1]++;
+	}
+	for(i = 0; i < nnodes; i++) {
+		adj_first[i + 1] += adj_first[i];
+		queue[i] = adj_first[i];
+	}
+	for(a = 0; a < narcs; a++) {
+		adj_arc[queue[topo->tail[a]]++] = a;
+		adj_arc[queue[topo->head[a]]++] = a;
+	}
+
+	/* every node starts as the root of its own tree */
+	for(i = 0; i < nnodes; i++) {
+		uf[i] = i;
+		size[i] = 1;
+		parent[i] = -1;
+		depth[i] = 0;
+	}
+
+	/* free arcs first, cancelling every cycle they close */
+	for(a = 0; a < narcs; a++) {
+		int t = topo->tail[a];
+		int h = topo->head[a];
+		int rt, rh, blocking, sign, ncycle, k;
+		double cost, delta;
+
+		if(x[a] <= topo->lb[a] + COSTSCALE_TOL || x[a] >= topo->ub[a] - COSTSCALE_TOL) {
+			continue;
+		}
+
+		rt = find_root(uf, t);
+		rh = find_root(uf, h);
+		/* the smaller tree is hung from the other one by the arc */
+		if(rt != rh) {
+			in_tree[a] = 1;
+			if(size[rt] <= size[rh]) {
+				uf[rt] = rh;
+				size[rh] += size[rt];
+				hang_subtree(topo, adj_first, adj_arc, in_tree, t, a, h, parent, depth, queue);
+			} else {
+				uf[rh] = rt;
+				size[rt] += size[rh];
+				hang_subtree(topo, adj_first, adj_arc, in_tree, h, a, t, parent, depth, queue);
+			}
+			continue;
+		}
+
+		/* the cycle is a (t -> h) followed by the tree path from h to t */
+		ncycle = tree_cycle(topo, parent, depth, t, h, cycle, along);
+
+		cost = costs[a];
+		for(k = 0; k < ncycle; k++) {
+			cost += along[k] ? costs[cycle[k]] : -costs[cycle[k]];
+		}
+
+		sign = cost > COSTSCALE_TOL ? -1 : 1;
+		for(;;) {
+			delta = arc_room(topo, x, a, sign);
+			blocking = a;
+			for(k = 0; k < ncycle; k++) {
+				double room = arc_room(topo, x, cycle[k], along[k] ? sign : -sign);
+
+				if(room < delta) {
+					delta = room;
+					blocking = cycle[k];
+				}
+			}
+
+			/* a zero cost cycle can always be pushed back to a lower bound */
+			if(!isinf(delta) || sign < 0) {
+				break;
+			}
+			sign = -1;
+		}
+
+		x[a] += sign * delta;
+		for(k = 0; k < ncycle; k++) {
+			x[cycle[k]] += along[k] ? sign * delta : -sign * delta;
+		}
+
+		/* the blocking arc leaves the forest, snapped exactly to its bound */
+		if(x[blocking] - topo->lb[blocking] <= topo->ub[blocking] - x[blocking]) {
+			x[blocking] = topo->lb[blocking];
+		} else {
+			x[blocking] = topo->ub[blocking];
+		}
+
+		/* the subtree cut off by the blocking arc holds one end of a and is
+		 * hung again by a from the other end
+		 */
+		if(blocking != a) {
+			int child = depth[topo->tail[blocking]] > depth[topo->head[blocking]] ?
+			            topo->tail[blocking] : topo->head[blocking];
+			int w = t;
+
+			while(depth[w] > depth[child]) {
+				int b = parent[w];
+				w = topo->tail[b] == w ? topo->head[b] : topo->tail[b];
+			}
+
+			in_tree[blocking] = 0;
+			in_tree[a] = 1;
+			if(w == child) {
+				hang_subtree(topo, adj_first, adj_arc, in_tree, t, a, h, parent, depth, queue);
+			} else {
+				hang_subtree(topo, adj_first, adj_arc, in_tree, h, a, t, parent, depth, queue);
+			}
+		}
+	}
+
+	/* then the arcs at their bounds, by increasing reduced cost */
+	for(a = 0; a < narcs; a++) {
+		if(in_tree[a]) {
+			continue;
+		}
+
+		candidates[ncandidates].arc = a;
+		candidates[ncandidates].key = pi ? fabs(costs[a] + pi[topo->tail[a]] - pi[topo->head[a]]) : 0.0;
+		ncandidates++;
+	}
+
+	qsort(candidates, ncandidates, sizeof(TREE_CANDIDATE), compare_candidates);
+
+	for(i = 0; i < ncandidates; i++) {
+		int rt, rh;
+
+		a = candidates[i].arc;
+		rt = find_root(uf, topo->tail[a]);
+		rh = find_root(uf, topo->head[a]);
+		if(rt != rh) {
+			uf[rt] = rh;
+			in_tree[a] = 1;
+		}
+	}
+
+	for(a = 0; a < narcs; a++) {
+		if(in_tree[a]) {
+			arc_basis[a] = CPX_BASIC;
+		} else if(topo->ub[a] < CPX_INFBOUND && x[a] >= topo->ub[a] - COSTSCALE_TOL) {
+			arc_basis[a] = CPX_AT_UPPER;
+		} else {
+			arc_basis[a] = CPX_AT_LOWER;
+		}
+	}
+
+	for(i = 0; i < nnodes; i++) {
+		node_basis[i] = find_root(uf, i) == i ? CPX_BASIC : CPX_AT_LOWER;
+	}
+
+TERMINATE:
+
+	free(uf);
+	free(adj_first);
+	free(adj_arc);
+	free(parent);
+	free(depth);
+	free(size);
+	free(queue);
+	free(cycle);
+	free(along);
+	free(in_tree);
+	free(candidates);
+
+	return status;
+}
+
+
+/** Function: refine
+ ** One pass of the cost scaling algorithm. Every admissible arc (positive
+ ** residual capacity and negative reduced cost) is saturated and the excess
+ ** this creates is pushed along admissible arcs in FIFO order, relabelling a
+ ** node when none is left. The resulting flow is epsilon-optimal. A node
+ ** relabelled more times than the algorithm allows proves the network has no
+ ** feasible flow, in which case a non-zero value is returned.
+ **/
+static int refine(RESIDUAL * res, long long eps)
+{
+	int n = res->nnodes;
+	int limit = (COSTSCALE_ALPHA + 2) * (n + 1);
+	int qhead = 0, qcount = 0;
+	int i, r;
+
+	for(r = 0; r < res->narcs; r++) {
+		int u = res->to[r ^ 1];
+		int v = res->to[r];
+
+		if(res->cap[r] > 0 && res->cost[r] + res->pi[u] - res->pi[v] < 0) {
+			res->excess[u] -= res->cap[r];
+			res->excess[v] += res->cap[r];
+			res->cap[r ^ 1] += res->cap[r];
+			res->cap[r] = 0;
+		}
+	}
+
+	for(i = 0; i < n; i++) {
+		res->cur[i] = res->first[i];
+		res->relabels[i] = 0;
+		res->queued[i] = 0;
+		if(res->excess[i] > 0) {
+			res->queue[(qhead + qcount++) % n] = i;
+			res->queued[i] = 1;
+		}
+	}
+
+	while(qcount > 0) {
+		int u = res->queue[qhead];
+
+		qhead = (qhead + 1) % n;
+		qcount--;
+		res->queued[u] = 0;
+
+		while(res->excess[u] > 0) {
+			int v;
+
+			if(res->cur[u] == res->first[u + 1]) {
+				long long best = LLONG_MIN;
+				int k;
+
+				for(k = res->first[u]; k < res->first[u + 1]; k++) {
+					r = res->order[k];
+					if(res->cap[r] > 0 && res->pi[res->to[r]] - res->cost[r] > best) {
+						best = res->pi[res->to[r]] - res->cost[r];
+					}
+				}
+
+				if(best == LLONG_MIN || ++res->relabels[u] > limit) {
+					return -1;
+				}
+
+				res->pi[u] = best - eps;
+				res->cur[u] = res->first[u];
+				continue;
+			}
+
+			r = res->order[res->cur[u]];
+			v = res->to[r];
+
+			if(res->cap[r] > 0 && res->cost[r] + res->pi[u] - res->pi[v] < 0) {
+				long long delta = res->excess[u] < res->cap[r] ? res->excess[u] : res->cap[r];
+
+				res->cap[r] -= delta;
+				res->cap[r ^ 1] += delta;
+				res->excess[u] -= delta;
+				res->excess[v] += delta;
+
+				if(v != u && !res->queued[v] && res->excess[v] > 0) {
+					res->queue[(qhead + qcount++) % n] = v;
+					res->queued[v] = 1;
+				}
+
+				if(res->cap[r] == 0) {
+					res->cur[u]++;
+				}
+			} else {
+				res->cur[u]++;
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+/** Function: alloc_residual
+ ** Allocs every array of the residual graph of a network with the given
+ ** number of arcs and nodes. Potentials start at zero.
+ **/
+static int alloc_residual(RESIDUAL * res, int narcs, int nnodes)
+{
+	res->nnodes = nnodes;
+	res->narcs = 2 * narcs;
+
+	res->first = malloc((nnodes + 1) * sizeof(int));
+	res->order = malloc((2 * narcs + 1) * sizeof(int));
+	res->to = malloc((2 * narcs + 1) * sizeof(int));
+	res->cap = malloc((2 * narcs + 1) * sizeof(long long));
+	res->cost = malloc((2 * narcs + 1) * sizeof(long long));
+	res->excess = malloc(nnodes * sizeof(long long));
+	res->pi = calloc(nnodes, sizeof(long long));
+	res->cur = malloc((nnodes + 1) * sizeof(int));
+	res->queue = malloc(nnodes * sizeof(int));
+	res->relabels = malloc(nnodes * sizeof(int));
+	res->queued = malloc(nnodes * sizeof(char));
+
+	if(!res->first || !res->order || !res->to || !res->cap || !res->cost || !res->excess ||
+	   !res->pi || !res->cur || !res->queue || !res->relabels || !res->queued) {
+		fprintf(stderr, "Unable to alloc residual graph.\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/** Function: free_residual
+ ** Frees every array of the residual graph.
+ **/
+static void free_residual(RESIDUAL * res)
+{
+	free(res->first);
+	free(res->order);
+	free(res->to);
+	free(res->cap);
+	free(res->cost);
+	free(res->excess);
+	free(res->pi);
+	free(res->cur);
+	free(res->queue);
+	free(res->relabels);
+	free(res->queued);
+}
+
+
+/** Function: cost_multiplier
+ ** Returns the smallest power of ten, up to COSTSCALE_MAX_MULTIPLIER, that
+ ** makes every cost integral, or -1 if there is none. Blended costs such as
+ ** 0.999*c1 + 0.001*c2 of integral costs are made integral this way.
+ **/
+static double cost_multiplier(const double * costs, int narcs)
+{
+	double multiplier;
+	int a;
+
+	for(multiplier = 1.0; multiplier <= COSTSCALE_MAX_MULTIPLIER; multiplier *= 10.0) {
+		for(a = 0; a < narcs; a++) {
+			double scaled = costs[a] * multiplier;
+
+			if(fabs(scaled - nearbyint(scaled)) > 1e-6 || fabs(scaled) > 1e15) {
+				break;
+			}
+		}
+
+		if(a == narcs) {
+			return multiplier;
+		}
+	}
+
+	return -1.0;
+}
+
+
+/** Function: is_integral
+ ** Returns 1 if the value is an integer that fits exactly in a long long.
+ **/
+static int is_integral(double value)
+{
+	return fabs(value) < 1e15 && fabs(value - nearbyint(value)) <= COSTSCALE_TOL;
+}
+
+
+/** Function: find_root
+ ** Returns the representative of the component of node i, halving the path
+ ** on the way.
+ **/
+static int find_root(int * uf, int i)
+{
+	while(uf[i] != i) {
+		uf[i] = uf[uf[i]];
+		i = uf[i];
+	}
+
+	return i;
+}
+
+
+/** Function: tree_cycle
+ ** Stores in cycle the tree path that closes the cycle of an arc from node
+ ** from to node to, both in the same tree, found by walking up from the
+ ** deeper of the two ends until they meet. along[k] tells whether cycle[k] is
+ ** crossed from its tail to its head when the path is followed from to back
+ ** to from. Returns the number of arcs of the path.
+ **/
+static int tree_cycle(const NET_TOPOLOGY * topo, const int * parent, const int * depth,
+                      int from, int to, int * cycle, char * along)
+{
+	int ncycle = 0;
+
+	while(from != to) {
+		if(depth[from] >= depth[to]) {
+			int b = parent[from];
+
+			/* followed down from the parent to from */
+			cycle[ncycle] = b;
+			along[ncycle++] = topo->head[b] == from;
+			from = topo->tail[b] == from ? topo->head[b] : topo->tail[b];
+		} else {
+			int b = parent[to];
+
+			/* followed up from to to its parent */
+			cycle[ncycle] = b;
+			along[ncycle++] = topo->tail[b] == to;
+			to = topo->tail[b] == to ? topo->head[b] : topo->tail[b];
+		}
+	}
+
+	return ncycle;
+}
+
+
+/** Function: hang_subtree
+ ** Makes node root a child of node from through arc and walks the forest
+ ** arcs below root, breadth first, to set the parent arc and the depth of
+ ** every node of its subtree. The arc must already be in the forest and the
+ ** subtree must not reach from by any other forest arc.
+ **/
+static void hang_subtree(const NET_TOPOLOGY * topo, const int * adj_first, const int * adj_arc,
+                         const char * in_tree, int root, int arc, int from,
+                         int * parent, int * depth, int * queue)
+{
+	int qhead = 0, qtail = 0;
+
+	parent[root] = arc;
+	depth[root] = depth[from] + 1;
+	queue[qtail++] = root;
+
+	while(qhead < qtail) {
+		int u = queue[qhead++];
+		int k;
+
+		for(k = adj_first[u]; k < adj_first[u + 1]; k++) {
+			int b = adj_arc[k];
+			int v = topo->tail[b] == u ? topo->head[b] : topo->tail[b];
+
+			if(in_tree[b] && b != parent[u]) {
+				parent[v] = b;
+				depth[v] = depth[u] + 1;
+				queue[qtail++] = v;
+			}
+		}
+	}
+}
+
+
+/** Function: arc_room
+ ** Returns how much the flow of the arc can move in the given direction
+ ** (1 to increase it, -1 to decrease it) before it reaches a bound.
+ **/
+static double arc_room(const NET_TOPOLOGY * topo, const double * x, int a, int direction)
+{
+	if(direction > 0) {
+		return topo->ub[a] < CPX_INFBOUND ? topo->ub[a] - x[a] : INFINITY;
+	}
+
+	return x[a] - topo->lb[a];
+}
+
+
+/** Function: compare_candidates
+ ** qsort() comparator ordering candidates by key, then by arc index.
+ **/
+static int compare_candidates(const void * p, const void * q)
+{
+	const TREE_CANDIDATE * a = p;
+	const TREE_CANDIDATE * b = q;
+
+	if(a->key != b->key) {
+		return a->key < b->key ? -1 : 1;
+	}
+
+	return a->arc - b->arc;
+}
@@ -0,0 +1,772 @@
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "dimacs.h"
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The DIMACS_FILE struct is a network file mapped into memory. body is the
+ ** offset of the first line after the problem line.
+ **/
+typedef struct dimacs_file_struct {
+	const char * path;
+	const char * data;
+	size_t size;
+	size_t body;
+	int nnodes;
+	long narcs;
+} DIMACS_FILE;
+
+/** The DIMACS_CHUNK struct is a range of whole lines of a file: its arc
+ ** lines, the index of the first one and, if a line is malformed, the offset
+ ** of the first bad line and what is wrong with it.
+ **/
+typedef struct dimacs_chunk_struct {
+	size_t begin;
+	size_t end;
+	long arcs;
+	long first;
+	size_t error;
+	const char * message;
+} DIMACS_CHUNK;
+
+/*** Phases of a load, each run on every thread ***/
+#define DIMACS_COUNT 0	/* count the arc lines of every chunk of both files */
+#define DIMACS_ALIGN 1	/* split the second file at the arcs where the first one is split */
+#define DIMACS_PARSE 2	/* parse the chunks of the first file and their match in the second */
+
+/** The DIMACS_LOAD struct is shared by the threads of a load. They take the
+ ** tasks of the current phase in order under the lock.
+ **/
+typedef struct dimacs_load_struct {
+	pthread_mutex_t lock;
+	int phase;
+	int next;
+	int ntasks;
+
+	DIMACS_FILE files[2];
+	int nfiles;
+	DIMACS_CHUNK * chunks[2];
+	int nchunks[2];
+	size_t * splits;
+
+	NET_TOPOLOGY * topo;
+	double * costs[2];
+	double * supply2;
+} DIMACS_LOAD;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int map_file(DIMACS_FILE *, const char *);
+static void unmap_file(DIMACS_FILE *);
+static int read_header(DIMACS_FILE *);
+static int make_chunks(const DIMACS_FILE *, int, DIMACS_CHUNK **, int *);
+static int run_phase(DIMACS_LOAD *, int, int, int);
+static void * run_thread(void *);
+static void count_chunk(const DIMACS_FILE *, DIMACS_CHUNK *);
+static size_t locate_arc(const DIMACS_LOAD *, long);
+static void parse_chunk(DIMACS_LOAD *, int, int);
+static int report_errors(const DIMACS_LOAD *);
+static size_t line_end(const DIMACS_FILE *, size_t, size_t);
+static const char * skip_blanks(const char *, const char *);
+static int arc_line(const char *, const char *);
+static int parse_long(const char **, const char *, long *);
+static int parse_double(const char **, const char *, double *);
+static long line_number(const DIMACS_FILE *, size_t);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: read_dimacs
+ ** Reads the DIMACS minimum cost flow file net_file1 into a new topology and
+ ** a new cost array, without going through CPLEX. If net_file2 is not NULL
+ ** its costs are read in the same pass into a second array, and its arcs,
+ ** bounds and supplies are checked against the first file. Files are mapped
+ ** into memory and split at line boundaries into chunks parsed by nthreads
+ ** threads, which write every arc straight to its place in the arrays. The
+ ** chunks of the second file hold the same arcs as the chunks of the first
+ ** one, so each arc is checked by the thread that wrote it. Every malformed
+ ** line is reported with its file and line number. Returns a non-zero value
+ ** if any error is detected, in which case nothing is returned.
+ **/
+int read_dimacs(const char * net_file1, const char * net_file2, int nthreads,
+                NET_TOPOLOGY ** topo_p, double ** costs1_p, double ** costs2_p)
+{
+	int status = 0;
+	DIMACS_LOAD load;
+	int f, j;
+
+	memset(&load, 0, sizeof(DIMACS_LOAD));
+	pthread_mutex_init(&load.lock, NULL);
+
+	if(!net_file1 || !topo_p || !costs1_p || (net_file2 && !costs2_p)) {
+		fprintf(stderr, "Unable to read network due to NULL argument.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	if(nthreads < 1) {
+		nthreads = 1;
+	}
+
+	load.nfiles = net_file2 ? 2 : 1;
+	for(f = 0; f < load.nfiles; f++) {
+		status = map_file(&load.files[f], f ? net_file2 : net_file1);
+		if(!status) status = read_header(&load.files[f]);
+		if(!status) status = make_chunks(&load.files[f], nthreads, &load.chunks[f], &load.nchunks[f]);
+		if(status) {
+			goto TERMINATE;
+		}
+	}
+
+	if(load.nfiles == 2 && (load.files[1].nnodes != load.files[0].nnodes ||
+	                        load.files[1].narcs != load.files[0].narcs)) {
+		fprintf(stderr, "%s and %s have different sizes.\n", net_file1, net_file2);
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = run_phase(&load, DIMACS_COUNT, load.nchunks[0] + (load.nfiles == 2 ? load.nchunks[1] : 0), nthreads);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	for(f = 0; f < load.nfiles; f++) {
+		long total = 0;
+		for(j = 0; j < load.nchunks[f]; j++) {
+			load.chunks[f][j].first = total;
+			total += load.chunks[f][j].arcs;
+		}
+		if(total != load.files[f].narcs) {
+			fprintf(stderr, "%s declares %ld arcs but holds %ld.\n", load.files[f].path, load.files[f].narcs, total);
+			status = -1;
+			goto TERMINATE;
+		}
+	}
+
+	load.topo = create_topology((int) load.files[0].narcs, load.files[0].nnodes);
+	load.costs[0] = malloc((load.files[0].narcs > 0 ? load.files[0].narcs : 1) * sizeof(double));
+	if(!load.topo || !load.costs[0]) {
+		fprintf(stderr, "Unable to alloc network %s.\n", net_file1);
+		status = -1;
+		goto TERMINATE;
+	}
+	memset(load.topo->supply, 0, load.topo->nnodes * sizeof(double));
+
+	/* The chunks of the second file are remade to hold the arcs of the
+	 * chunks of the first one. Their supplies go to a scratch array, as any
+	 * chunk may hold any node.
+	 */
+	if(load.nfiles == 2) {
+		load.costs[1] = malloc((load.files[1].narcs > 0 ? load.files[1].narcs : 1) * sizeof(double));
+		load.supply2 = calloc(load.topo->nnodes > 0 ? load.topo->nnodes : 1, sizeof(double));
+		load.splits = malloc(load.nchunks[0] * sizeof(size_t));
+		if(!load.costs[1] || !load.supply2 || !load.splits) {
+			fprintf(stderr, "Unable to alloc network %s.\n", net_file2);
+			status = -1;
+			goto TERMINATE;
+		}
+
+		status = run_phase(&load, DIMACS_ALIGN, load.nchunks[0], nthreads);
+		if(status) {
+			goto TERMINATE;
+		}
+
+		free(load.chunks[1]);
+		load.chunks[1] = calloc(load.nchunks[0], sizeof(DIMACS_CHUNK));
+		if(!load.chunks[1]) {
+			fprintf(stderr, "Unable to alloc chunks.\n");
+			status = -1;
+			goto TERMINATE;
+		}
+		load.nchunks[1] = load.nchunks[0];
+
+		for(j = 0; j < load.nchunks[0]; j++) {
+			DIMACS_CHUNK * chunk = &load.chunks[1][j];
+			chunk->begin = load.splits[j];
+			chunk->end = j + 1 < load.nchunks[0] ? load.splits[j + 1] : load.files[1].size;
+			chunk->first = load.chunks[0][j].first;
+			chunk->arcs = load.chunks[0][j].arcs;
+			chunk->error = SIZE_MAX;
+		}
+	}
+
+	status = run_phase(&load, DIMACS_PARSE, load.nchunks[0], nthreads);
+	if(!status) status = report_errors(&load);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	if(load.nfiles == 2) {
+		for(j = 0; j < load.topo->nnodes; j++) {
+			if(load.supply2[j] != load.topo->supply[j]) {
+				fprintf(stderr, "Node %d has supply %lf in %s and %lf in %s.\n", j + 1,
+				        load.topo->supply[j], net_file1, load.supply2[j], net_file2);
+				status = -1;
+				goto TERMINATE;
+			}
+		}
+	}
+
+	*topo_p = load.topo;
+	*costs1_p = load.costs[0];
+	if(costs2_p) {
+		*costs2_p = load.costs[1];
+	}
+	load.topo = NULL;
+	load.costs[0] = load.costs[1] = NULL;
+
+
+TERMINATE:
+
+	for(f = 0; f < 2; f++) {
+		unmap_file(&load.files[f]);
+		free(load.chunks[f]);
+		free(load.costs[f]);
+	}
+	free_topology(&load.topo);
+	free(load.supply2);
+	free(load.splits);
+	pthread_mutex_destroy(&load.lock);
+
+	return status;
+}
+
+
+/** Function: map_file
+ ** Maps the whole file at path into memory, read only.
+ **/
+static int map_file(DIMACS_FILE * file, const char * path)
+{
+	struct stat st;
+	void * data;
+	int fd;
+
+	file->path = path;
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0) {
+		fprintf(stderr, "Unable to open network %s.\n", path);
+		return -1;
+	}
+
+	if(fstat(fd, &st) || st.st_size == 0) {
+		fprintf(stderr, "Network %s is empty.\n", path);
+		close(fd);
+		return -1;
+	}
+
+	data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED) {
+		fprintf(stderr, "Unable to map network %s.\n", path);
+		return -1;
+	}
+
+	/* every chunk is read at once, the kernel may read ahead everywhere */
+	madvise(data, st.st_size, MADV_WILLNEED);
+
+	file->data = data;
+	file->size = st.st_size;
+
+	return 0;
+}
+
+
+/** Function: unmap_file
+ ** Unmaps a file mapped by map_file().
+ **/
+static void unmap_file(DIMACS_FILE * file)
+{
+	if(file->data) {
+		munmap((void *) file->data, file->size);
+		file->data = NULL;
+	}
+}
+
+
+/** Function: read_header
+ ** Reads the problem line "p min NODES ARCS", which must come before any
+ ** node or arc line, and sets the start of the body after it.
+ **/
+static int read_header(DIMACS_FILE * file)
+{
+	size_t pos = 0, end;
+	const char * p;
+	const char * eol;
+	long nnodes, narcs;
+
+	while(pos < file->size) {
+		end = line_end(file, pos, file->size);
+		p = skip_blanks(file->data + pos, file->data + end);
+		eol = file->data + end;
+
+		if(p == eol || *p == 'c') {
+			pos = end + 1;
+			continue;
+		}
+
+		if(*p != 'p') {
+			break;
+		}
+
+		p = skip_blanks(p + 1, eol);
+		if(eol - p < 3 || strncmp(p, "min", 3)) {
+			fprintf(stderr, "%s:%ld: only min problems are read.\n", file->path, line_number(file, pos));
+			return -1;
+		}
+		p += 3;
+
+		if(parse_long(&p, eol, &nnodes) || parse_long(&p, eol, &narcs) || skip_blanks(p, eol) != eol ||
+		   nnodes < 1 || nnodes > INT32_MAX || narcs < 0 || narcs > INT32_MAX) {
+			fprintf(stderr, "%s:%ld: malformed problem line.\n", file->path, line_number(file, pos));
+			return -1;
+		}
+
+		file->nnodes = (int) nnodes;
+		file->narcs = narcs;
+		file->body = end + 1 < file->size ? end + 1 : file->size;
+
+		return 0;
+	}
+
+	fprintf(stderr, "%s:%ld: problem line expected.\n", file->path, line_number(file, pos));
+
+	return -1;
+}
+
+
+/** Function: make_chunks
+ ** Splits the body of the file into chunks of whole lines, about
+ ** DIMACS_CHUNKS_PER_THREAD per thread but none below DIMACS_MIN_CHUNK.
+ **/
+static int make_chunks(const DIMACS_FILE * file, int nthreads, DIMACS_CHUNK ** chunks_p, int * nchunks_p)
+{
+	size_t length = file->size - file->body;
+	size_t pos = file->body;
+	size_t step;
+	DIMACS_CHUNK * chunks;
+	int n = nthreads * DIMACS_CHUNKS_PER_THREAD;
+	int j;
+
+	if((size_t) n > length / DIMACS_MIN_CHUNK + 1) {
+		n = (int) (length / DIMACS_MIN_CHUNK + 1);
+	}
+	step = length / n + 1;
+
+	chunks = calloc(n, sizeof(DIMACS_CHUNK));
+	if(!chunks) {
+		fprintf(stderr, "Unable to alloc chunks.\n");
+		return -1;
+	}
+
+	for(j = 0; j < n; j++) {
+		chunks[j].begin = pos;
+		pos = pos + step < file->size ? line_end(file, pos + step, file->size) + 1 : file->size;
+		if(pos > file->size) {
+			pos = file->size;
+		}
+		chunks[j].end = pos;
+		chunks[j].error = SIZE_MAX;
+	}
+
+	*chunks_p = chunks;
+	*nchunks_p = n;
+
+	return 0;
+}
+
+
+/** Function: run_phase
+ ** Runs the ntasks tasks of a phase on nthreads threads and waits for them.
+ ** With a single thread the tasks run on the calling one.
+ **/
+static int run_phase(DIMACS_LOAD * load, int phase, int ntasks, int nthreads)
+{
+	pthread_t * threads = NULL;
+	int started = 0;
+	int i;
+
+	load->phase = phase;
+	load->next = 0;
+	load->ntasks = ntasks;
+
+	if(nthreads > ntasks) {
+		nthreads = ntasks;
+	}
+
+	if(nthreads > 1) {
+		threads = malloc(nthreads * sizeof(pthread_t));
+	}
+
+	if(threads) {
+		for(started = 0; started < nthreads; started++) {
+			if(pthread_create(&threads[started], NULL, run_thread, load)) {
+				break;
+			}
+		}
+	}
+
+	/* the calling thread takes whatever the threads it couldn't start left */
+	if(!started) {
+		run_thread(load);
+	}
+
+	for(i = 0; i < started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+
+	return 0;
+}
+
+
+/** Function: run_thread
+ ** Thread body: runs the next task of the current phase until none is left.
+ **/
+static void * run_thread(void * arg)
+{
+	DIMACS_LOAD * load = arg;
+	int task;
+
+	for(;;) {
+		pthread_mutex_lock(&load->lock);
+		task = load->next < load->ntasks ? load->next++ : -1;
+		pthread_mutex_unlock(&load->lock);
+
+		if(task < 0) {
+			break;
+		}
+
+		switch(load->phase) {
+		case DIMACS_COUNT:
+			if(task < load->nchunks[0]) {
+				count_chunk(&load->files[0], &load->chunks[0][task]);
+			} else {
+				count_chunk(&load->files[1], &load->chunks[1][task - load->nchunks[0]]);
+			}
+			break;
+		case DIMACS_ALIGN:
+			load->splits[task] = task ? locate_arc(load, load->chunks[0][task].first) : load->files[1].body;
+			break;
+		case DIMACS_PARSE:
+			parse_chunk(load, 0, task);
+			if(load->nfiles == 2) {
+				parse_chunk(load, 1, task);
+			}
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+
+/** Function: count_chunk
+ ** Counts the arc lines of the chunk.
+ **/
+static void count_chunk(const DIMACS_FILE * file, DIMACS_CHUNK * chunk)
+{
+	size_t pos = chunk->begin, end;
+
+	chunk->arcs = 0;
+	while(pos < chunk->end) {
+		end = line_end(file, pos, chunk->end);
+		chunk->arcs += arc_line(file->data + pos, file->data + end);
+		pos = end + 1;
+	}
+}
+
+
+/** Function: locate_arc
+ ** Returns the offset in the second file of the line of the given arc, or
+ ** the end of the file past its last arc.
+ **/
+static size_t locate_arc(const DIMACS_LOAD * load, long arc)
+{
+	const DIMACS_FILE * file = &load->files[1];
+	const DIMACS_CHUNK * chunks = load->chunks[1];
+	int lo = 0, hi = load->nchunks[1] - 1, mid;
+	size_t pos, end;
+	long seen;
+
+	/* last chunk starting at or before the arc */
+	while(lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if(chunks[mid].first <= arc) {
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	seen = chunks[lo].first;
+	for(pos = chunks[lo].begin; pos < file->size; pos = end + 1) {
+		end = line_end(file, pos, file->size);
+		if(arc_line(file->data + pos, file->data + end)) {
+			if(seen == arc) {
+				return pos;
+			}
+			seen++;
+		}
+	}
+
+	return file->size;
+}
+
+
+/** Function: parse_chunk
+ ** Parses the chunk j of file f. Node lines set the supplies; arc lines of
+ ** the first file are written to the topology and costs, while those of the
+ ** second one are checked against them and only give their cost. Parsing
+ ** stops at the first malformed line, which is recorded in the chunk.
+ **/
+static void parse_chunk(DIMACS_LOAD * load, int f, int j)
+{
+	const DIMACS_FILE * file = &load->files[f];
+	DIMACS_CHUNK * chunk = &load->chunks[f][j];
+	NET_TOPOLOGY * topo = load->topo;
+	double * costs = load->costs[f];
+	long arc = chunk->first;
+	size_t pos = chunk->begin, end;
+	const char * p;
+	const char * eol;
+	const char * message;
+	long tail, head, node;
+	double lb, ub, cost, supply;
+
+	for(; pos < chunk->end; pos = end + 1) {
+		end = line_end(file, pos, chunk->end);
+		eol = file->data + end;
+		p = skip_blanks(file->data + pos, eol);
+		message = NULL;
+
+		if(p == eol || *p == 'c') {
+			continue;
+		}
+
+		switch(*p++) {
+		case 'n':
+			if(parse_long(&p, eol, &node) || parse_double(&p, eol, &supply) || skip_blanks(p, eol) != eol) {
+				message = "malformed node line";
+			} else if(node < 1 || node > topo->nnodes) {
+				message = "node out of range";
+			} else if(f) {
+				load->supply2[node - 1] = supply;
+			} else {
+				topo->supply[node - 1] = supply;
+			}
+			break;
+
+		case 'a':
+			if(parse_long(&p, eol, &tail) || parse_long(&p, eol, &head) || parse_double(&p, eol, &lb) ||
+			   parse_double(&p, eol, &ub) || parse_double(&p, eol, &cost) || skip_blanks(p, eol) != eol) {
+				message = "malformed arc line";
+			} else if(tail < 1 || tail > topo->nnodes || head < 1 || head > topo->nnodes) {
+				message = "arc node out of range";
+			} else if(f) {
+				if(topo->tail[arc] != tail - 1 || topo->head[arc] != head - 1 ||
+				   topo->lb[arc] != lb || topo->ub[arc] != ub) {
+					message = "arc differs from the first network";
+				}
+			} else {
+				topo->tail[arc] = (int) (tail - 1);
+				topo->head[arc] = (int) (head - 1);
+				topo->lb[arc] = lb;
+				topo->ub[arc] = ub;
+			}
+			if(!message) {
+				costs[arc++] = cost;
+			}
+			break;
+
+		case 'p':
+			message = "second problem line";
+			break;
+
+		default:
+			message = "unknown line type";
+			break;
+		}
+
+		if(message) {
+			chunk->error = pos;
+			chunk->message = message;
+			return;
+		}
+	}
+}
+
+
+/** Function: report_errors
+ ** Prints the malformed lines found by the parse, first file first and in
+ ** file order. Returns a non-zero value if there is any.
+ **/
+static int report_errors(const DIMACS_LOAD * load)
+{
+	int errors = 0;
+	int f, j;
+
+	for(f = 0; f < load->nfiles; f++) {
+		for(j = 0; j < load->nchunks[f]; j++) {
+			const DIMACS_CHUNK * chunk = &load->chunks[f][j];
+			if(chunk->error != SIZE_MAX) {
+				fprintf(stderr, "%s:%ld: %s.\n", load->files[f].path,
+				        line_number(&load->files[f], chunk->error), chunk->message);
+				errors++;
+			}
+		}
+	}
+
+	return errors ? -1 : 0;
+}
+
+
+/** Function: line_end
+ ** Returns the offset of the newline ending the line that starts at pos, or
+ ** limit if there is none before it.
+ **/
+static size_t line_end(const DIMACS_FILE * file, size_t pos, size_t limit)
+{
+	const char * nl = memchr(file->data + pos, '\n', limit - pos);
+
+	return nl ? (size_t) (nl - file->data) : limit;
+}
+
+
+/** Function: skip_blanks
+ ** Returns the first character of [p, end) that is not a blank.
+ **/
+static const char * skip_blanks(const char * p, const char * end)
+{
+	while(p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+		p++;
+	}
+
+	return p;
+}
+
+
+/** Function: arc_line
+ ** Returns 1 if the line [p, end) is an arc line.
+ **/
+static int arc_line(const char * p, const char * end)
+{
+	p = skip_blanks(p, end);
+
+	return p < end && *p == 'a';
+}
+
+
+/** Function: parse_long
+ ** Reads the integer at *p, after any blanks, and moves *p past it.
+ **/
+static int parse_long(const char ** p_ptr, const char * end, long * value)
+{
+	const char * p = skip_blanks(*p_ptr, end);
+	long v = 0;
+	int negative = 0;
+	const char * digits;
+
+	if(p < end && (*p == '-' || *p == '+')) {
+		negative = *p++ == '-';
+	}
+
+	digits = p;
+	while(p < end && *p >= '0' && *p <= '9') {
+		v = 10 * v + (*p++ - '0');
+	}
+
+	if(p == digits || p - digits > 18 || (p < end && *p != ' ' && *p != '\t' && *p != '\r')) {
+		return -1;
+	}
+
+	*value = negative ? -v : v;
+	*p_ptr = p;
+
+	return 0;
+}
+
+
+/** Function: parse_double
+ ** Reads the number at *p, after any blanks, and moves *p past it. Plain
+ ** integers, the usual case, skip strtod().
+ **/
+static int parse_double(const char ** p_ptr, const char * end, double * value)
+{
+	char token[DIMACS_MAX_TOKEN];
+	const char * p = skip_blanks(*p_ptr, end);
+	const char * q = p;
+	char * stop;
+	long v;
+
+	if(!parse_long(&q, end, &v)) {
+		*value = (double) v;
+		*p_ptr = q;
+		return 0;
+	}
+
+	q = p;
+	while(q < end && *q != ' ' && *q != '\t' && *q != '\r') {
+		q++;
+	}
+	if(q == p || q - p >= DIMACS_MAX_TOKEN) {
+		return -1;
+	}
+
+	/* the map is not NUL terminated, strtod() reads a copy */
+	memcpy(token, p, q - p);
+	token[q - p] = '\0';
+	*value = strtod(token, &stop);
+	if(*stop) {
+		return -1;
+	}
+
+	*p_ptr = q;
+
+	return 0;
+}
+
+
+/** Function: line_number
+ ** Returns the number, from 1, of the line holding the offset.
+ **/
+static long line_number(const DIMACS_FILE * file, size_t offset)
+{
+	const char * p = file->data;
+	const char * end = file->data + (offset < file->size ? offset : file->size);
+	long line = 1;
+
+	while((p = memchr(p, '\n', end - p))) {
+		line++;
+		p++;
+	}
+
+	return line;
+}
@@ -0,0 +1,213 @@
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "frontier.h"
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int compare_points(const void *, const void *);
+static double breakpoint(const FRONTIER_POINT *, const FRONTIER_POINT *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: create_frontier
+ ** Allocates an empty frontier. Returns NULL if the allocation fails.
+ **/
+FRONTIER * create_frontier(void)
+{
+	FRONTIER * frontier = calloc(1, sizeof(FRONTIER));
+	if(!frontier) {
+		fprintf(stderr, "Unable to alloc frontier.\n");
+		return NULL;
+	}
+
+	return frontier;
+}
+
+
+/** Function: free_frontier
+ ** Frees the frontier and its points and sets the pointer to NULL.
+ **/
+void free_frontier(FRONTIER ** frontier)
+{
+	if(frontier && *frontier) {
+		free((*frontier)->points);
+		free(*frontier);
+		*frontier = NULL;
+	}
+}
+
+
+/** Function: frontier_add
+ ** Appends the point (obj1, obj2) found at the given iteration after pivoting
+ ** the given arc. The array of points doubles its size when full. Returns a
+ ** non-zero value if the memory could not be alloc'd.
+ **/
+int frontier_add(FRONTIER * frontier, double obj1, double obj2, int iteration, int arc)
+{
+	FRONTIER_POINT * point;
+
+	if(!frontier) {
+		return -1;
+	}
+
+	if(frontier->npoints == frontier->capacity) {
+		int capacity = frontier->capacity ? 2 * frontier->capacity : 64;
+		FRONTIER_POINT * points = realloc(frontier->points, capacity * sizeof(FRONTIER_POINT));
+		if(!points) {
+			fprintf(stderr, "Unable to grow frontier to %d points.\n", capacity);
+			return -1;
+		}
+
+		frontier->points = points;
+		frontier->capacity = capacity;
+	}
+
+	point = &frontier->points[frontier->npoints++];
+	point->obj1 = obj1;
+	point->obj2 = obj2;
+	point->lambda_lo = 0.0;
+	point->lambda_hi = 1.0;
+	point->iteration = iteration;
+	point->arc = arc;
+
+	return 0;
+}
+
+
+/** Function: frontier_record
+ ** Iteration callback that appends the objective pair of every new basis to
+ ** the FRONTIER passed as callback data.
+ **/
+int frontier_record(const SOLVER_ITERATION * it, void * data)
+{
+	return frontier_add((FRONTIER *) data, it->solution1->objval, it->solution2->objval,
+	                    it->iteration, it->arc);
+}
+
+
+/** Function: frontier_finalize
+ ** Sorts the points by decreasing objective 2 value, removes repeated points
+ ** left by degenerate pivots and computes the weight interval of each point.
+ ** The weight at which two adjacent extreme points a and b are both optimal
+ ** follows from w*z1(a) + (1 - w)*z2(a) = w*z1(b) + (1 - w)*z2(b).
+ **/
+void frontier_finalize(FRONTIER * frontier)
+{
+	int i, n;
+
+	if(!frontier || frontier->npoints == 0) {
+		return;
+	}
+
+	qsort(frontier->points, frontier->npoints, sizeof(FRONTIER_POINT), compare_points);
+
+	n = 1;
+	for(i = 1; i < frontier->npoints; i++) {
+		FRONTIER_POINT * last = &frontier->points[n - 1];
+		FRONTIER_POINT * point = &frontier->points[i];
+
+		if(fabs(point->obj1 - last->obj1) <= FRONTIER_TOL && fabs(point->obj2 - last->obj2) <= FRONTIER_TOL) {
+			continue;
+		}
+
+		frontier->points[n++] = *point;
+	}
+	frontier->npoints = n;
+
+	frontier->points[0].lambda_hi = 1.0;
+	for(i = 1; i < n; i++) {
+		double w = breakpoint(&frontier->points[i - 1], &frontier->points[i]);
+		frontier->points[i - 1].lambda_lo = w;
+		frontier->points[i].lambda_hi = w;
+	}
+	frontier->points[n - 1].lambda_lo = 0.0;
+}
+
+
+/** Function: print_frontier
+ ** Prints one line per point of the frontier to the standard output stream.
+ **/
+void print_frontier(const FRONTIER * frontier)
+{
+	fprint_frontier(stdout, frontier);
+}
+
+
+/** Function: fprint_frontier
+ ** Prints one line per point of the frontier to the given stream.
+ **/
+void fprint_frontier(FILE * out, const FRONTIER * frontier)
+{
+	int i;
+
+	if(!frontier || !out) {
+		return;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Frontier Data (%d points):\n\n", frontier->npoints);
+
+	for(i = 0; i < frontier->npoints; i++) {
+		const FRONTIER_POINT * p = &frontier->points[i];
+		fprintf(out, "Point %d\tz1: %lf\tz2: %lf\tweight: [%lf, %lf]\n", i, p->obj1, p->obj2, p->lambda_lo, p->lambda_hi);
+	}
+
+	fprintf(out, "\n");
+}
+
+
+/** Function: compare_points
+ ** qsort comparison: decreasing objective 2 value, ties broken by increasing
+ ** objective 1 value.
+ **/
+static int compare_points(const void * a, const void * b)
+{
+	const FRONTIER_POINT * pa = a;
+	const FRONTIER_POINT * pb = b;
+
+	if(pa->obj2 > pb->obj2) return -1;
+	if(pa->obj2 < pb->obj2) return 1;
+	if(pa->obj1 < pb->obj1) return -1;
+	if(pa->obj1 > pb->obj1) return 1;
+
+	return 0;
+}
+
+
+/** Function: breakpoint
+ ** Returns the weight of objective 1 at which the points a and b have the same
+ ** weighted objective value, clamped to [0, 1].
+ **/
+static double breakpoint(const FRONTIER_POINT * a, const FRONTIER_POINT * b)
+{
+	double d1 = b->obj1 - a->obj1;
+	double d2 = b->obj2 - a->obj2;
+	double w;
+
+	if(fabs(d2 - d1) <= FRONTIER_TOL) {
+		return 0.0;
+	}
+
+	w = d2 / (d2 - d1);
+
+	if(w < 0.0) return 0.0;
+	if(w > 1.0) return 1.0;
+
+	return w;
+}
@@ -0,0 +1,505 @@
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+#include "frontier.h"
+#include "reduce.h"
+#include "frontindex.h"
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static void free_index_writer(INDEX_WRITER *);
+static uint64_t record_offset(const INDEX_WRITER *, int);
+static void fprint_entry(FILE *, const FRONTIER_INDEX *, int);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: open_index_writer
+ ** Creates the index file at path for the walk of the loaded context and
+ ** leaves room for its header. Every iteration reported to index_record() is
+ ** handed on to next with next_data. Returns NULL on error.
+ **/
+INDEX_WRITER * open_index_writer(const char * path, const SOLVER_CTX * ctx, SOLVER_CALLBACK next, void * next_data)
+{
+	INDEX_HEADER header;
+	INDEX_WRITER * writer;
+
+	if(!ctx || !ctx->narcs) {
+		return NULL;
+	}
+
+	writer = calloc(1, sizeof(INDEX_WRITER));
+	if(!writer) {
+		fprintf(stderr, "Unable to alloc frontier index.\n");
+		return NULL;
+	}
+
+	writer->narcs = ctx->narcs;
+	writer->next = next;
+	writer->next_data = next_data;
+
+	/* the flows are kept for the arcs of the original network */
+	if(ctx->reduction) {
+		writer->reduction = ctx->reduction;
+		writer->narcs = ctx->reduction->orig_narcs;
+		writer->slot_flow = malloc(ctx->reduction->nslots * sizeof(double));
+		writer->orig_flow = malloc(ctx->reduction->orig_narcs * sizeof(double));
+		if(!writer->slot_flow || !writer->orig_flow) {
+			fprintf(stderr, "Unable to alloc frontier index flows.\n");
+			free_index_writer(writer);
+			return NULL;
+		}
+	}
+
+	writer->frontier = create_frontier();
+	if(!writer->frontier) {
+		free_index_writer(writer);
+		return NULL;
+	}
+
+	writer->fp = fopen(path, "wb");
+	if(!writer->fp) {
+		fprintf(stderr, "Unable to create frontier index %s.\n", path);
+		free_index_writer(writer);
+		return NULL;
+	}
+
+	/* the header is written again once the table is placed */
+	memset(&header, 0, sizeof(INDEX_HEADER));
+	if(fwrite(&header, sizeof(INDEX_HEADER), 1, writer->fp) != 1) {
+		fprintf(stderr, "Unable to write frontier index header.\n");
+		free_index_writer(writer);
+		return NULL;
+	}
+	writer->end = sizeof(INDEX_HEADER);
+
+	return writer;
+}
+
+
+/** Function: index_record
+ ** Iteration callback that appends the flow of the reported point to the
+ ** index file, keeps its objective pair and offset and hands the iteration on
+ ** to the next callback. A write error stops the walk.
+ **/
+int index_record(const SOLVER_ITERATION * it, void * data)
+{
+	INDEX_WRITER * writer = data;
+	const double * flow = it->solution1->x;
+
+	if(writer->nrecords == writer->capacity) {
+		int capacity = writer->capacity ? 2 * writer->capacity : 64;
+		int * iterations = realloc(writer->iterations, capacity * sizeof(int));
+		uint64_t * offsets = iterations ? realloc(writer->offsets, capacity * sizeof(uint64_t)) : NULL;
+
+		if(iterations) {
+			writer->iterations = iterations;
+		}
+		if(!offsets) {
+			fprintf(stderr, "Unable to grow frontier index to %d points.\n", capacity);
+			return -1;
+		}
+		writer->offsets = offsets;
+		writer->capacity = capacity;
+	}
+
+	if(writer->reduction) {
+		expand_flow(writer->reduction, it->solution1->x, writer->slot_flow, writer->orig_flow);
+		flow = writer->orig_flow;
+	}
+
+	if(fwrite(flow, sizeof(double), writer->narcs, writer->fp) != (size_t) writer->narcs ||
+	   frontier_add(writer->frontier, it->solution1->objval, it->solution2->objval, it->iteration, it->arc)) {
+		fprintf(stderr, "Unable to add iteration %d to the frontier index.\n", it->iteration);
+		return -1;
+	}
+
+	writer->iterations[writer->nrecords] = it->iteration;
+	writer->offsets[writer->nrecords] = writer->end;
+	writer->nrecords++;
+	writer->end += (uint64_t) writer->narcs * sizeof(double);
+
+	return writer->next ? writer->next(it, writer->next_data) : 0;
+}
+
+
+/** Function: close_index_writer
+ ** Sorts the recorded points by increasing objective 2 value, drops the
+ ** repeated ones, computes their weight intervals, writes the table and the
+ ** header and closes the file. Returns a non-zero value if the index could
+ ** not be completed.
+ **/
+int close_index_writer(INDEX_WRITER ** writer_p)
+{
+	INDEX_WRITER * writer;
+	INDEX_HEADER header;
+	INDEX_ENTRY entry;
+	int status = 0;
+	int i;
+
+	if(!writer_p || !*writer_p) {
+		return 0;
+	}
+
+	writer = *writer_p;
+
+	frontier_finalize(writer->frontier);
+
+	/* the frontier comes sorted by decreasing objective 2 value */
+	memset(&entry, 0, sizeof(INDEX_ENTRY));
+	for(i = writer->frontier->npoints - 1; i >= 0 && !status; i--) {
+		const FRONTIER_POINT * point = &writer->frontier->points[i];
+
+		entry.obj1 = point->obj1;
+		entry.obj2 = point->obj2;
+		entry.lambda_lo = point->lambda_lo;
+		entry.lambda_hi = point->lambda_hi;
+		entry.flow = record_offset(writer, point->iteration);
+		entry.iteration = point->iteration;
+
+		if(fwrite(&entry, sizeof(INDEX_ENTRY), 1, writer->fp) != 1) {
+			status = -1;
+		}
+	}
+
+	memset(&header, 0, sizeof(INDEX_HEADER));
+	header.magic = INDEX_MAGIC;
+	header.version = INDEX_VERSION;
+	header.narcs = writer->narcs;
+	header.count = writer->frontier->npoints;
+	header.table = writer->end;
+
+	if(status || fseek(writer->fp, 0, SEEK_SET) || fwrite(&header, sizeof(INDEX_HEADER), 1, writer->fp) != 1) {
+		status = -1;
+	}
+
+	if(fclose(writer->fp)) {
+		status = -1;
+	}
+	writer->fp = NULL;
+
+	if(status) {
+		fprintf(stderr, "Unable to write the frontier index.\n");
+	}
+
+	free_index_writer(writer);
+	*writer_p = NULL;
+
+	return status;
+}
+
+
+/** Function: open_frontier_index
+ ** Maps the index file at path read-only and checks its header and table.
+ ** Returns NULL if the file can't be mapped or isn't a frontier index of
+ ** this version.
+ **/
+FRONTIER_INDEX * open_frontier_index(const char * path)
+{
+	FRONTIER_INDEX * index = NULL;
+	const INDEX_HEADER * header;
+	struct stat st;
+	void * map;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0) {
+		fprintf(stderr, "Unable to open frontier index %s.\n", path);
+		return NULL;
+	}
+
+	if(fstat(fd, &st) || (size_t) st.st_size < sizeof(INDEX_HEADER)) {
+		fprintf(stderr, "%s is not a frontier index.\n", path);
+		close(fd);
+		return NULL;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED) {
+		fprintf(stderr, "Unable to map frontier index %s.\n", path);
+		return NULL;
+	}
+
+	header = map;
+	if(header->magic != INDEX_MAGIC || header->version != INDEX_VERSION || header->count < 0 ||
+	   header->narcs < 0 || header->table % sizeof(double) ||
+	   header->table > (uint64_t) st.st_size ||
+	   (uint64_t) header->count * sizeof(INDEX_ENTRY) > (uint64_t) st.st_size - header->table) {
+		fprintf(stderr, "%s is not a frontier index.\n", path);
+		munmap(map, st.st_size);
+		return NULL;
+	}
+
+	index = calloc(1, sizeof(FRONTIER_INDEX));
+	if(!index) {
+		fprintf(stderr, "Unable to alloc frontier index.\n");
+		munmap(map, st.st_size);
+		return NULL;
+	}
+
+	index->map = map;
+	index->size = st.st_size;
+	index->header = header;
+	index->entries = (const INDEX_ENTRY *) (index->map + header->table);
+	index->count = header->count;
+	index->narcs = header->narcs;
+
+	return index;
+}
+
+
+/** Function: close_frontier_index
+ ** Unmaps the index file and frees the object.
+ **/
+void close_frontier_index(FRONTIER_INDEX ** index_p)
+{
+	if(!index_p || !*index_p) {
+		return;
+	}
+
+	munmap((void *) (*index_p)->map, (*index_p)->size);
+	free(*index_p);
+	*index_p = NULL;
+}
+
+
+/** Function: index_budget
+ ** Returns the position of the point with the least objective 1 value among
+ ** those whose objective 2 value is at most budget, which is the last one of
+ ** them in the table, or -1 if there is none.
+ **/
+int index_budget(const FRONTIER_INDEX * index, double budget)
+{
+	int lo = 0, hi = index->count;
+
+	/* first entry over the budget */
+	while(lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+
+		if(index->entries[mid].obj2 <= budget) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo - 1;
+}
+
+
+/** Function: index_weight
+ ** Returns the position of a point minimizing w*z1 + (1 - w)*z2, the first
+ ** one whose weight interval reaches w, or -1 if the index is empty.
+ **/
+int index_weight(const FRONTIER_INDEX * index, double w)
+{
+	int lo = 0, hi = index->count - 1;
+
+	if(index->count == 0) {
+		return -1;
+	}
+
+	while(lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+
+		if(index->entries[mid].lambda_hi < w) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+
+/** Function: index_budget_bound
+ ** Returns the least objective 1 value of a flow whose objective 2 value is
+ ** at most budget: between two adjacent points the frontier is the segment
+ ** of their convex combinations. Returns HUGE_VAL if no point is within the
+ ** budget.
+ **/
+double index_budget_bound(const FRONTIER_INDEX * index, double budget)
+{
+	const INDEX_ENTRY * a;
+	const INDEX_ENTRY * b;
+	int k = index_budget(index, budget);
+
+	if(k < 0) {
+		return HUGE_VAL;
+	}
+
+	if(k == index->count - 1) {
+		return index->entries[k].obj1;
+	}
+
+	a = &index->entries[k];
+	b = &index->entries[k + 1];
+
+	return a->obj1 + (budget - a->obj2) / (b->obj2 - a->obj2) * (b->obj1 - a->obj1);
+}
+
+
+/** Function: index_flow
+ ** Returns the flow of the point at position k, narcs values mapped from the
+ ** file, or NULL if k or its offset are out of range.
+ **/
+const double * index_flow(const FRONTIER_INDEX * index, int k)
+{
+	uint64_t offset;
+
+	if(k < 0 || k >= index->count) {
+		return NULL;
+	}
+
+	offset = index->entries[k].flow;
+	if(offset % sizeof(double) || offset > index->size ||
+	   (uint64_t) index->narcs * sizeof(double) > index->size - offset) {
+		return NULL;
+	}
+
+	return (const double *) (index->map + offset);
+}
+
+
+/** Function: index_query
+ ** Answers one query given as text and prints the result to out:
+ **	- budget=B, the point of least objective 1 value with objective 2 at
+ **	  most B and the least objective 1 value reachable within B;
+ **	- weight=W, the point minimizing W*z1 + (1 - W)*z2;
+ **	- point=K, the point at position K and its flow.
+ ** Returns a non-zero value if the query can't be parsed.
+ **/
+int index_query(const FRONTIER_INDEX * index, const char * query, FILE * out)
+{
+	const char * arg = strchr(query, '=');
+	const double * flow;
+	double value;
+	char * end;
+	int k, i;
+
+	if(!arg || arg[1] == '\0') {
+		fprintf(stderr, "Invalid query %s.\n", query);
+		return -1;
+	}
+
+	value = strtod(arg + 1, &end);
+	if(*end) {
+		fprintf(stderr, "Invalid query %s.\n", query);
+		return -1;
+	}
+
+	if(!strncmp(query, "budget=", 7)) {
+		k = index_budget(index, value);
+		fprintf(out, "budget %lf: ", value);
+		if(k < 0) {
+			fprintf(out, "no point\n");
+			return 0;
+		}
+		fprint_entry(out, index, k);
+		fprintf(out, "\tbound: %lf\n", index_budget_bound(index, value));
+		return 0;
+	}
+
+	if(!strncmp(query, "weight=", 7)) {
+		k = index_weight(index, value);
+		fprintf(out, "weight %lf: ", value);
+		if(k < 0) {
+			fprintf(out, "no point\n");
+			return 0;
+		}
+		fprint_entry(out, index, k);
+		fprintf(out, "\n");
+		return 0;
+	}
+
+	if(!strncmp(query, "point=", 6) && value == (int) value) {
+		k = (int) value;
+		flow = index_flow(index, k);
+		if(!flow) {
+			fprintf(stderr, "Index holds %d points.\n", index->count);
+			return -1;
+		}
+		fprint_entry(out, index, k);
+		fprintf(out, "\n");
+		for(i = 0; i < index->narcs; i++) {
+			fprintf(out, "Arc %d: %lf\n", i, flow[i]);
+		}
+		return 0;
+	}
+
+	fprintf(stderr, "Invalid query %s.\n", query);
+	return -1;
+}
+
+
+/** Function: fprint_entry
+ ** Prints the point at position k, without a line break.
+ **/
+static void fprint_entry(FILE * out, const FRONTIER_INDEX * index, int k)
+{
+	const INDEX_ENTRY * e = &index->entries[k];
+
+	fprintf(out, "Point %d\tz1: %lf\tz2: %lf\tweight: [%lf, %lf]", k, e->obj1, e->obj2, e->lambda_lo, e->lambda_hi);
+}
+
+
+/** Function: record_offset
+ ** Returns the offset of the flow recorded at the given iteration. Iterations
+ ** increase along a walk, so the records are searched by bisection.
+ **/
+static uint64_t record_offset(const INDEX_WRITER * writer, int iteration)
+{
+	int lo = 0, hi = writer->nrecords - 1;
+
+	while(lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+
+		if(writer->iterations[mid] < iteration) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return writer->offsets[lo];
+}
+
+
+/** Function: free_index_writer
+ ** Closes the file if still open and frees the writer.
+ **/
+static void free_index_writer(INDEX_WRITER * writer)
+{
+	if(writer->fp) {
+		fclose(writer->fp);
+	}
+
+	free_frontier(&writer->frontier);
+	free(writer->iterations);
+	free(writer->offsets);
+	free(writer->slot_flow);
+	free(writer->orig_flow);
+	free(writer);
+}
@@ -0,0 +1,248 @@
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "hugepage.h"
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** Every block handed out by mem_alloc() starts with a MEM_HEADER telling
+ ** mem_free() how it was obtained. The header is a cache line long so the
+ ** array itself keeps a 64 byte alignment.
+ **/
+typedef struct mem_header_struct {
+	size_t length;
+	int kind;
+	char pad[64 - sizeof(size_t) - sizeof(int)];
+} MEM_HEADER;
+
+/*** How a block was obtained ***/
+#define MEM_KIND_PLAIN   0
+#define MEM_KIND_THP     1
+#define MEM_KIND_HUGETLB 2
+
+
+
+
+/************************
+ *** Global Variables ***
+ ************************/
+
+/** The policy is set once at start up, before any thread allocates, while the
+ ** counters are updated by every thread that creates solutions.
+ **/
+static int policy = MEM_DEFAULT;
+static atomic_ulong bytes[3];
+static atomic_ulong fallbacks;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static void * alloc_thp(size_t, int *);
+static int thp_mode(void);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: mem_set_policy
+ ** Chooses the allocation policy of the arrays created from now on.
+ **/
+void mem_set_policy(int p)
+{
+	policy = (p == MEM_THP || p == MEM_HUGETLB) ? p : MEM_DEFAULT;
+}
+
+
+/** Function: mem_policy
+ ** Returns the policy with the given name, or -1 if there is none.
+ **/
+int mem_policy(const char * name)
+{
+	if(!name) {
+		return -1;
+	}
+
+	if(!strcmp(name, "default")) return MEM_DEFAULT;
+	if(!strcmp(name, "thp")) return MEM_THP;
+	if(!strcmp(name, "hugetlb")) return MEM_HUGETLB;
+
+	return -1;
+}
+
+
+/** Function: mem_policy_name
+ ** Returns the name of the given policy.
+ **/
+const char * mem_policy_name(int p)
+{
+	switch(p) {
+	case MEM_THP:
+		return "thp";
+	case MEM_HUGETLB:
+		return "hugetlb";
+	default:
+		return "default";
+	}
+}
+
+
+/** Function: mem_alloc
+ ** Allocates size bytes following the current policy. With MEM_HUGETLB the
+ ** block is mapped from the hugetlb pool, falling back to transparent huge
+ ** pages when the pool is empty; with MEM_THP it is aligned to a huge page
+ ** and madvise() asks the kernel to back it by huge pages. Small blocks and
+ ** blocks for which every method fails come from malloc(). Returns NULL if
+ ** no memory is left. The block must be freed by mem_free().
+ **/
+void * mem_alloc(size_t size)
+{
+	MEM_HEADER * header = NULL;
+	size_t length = size + sizeof(MEM_HEADER);
+	int kind = MEM_KIND_PLAIN;
+
+	if(policy != MEM_DEFAULT && size >= MEM_HUGE_THRESHOLD) {
+		length = (length + MEM_HUGE_PAGE - 1) & ~(MEM_HUGE_PAGE - 1);
+
+		if(policy == MEM_HUGETLB) {
+			void * p = mmap(NULL, length, PROT_READ | PROT_WRITE,
+			                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if(p != MAP_FAILED) {
+				header = p;
+				kind = MEM_KIND_HUGETLB;
+			} else {
+				atomic_fetch_add(&fallbacks, 1);
+			}
+		}
+
+		if(!header) {
+			header = alloc_thp(length, &kind);
+		}
+	}
+
+	if(!header) {
+		length = size + sizeof(MEM_HEADER);
+		header = malloc(length);
+		kind = MEM_KIND_PLAIN;
+		if(!header) {
+			return NULL;
+		}
+	}
+
+	header->length = length;
+	header->kind = kind;
+	atomic_fetch_add(&bytes[kind], length);
+
+	return header + 1;
+}
+
+
+/** Function: mem_free
+ ** Frees a block returned by mem_alloc(). NULL is ignored.
+ **/
+void mem_free(void * ptr)
+{
+	MEM_HEADER * header;
+
+	if(!ptr) {
+		return;
+	}
+
+	header = (MEM_HEADER *) ptr - 1;
+	atomic_fetch_sub(&bytes[header->kind], header->length);
+
+	if(header->kind == MEM_KIND_HUGETLB) {
+		munmap(header, header->length);
+	} else {
+		free(header);
+	}
+}
+
+
+/** Function: mem_report
+ ** Prints the policy requested and the one actually applied: the bytes
+ ** currently held by each kind of block, the hugetlb requests that fell back
+ ** and the transparent huge page mode of the kernel.
+ **/
+void mem_report(FILE * out)
+{
+	static const char * modes[4] = {"unknown", "always", "madvise", "never"};
+
+	if(!out) {
+		return;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Memory Policy: %s\n\n", mem_policy_name(policy));
+	fprintf(out, "hugetlb pages:\t%lu bytes\n", (unsigned long) atomic_load(&bytes[MEM_KIND_HUGETLB]));
+	fprintf(out, "THP advised:\t%lu bytes\n", (unsigned long) atomic_load(&bytes[MEM_KIND_THP]));
+	fprintf(out, "Plain:\t\t%lu bytes\n", (unsigned long) atomic_load(&bytes[MEM_KIND_PLAIN]));
+	fprintf(out, "hugetlb fallbacks:\t%lu\n", (unsigned long) atomic_load(&fallbacks));
+	fprintf(out, "Kernel THP mode:\t%s\n", modes[thp_mode()]);
+	if(policy != MEM_DEFAULT && thp_mode() == 3) {
+		fprintf(out, "THP is disabled, advised blocks use normal pages.\n");
+	}
+	fprintf(out, "\n");
+}
+
+
+/** Function: alloc_thp
+ ** Allocates length bytes aligned to a huge page and advises the kernel to
+ ** back them by transparent huge pages. kind is set to the kind of block
+ ** obtained. Returns NULL on failure.
+ **/
+static void * alloc_thp(size_t length, int * kind)
+{
+	void * p = NULL;
+
+	if(posix_memalign(&p, MEM_HUGE_PAGE, length)) {
+		return NULL;
+	}
+
+	*kind = madvise(p, length, MADV_HUGEPAGE) ? MEM_KIND_PLAIN : MEM_KIND_THP;
+
+	return p;
+}
+
+
+/** Function: thp_mode
+ ** Returns the transparent huge page mode of the kernel: 1 always, 2
+ ** madvise, 3 never and 0 if it can't be read.
+ **/
+static int thp_mode(void)
+{
+	char line[128];
+	FILE * in = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+	int mode = 0;
+
+	if(!in) {
+		return 0;
+	}
+
+	if(fgets(line, sizeof(line), in)) {
+		if(strstr(line, "[always]")) mode = 1;
+		else if(strstr(line, "[madvise]")) mode = 2;
+		else if(strstr(line, "[never]")) mode = 3;
+	}
+
+	fclose(in);
+
+	return mode;
+}
@@ -9,73 +9,95 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-
-
-
-
-/************************ 
+#include <getopt.h>
+#include <unistd.h>
+#include <signal.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+#include "frontier.h"
+#include "bidirectional.h"
+#include "writer.h"
+#include "perfstat.h"
+#include "service.h"
+#include "batch.h"
+#include "verify.h"
+#include "hugepage.h"
+#include "weightspace.h"
+#include "archive.h"
+#include "frontindex.h"
+
+
+
+
+/************************
  *** Type Definitions ***
  ************************/
 
-/** The NET_BASIS struct is made with two arrays of specific size and holds the
- ** information of a basis associated to a given problem. The first array must
- ** have a length equal to the number of arcs and the second array must have a
- ** length equal to the number of nodes in the network problem.
- **/
-typedef struct net_basis_struct {
-	int * arc_basis;
-	int * node_basis;
-} NET_BASIS;
-
-/*** Methods to handle the NET_BASIS struct ***/
-static NET_BASIS * create_basis(int, int);
-static void free_basis(NET_BASIS **);
-
-
-/** The NET_SOLUTION struct holds all the information of a specific solution to
- ** a network problem, including the basis associated. The arrays x and dj must
- ** have a length equal to the number of arcs in the network and the arrays pi
- ** and slack must have a length equal to the number of nodes. The integer value
- ** solstat is an indicator of the status of the solution, with 1 being an
- ** optimal solution and 10 indicating the optimization was stopped due to the
- ** limit of iterations being reached.
+/** The CLI_OPTIONS struct holds the switches given on the command line and
+ ** the names of the network files, one per objective function.
  **/
-typedef struct net_sol_struct {
-	double * x;
-	double * dj;
-	double * pi;
-	double * slack;
-	double objval;
-	int solstat;
-	NET_BASIS * basis;
-} NET_SOLUTION;
-
-/*** Methods to handle the NET_SOLUTION struct ***/
-static NET_SOLUTION * create_solution(int, int);
-static void free_solution(NET_SOLUTION **);
-static void print_solution(NET_SOLUTION *, int, int);
-
-/*****************************
- *** Constants Definitions ***
- *****************************/
-static NET_SOLUTION * solution1 = NULL;
-static NET_SOLUTION * solution2 = NULL;
-static NET_SOLUTION * perturbsol = NULL;
+typedef struct cli_options_struct {
+	int bidirectional;
+	int perf_counters;
+	int reduce;
+	int load_threads;
+	int initial_engine;
+	int perturb_engine;
+	int benchmark_anchors;
+	int basis_tree;
+	const char * output;
+	const char * service;
+	const char * scenarios;
+	int threads;
+	double epsilon;
+	int max_points;
+	double time_limit;
+	int iteration_limit;
+	int verify;
+	int trace_diff;
+	const char * trace;
+	const char * replay;
+	const char * archive;
+	const char * warm_start;
+	const char * resume;
+	const char * index;
+	const char * query;
+	const char * portfolio_db;
+	int huge_pages;
+	unsigned long writer_slots;
+	const char * net_file1;
+	const char * net_file2;
+	char ** net_files;
+	int nfiles;
+} CLI_OPTIONS;
+
 
 
 
 /****************************
  *** Forward Declarations ***
  ****************************/
-static int usage(int);
-static void free_and_null(void **);
-static double objective_value(double *, double *, int);
-static int copy_cplex_problem(CPXENVptr, CPXNETptr, CPXLPptr, char *);
-static int update_solution(CPXENVptr, CPXLPptr, char *, NET_SOLUTION *, char *);
-static int entering_arc(double *, double *, int *, int);
+static int usage(int, char **, CLI_OPTIONS *);
+static int run_bidirectional(const CLI_OPTIONS *);
+static int run_weight_space(const CLI_OPTIONS *);
+static NET_BASIS * archived_basis(const char *, const SOLVER_CTX *);
+static int run_query(const CLI_OPTIONS *);
+static void stop_walk(int);
+static void write_remainder(WRITER *, const SOLVER_CTX *);
+
+
+
+
+/************************
+ *** Global Variables ***
+ ************************/
 
-static NET_SOLUTION * get_initial_objective(char * net_file);
-static NET_SOLUTION * get_perturbation_solution(CPXENVptr, CPXENVptr, CPXLPptr, CPXLPptr);
+/** The context whose walk SIGTERM and SIGINT stop, NULL outside the walk **/
+static SOLVER_CTX * volatile signal_ctx;
 
 
 
@@ -85,432 +107,265 @@ static NET_SOLUTION * get_perturbation_solution(CPXENVptr, CPXENVptr, CPXLPptr,
 int
 main(int argc, char **argv)
 {
-	/* Main Variables */
-	CPXENVptr	env1 = NULL;
-	CPXENVptr	env2 = NULL;
-	CPXNETptr	net1 = NULL;
-	CPXNETptr	net2 = NULL;
-	CPXLPptr	lp1 = NULL;
-	CPXLPptr	lp2 = NULL;
+	SOLVER_CTX * ctx = NULL;
+	WRITER * writer = NULL;
+	VERIFIER * verifier = NULL;
+	TRACE * trace = NULL;
+	TRACE * replay = NULL;
+	BASIS_ARCHIVE * archive = NULL;
+	INDEX_WRITER * index = NULL;
+	NET_BASIS * resume = NULL;
+	PERF_STATS * perf = NULL;
+	CLI_OPTIONS options;
 	int status = 0;
-	int i, j;
-
-	/* Problem Info Variables */
-	int narcs, nnodes;
-	double * costs1 = NULL;
-	double * costs2 = NULL;
-
-	/* Timestamps */
-	double start, end;
-	int start_st, end_st;
 
 	/* Sanity Check to Command Line Args */
-	if(usage(argc)) {
-		goto TERMINATE;
+	if(usage(argc, argv, &options)) {
+		return 1;
 	}
 
+	/* set before any solution array is created */
+	mem_set_policy(options.huge_pages);
 
-	
-
-
-	/*** CPLEX INITIALIZATION:
-	 *** The CPLEX environments are initialized here, with the LP objects also
-	 *** set from the NET objects generated from the input files passed to the
-	 *** solver at startup.
-	 ***
-	 *** During the initialization steps, the NET objects are also set free as
-	 *** they aren't needed during the rest o the optimization. At the end, only
-	 *** the environment and the LP objects need to be set free.
-	 ***/
-	
-	/* env1 is the CPLEX environment of the first objective function */
-	env1 = CPXopenCPLEX(&status);
-	if(!env1) {
-		char errmsg[CPXMESSAGEBUFSIZE];
-		CPXgeterrorstring(env1, status, errmsg);
-		fprintf(stderr, "Unable to start CPLEX environment 1, %d, %s\n", status, errmsg);
-		goto TERMINATE;
+	/* the arguments are queries on an index written by an earlier run */
+	if(options.query) {
+		return run_query(&options);
 	}
 
-	/* the NET and LP problem objects are also created now ***/
-	net1 = CPXNETcreateprob(env1, &status, "network1");
-	if(!net1) {
-		fprintf(stderr, "Unable to create NET problem object 1.\n");
-		goto TERMINATE;
+	if(options.bidirectional) {
+		return run_bidirectional(&options);
 	}
 
-	lp1 = CPXcreateprob(env1, &status, "lp1");
-	if(!lp1) {
-		fprintf(stderr, "Unable to create LP problem object 1.\n");
-		goto TERMINATE;
+	if(options.nfiles > 2) {
+		return run_weight_space(&options);
 	}
 
-	/* finally the objective function problem data is copied from the file
-	 * provided as argument 1 to the solver.
-	 */
-	status = copy_cplex_problem(env1, net1, lp1, argv[1]);
-	if(status) {
-		fprintf(stderr, "An error ocurred copying problem 1 data.\n");
-		goto TERMINATE;
-	}
-	
-	/***** PROCESS REPEATED FOR OBJECTIVE FUNCTION 2 ******/
-	
-	/* env2 is the CPLEX environment of the second objective function */
-	env2 = CPXopenCPLEX(&status);
-	if(!env2) {
-		char errmsg[CPXMESSAGEBUFSIZE];
-		CPXgeterrorstring(env2, status, errmsg);
-		fprintf(stderr, "Unable to start CPLEX environment 2, %d, %s\n", status, errmsg);
-		goto TERMINATE;
+	/* both file arguments are traces: only compare them */
+	if(options.trace_diff) {
+		return trace_diff(options.net_file1, options.net_file2, stdout) ? 1 : 0;
 	}
 
-	/* the NET and LP problem objects are also created now ***/
-	net2 = CPXNETcreateprob(env2, &status, "network2");
-	if(!net2) {
-		fprintf(stderr, "Unable to create NET problem object 2.\n");
-		goto TERMINATE;
+	ctx = solver_create();
+	if(!ctx) {
+		return 1;
 	}
 
-	lp2 = CPXcreateprob(env2, &status, "lp2");
-	if(!lp2) {
-		fprintf(stderr, "Unable to create LP problem object 2.\n");
-		goto TERMINATE;
-	}
+	/* the budget counts from start up, loading included */
+	solver_set_budget(ctx, options.time_limit, options.iteration_limit);
+
 
-	/* finally the objective function problem data is copied from the file
-	 * provided as argument 2 to the solver.
-	 */
-	status = copy_cplex_problem(env2, net2, lp2, argv[2]);
+	/*** CPLEX INITIALIZATION:
+	 *** Both objective functions are loaded into the solver context, each one
+	 *** with its own CPLEX environment and LP object.
+	 ***/
+	solver_set_reduce(ctx, options.reduce);
+	solver_set_loader(ctx, options.load_threads);
+	solver_set_engines(ctx, options.initial_engine, options.perturb_engine);
+	solver_set_portfolio(ctx, options.portfolio_db, options.threads);
+	solver_set_basis_tree(ctx, options.basis_tree);
+	solver_set_approximation(ctx, options.epsilon, options.max_points);
+
+	status = solver_load(ctx, options.net_file1, options.net_file2);
 	if(status) {
-		fprintf(stderr, "An error ocurred copying problem 2 data.\n");
 		goto TERMINATE;
 	}
 
+	if(ctx->reduction) {
+		print_reduction(stderr, ctx->reduction);
+	}
 
-
-
-
-
-	/*** CPLEX PARAMETERS SETTINGS:
-	 *** parameters are set for both environments in this stage. Below is a list
-	 *** of the settings apllied to both the CPLEX environments. If there is any
-	 *** change to the code, please post it here also:
-	 *** 	- CPLEX SCREEN OUTPUT   = OFF
-	 ***	- CPLEX ITERATION LIMIT = 1
-	 ***/
-	
-	status = CPXsetintparam(env1, CPX_PARAM_SCRIND, CPX_OFF);
-	if(status) {
-		fprintf(stderr, "Unable to set screen output.\n");
-		goto TERMINATE;
+	/* a point of an earlier run warm starts both solves before the walk */
+	if(options.warm_start || options.resume) {
+		resume = archived_basis(options.resume ? options.resume : options.warm_start, ctx);
+		if(!resume || solver_set_warm_start(ctx, resume, resume)) {
+			status = 1;
+			goto TERMINATE;
+		}
 	}
 
-	status = CPXsetintparam(env1, CPX_PARAM_ITLIM, 1);
-	if(status) {
-		fprintf(stderr, "Unable to set iteration limit to 1.\n");
+	if(options.benchmark_anchors) {
+		status = solver_benchmark_anchors(ctx, stderr);
 		goto TERMINATE;
 	}
 
-	status = CPXsetintparam(env2, CPX_PARAM_SCRIND, CPX_OFF);
-	if(status) {
-		fprintf(stderr, "Unable to set screen output.\n");
+	/* every scenario is solved on its own copy of the loaded problem */
+	if(options.scenarios) {
+		status = solve_batch(ctx, options.scenarios, options.output, options.threads);
 		goto TERMINATE;
 	}
 
-	status = CPXsetintparam(env2, CPX_PARAM_ITLIM, 1);
-	if(status) {
-		fprintf(stderr, "Unable to set iteration limit to 1.\n");
+	/* the service answers its clients until one of them shuts it down */
+	if(options.service) {
+		status = run_service(ctx, options.service);
 		goto TERMINATE;
 	}
 
 
-
-
-
-
-	/*** MEMORY ALLOCATION STAGE:
-	 *** memory is alloc'd for the various number of objects that are used during
-	 *** the optimization, like structs to save information about basis and
-	 *** solution. If this stage fails, the solver MUST be immediatly terminated
-	 *** and if not the user takes the risk of facing potentially serious
-	 *** SEGFAULTS furing the optimization stage as CPLEX will try to access
-	 *** memory that wasn't alloc'd to the solver.
-	 ***
-	 *** We make the assumption that the number of rows and colums in both
-	 *** objective functions is the same. If not, the risk of a SEGFAULT is also
-	 *** very probable due to the same reasons as stated above.
+	/*** OUTPUT STAGE:
+	 *** every iteration is queued to the asynchronous writer, whose I/O
+	 *** thread formats and writes it, so the pivot loop never waits on the
+	 *** output stream.
 	 ***/
-
-	/* Geting the number of arcs and number of nodes with:
-	 *		n. of arcs  = n. of cols
-	 *		n. of nodes = n. of rows
-	 */
-	narcs  = CPXgetnumcols(env1, lp1);
-	nnodes = CPXgetnumrows(env1, lp1);
-
-
-	/* solution1 object holds the status of the solution relative to the first
-	 * objective function.
-	 */
-	solution1 = create_solution(narcs, nnodes);
-	if(!solution1) {
-		fprintf(stderr, "Error on solution 1 alloc.\n");
-		goto TERMINATE;
-	}
-	
-	/* solution2 object holds the information of the solution relative to the
-	 * second objective function. Notice that the data stored in solution2->basis
-	 * must be the same ALWAYS as the data stored in solution1->basis. If this
-	 * does not hold, something is wrong with the optimization.
-	 */
-	solution2 = create_solution(narcs, nnodes);
-	if(!solution2) {
-		fprintf(stderr, "Error on solution 2 alloc.\n");
+	writer = create_writer(options.output, ctx->narcs, ctx->nnodes, options.writer_slots);
+	if(!writer) {
+		status = 1;
 		goto TERMINATE;
 	}
 
-	/* the perturbsol object holds the initial basis for the bi-objective problem.
-	 * this object is used only two times: when finding the initial basis and
-	 * when passing it to the bi-objective solving loop. As its information is
-	 * necessary only during a brief period, with may be used for other purposes
-	 * if needed, as its only set free at termination like the rest of the
-	 * objects.
-	 */
-	perturbsol = create_solution(narcs, nnodes);
-	if(!perturbsol) {
-		fprintf(stderr, "Error on perturbation solution alloc.\n");
+	if(ctx->reduction && writer_set_reduction(writer, ctx->reduction)) {
+		status = 1;
 		goto TERMINATE;
 	}
 
+	solver_set_callback(ctx, writer_iteration, writer);
 
+	/* the verifier checks every point as it comes, then hands it on */
+	if(options.verify) {
+		verifier = create_verifier(ctx, options.threads, writer_iteration, writer);
+		if(!verifier) {
+			status = 1;
+			goto TERMINATE;
+		}
+		solver_set_callback(ctx, verify_record, verifier);
+	}
 
+	/* the archive packs the basis of every point before the others see it */
+	if(options.archive) {
+		archive = create_archive(ctx->narcs, ctx->nnodes, ctx->callback, ctx->cbdata);
+		if(!archive) {
+			status = 1;
+			goto TERMINATE;
+		}
+		solver_set_callback(ctx, archive_record, archive);
+	}
 
+	/* the index appends the flow of every point to its file as it comes */
+	if(options.index) {
+		index = open_index_writer(options.index, ctx, ctx->callback, ctx->cbdata);
+		if(!index) {
+			status = 1;
+			goto TERMINATE;
+		}
+		solver_set_callback(ctx, index_record, index);
+	}
 
+	/* the counters follow the calling thread, which is the one that pivots */
+	if(options.perf_counters) {
+		perf = create_perf_stats();
+		if(!perf) {
+			status = 1;
+			goto TERMINATE;
+		}
+		solver_set_perf(ctx, perf);
+	}
 
 
+	if(options.trace) {
+		trace = open_trace_writer(options.trace, ctx->narcs, ctx->nnodes, ctx->direction);
+		if(!trace) {
+			status = 1;
+			goto TERMINATE;
+		}
+		solver_set_trace(ctx, trace);
+	}
 
 
 	/*** OPTIMIZATION STAGE:
 	 *** the optimization stage is made in several steps and must be followed
 	 *** with precision or the solver fails to generate the correct results (at
 	 *** least in a computational sense). The steps are the following:
-	 *** 	- Get the global minimum for objective function 1 and 2
+	 *** 	- Get the global minimum for objective function 2
 	 ***	- Get the initial basis using the perturbation of both objective functions.
-	 ***	  The method of the perturbation is Z(x) = 0.99*z1(x) + 0.01*z2(x).
-	 *** 	- Start the while loop with the stop condition of solution2->value === temp_sol2->value
-	 ***	- Get the reduced costs of both networks and identify the arcs that may
-	 ***	  enter the basis next.
-	 ***    - Perform ratio testing to finding the entering arc.
-	 ***    - Build the new basis (not a valid basis but may be used to tell CPLEX
-	 ***      which arc is entering).
-	 ***	- Print information to screen and/or file.
-	 ***    - Check stop criteria.
+	 ***	  The method of the perturbation is Z(x) = 0.999*z1(x) + 0.001*z2(x).
+	 *** 	- Step until solution2->objval reaches the objective 2 minimum, each
+	 ***	  step finding the entering arc by ratio testing and pivoting it in.
+	 ***	- Print information to screen on every iteration.
 	 ***/
+	signal_ctx = ctx;
+	signal(SIGTERM, stop_walk);
+	signal(SIGINT, stop_walk);
 
-	NET_SOLUTION * initial_sol2 = get_initial_objective(argv[2]);
-	if(!initial_sol2) {
-		fprintf(stderr, "Failed to get global objective 2 minimum.\n");
-		goto TERMINATE;
-	}
-
-	printf("Objective 2 Objective Value Min: %lf\n\n\n", initial_sol2->objval);
-
-
-	perturbsol = get_perturbation_solution(env1, env2, lp1, lp2);
-	if(!perturbsol) {
-		fprintf(stderr, "Error on perturbation method..\n");
-		goto TERMINATE;
-	}
-	
-
-
-	/* Copy the initial basis found by the perturbation and stored in perturbsol
-	 * to both solution1 and solution2.
-	 */
-	memcpy(perturbsol, solution1, sizeof(NET_SOLUTION));
-	memcpy(perturbsol, solution2, sizeof(NET_SOLUTION));
-	
-	
-	
-	status = update_solution(env1, lp1, "pbasis", solution1, "basis1");
-	if(status) {
-		goto TERMINATE;
-	}
-	
-	print_solution(solution1, narcs, nnodes);
-	
-	status = update_solution(env2, lp2, "pbasis", solution2, "basis2");
+	status = solver_initial_solve(ctx);
 	if(status) {
 		goto TERMINATE;
 	}
-	
-	print_solution(solution2, narcs, nnodes);
-	
-	
-	
-	/* Start the optimization loop for the bi-objective problem now if everything
-	 * went right and no failures where detected.
-	 */
-
-	int it_test_cnt = 0;
-	while(solution2->objval > initial_sol2->objval) {
-	
-		status = CPXgettime(env2, &start);
-		if(status) {
-			fprintf(stderr, "Unable to get time.\n");
-			goto TERMINATE;
-		}
-	
-		/* Find the entering arc */
-		int arc = entering_arc(solution1->dj, solution2->dj, solution2->basis->arc_basis, narcs);
-		if(arc == -1) {
-			fprintf(stderr, "Error calculating entering arc. Break.\n");
-			goto TERMINATE;
-			//break;
-		}
-		
-		printf("Entering arc: %d\n", arc);
-		
-		/* Turn off presolve and set parameters for CPLEX accept advanced basis */
-		status = CPXsetintparam(env2, CPX_PARAM_ADVIND, 2);
-		if(status) {
-			fprintf(stderr, "Unable to set advanced start switch to 1.\n");
-			goto TERMINATE;
-		}
-		
-		status = CPXsetintparam(env2, CPX_PARAM_PREIND, CPX_OFF);
-		if(status) {
-			fprintf(stderr, "Error turning off presolve. ERROR %d\n", status);
-			goto TERMINATE;
-		}
-		
-		status = CPXsetintparam(env2, CPX_PARAM_AGGIND, 0);
-		if(status) {
-			fprintf(stderr, "Error turning off aggregator. ERROR: %d\n", status);
-			goto TERMINATE;
-		}
-		
-		status = CPXsetintparam(env2, CPX_PARAM_DEPIND, 0);
-		if(status) {
-			fprintf(stderr, "Error turning off DEPIND. ERROR: %d\n", status);
-			goto TERMINATE;
-		}
-				
-		status = CPXsetintparam(env2, CPX_PARAM_PREDUAL, -1);
-		if(status) {
-			fprintf(stderr, "Error turning off PREDUAL. ERROR: %d\n", status);
-			goto TERMINATE;
-		}
-		
-		status = CPXsetintparam(env2, CPX_PARAM_PREPASS, 0);
-		if(status) {
-			fprintf(stderr, "Error turning off PREPASS. ERROR: %d\n", status);
-			goto TERMINATE;
-		}
-		
-		status = CPXsetintparam(env2, CPX_PARAM_SCAIND, -1);
-		if(status) {
-			fprintf(stderr, "Error turning off SCAIND. ERROR: %d\n", status);
-			goto TERMINATE;
-		}
-		
-		status = CPXsetintparam(env2, CPX_PARAM_SIMDISPLAY, 2);
-		if(status) {
-			fprintf(stderr, "Error turning off SCAIND. ERROR: %d\n", status);
-			goto TERMINATE;
-		}
-		
-		
-		
-		/* Enter the arc using CPXpivot */
-		status = CPXpivot(env2, lp2, arc, CPX_NO_VARIABLE, CPX_AT_LOWER);
-		if(status) {
-			fprintf(stderr, "CPXpivot failed.\n");
-			goto TERMINATE;
-		}
-		
-		
-		status = CPXgettime(env2, &end);
-		if(status) {
-			fprintf(stderr, "Unable to get time.\n");
-			goto TERMINATE;
-		}
-		fprintf(stdout, "Time Elapsed: %lf s\n", end - start);
-	
-	
-		
-		/* Get the solution */
-		status = CPXsolution(env2, lp2, &solution2->solstat, &solution2->objval,
-							 solution2->x, solution2->pi, solution2->slack, solution2->dj);
-		if(status) {
-			fprintf(stderr, "Error getting solution at end of loop.\n");
-			goto TERMINATE;
-		}
 
-		status = CPXgetbase(env2, lp2, solution2->basis->arc_basis, solution2->basis->node_basis);
-		if(status) {
-			fprintf(stderr, "Error getting base at end of loop.\n");
-			goto TERMINATE;
-		}
-		
-		
-		/* Update all the stuff and print the solutions */
-		status = CPXmbasewrite(env2, lp2, "basis2");
-		if(status) {
-			fprintf(stderr, "Error %d\n", status);
-			goto TERMINATE;
-		}
-		
-		status = update_solution(env2, lp2, "basis2", solution2, "basis2");
-		if(status) {
+	writer_text(writer, "Objective 2 Objective Value Min: %lf\n\n\n", ctx->initial_sol2->objval);
+
+	if(options.replay) {
+		replay = open_trace_reader(options.replay);
+		if(!replay) {
+			status = 1;
 			goto TERMINATE;
 		}
-		
-		status = update_solution(env1, lp1, "basis2", solution1, "basis1");
-		if(status) {
-			goto TERMINATE;
+		status = solver_replay(ctx, replay, stderr);
+	} else if(options.resume) {
+		status = solver_resume(ctx, resume);
+		if(!status) {
+			status = solver_run(ctx);
 		}
-	
-		print_solution(solution1, narcs, nnodes);
-		print_solution(solution2, narcs, nnodes);
-	
-		it_test_cnt++;
+	} else {
+		status = solver_run(ctx);
 	}
 
+	if(ctx->tree) {
+		basis_tree_report(stderr, ctx->tree);
+	}
 
-	/* Get Solution Data:
-	 * Alloc memory for the solution arrays
-	 * Get the solution data using CPXsolution routine
-	 */
+	if(!status) {
+		write_remainder(writer, ctx);
+	}
 
+	solver_anytime_report(stderr, ctx);
+	solver_pivot_report(stderr, ctx);
+	solver_approx_report(stderr, ctx);
 
+	if(verifier && !status && verify_frontier(verifier, stderr)) {
+		status = 1;
+	}
 
+	if(archive && !status) {
+		if(archive->dropped) {
+			fprintf(stderr, "%d points left out of the basis archive.\n", archive->dropped);
+		}
+		if(write_archive(archive, options.archive)) {
+			status = 1;
+		}
+	}
 
 
 TERMINATE:
 
-	/* Free alloc'd memory */
-	free_solution(&solution1);
-	free_solution(&solution2);
-	free_solution(&perturbsol);
-
-	free_and_null((void *) &costs1);
-	free_and_null((void *) &costs2);
+	/* the context is freed below, a signal from now on ends the process */
+	signal(SIGTERM, SIG_DFL);
+	signal(SIGINT, SIG_DFL);
+	signal_ctx = NULL;
 
+	if(options.huge_pages != MEM_DEFAULT) {
+		mem_report(stderr);
+	}
 
+	if(close_writer(&writer) && !status) {
+		status = 1;
+	}
 
+	solver_free(&ctx);
+	free_verifier(&verifier);
+	free_archive(&archive);
 
+	if(close_index_writer(&index) && !status) {
+		status = 1;
+	}
+	free_basis(&resume);
 
-	/* Close CPLEX */
-	status = CPXcloseCPLEX(&env1);
-	if(env1) {
-		fprintf(stderr, "Unable to close CPLEX.\n");
+	if(close_trace(&trace) && !status) {
+		status = 1;
 	}
-	
-	status = CPXcloseCPLEX(&env2);
-	if(env2) {
-		fprintf(stderr, "Unable to close CPLEX.\n");
+	close_trace(&replay);
+
+	if(perf) {
+		perf_report(stderr, perf);
+		free_perf_stats(&perf);
 	}
 
 	return status;
@@ -519,618 +374,392 @@ TERMINATE:
 
 
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
 /*** Functions Definitions ***/
 
 /** Function: usage
- ** A function that receives the number of inputs given to the main function
- ** and if an error is detected, it prints the necessary usage information to
- ** the standard error output stream.
- **/
-int usage(int argc) {
-	if(argc != 3) {
-		fprintf(stderr, "Usage: ./solver [NETWORK1] [NETWORK2]\n");
-		return 1;
-	}
-	
-	return 0;
-}
-
-
-/** Function: free_and_null
- ** The function receives a double pointer to some previously allocated memory
- ** and frees that memory also setting all the necessary pointers to NULL
+ ** A function that receives the inputs given to the main function and fills
+ ** the options struct. If an error is detected, it prints the necessary usage
+ ** information to the standard error output stream and returns 1.
  **/
-void free_and_null(void **ptr)
-{
-	if(ptr) {
-		free(*ptr);
-		ptr = NULL;
+static int usage(int argc, char ** argv, CLI_OPTIONS * options) {
+	static const struct option long_options[] = {
+		{"bidirectional", no_argument, NULL, 'b'},
+		{"output", required_argument, NULL, 'o'},
+		{"writer-slots", required_argument, NULL, 'w'},
+		{"perf-counters", no_argument, NULL, 'p'},
+		{"reduce", no_argument, NULL, 'r'},
+		{"initial-engine", required_argument, NULL, 'I'},
+		{"perturb-engine", required_argument, NULL, 'P'},
+		{"benchmark-anchors", no_argument, NULL, 'B'},
+		{"basis-tree", required_argument, NULL, 'T'},
+		{"service", required_argument, NULL, 'S'},
+		{"scenarios", required_argument, NULL, 'M'},
+		{"threads", required_argument, NULL, 'j'},
+		{"epsilon", required_argument, NULL, 'e'},
+		{"max-points", required_argument, NULL, 'm'},
+		{"verify", no_argument, NULL, 'V'},
+		{"trace", required_argument, NULL, 't'},
+		{"replay", required_argument, NULL, 'R'},
+		{"trace-diff", no_argument, NULL, 'D'},
+		{"huge-pages", required_argument, NULL, 'H'},
+		{"load-threads", required_argument, NULL, 'L'},
+		{"archive", required_argument, NULL, 'A'},
+		{"warm-start", required_argument, NULL, 'W'},
+		{"resume", required_argument, NULL, 'U'},
+		{"index", required_argument, NULL, 'Y'},
+		{"query", required_argument, NULL, 'Q'},
+		{"time-limit", required_argument, NULL, 'l'},
+		{"iteration-limit", required_argument, NULL, 'i'},
+		{"portfolio-db", required_argument, NULL, 'K'},
+		{NULL, 0, NULL, 0}
+	};
+	int c;
+
+	memset(options, 0, sizeof(CLI_OPTIONS));
+	options->basis_tree = BASISTREE_NONE;
+	options->threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+
+	while((c = getopt_long(argc, argv, "bo:w:prI:P:BT:S:M:j:e:m:Vt:R:DH:L:A:W:U:Y:Q:l:i:K:", long_options, NULL)) != -1) {
+		switch(c) {
+		case 'b':
+			options->bidirectional = 1;
+			break;
+		case 'o':
+			options->output = optarg;
+			break;
+		case 'w':
+			options->writer_slots = strtoul(optarg, NULL, 10);
+			break;
+		case 'p':
+			options->perf_counters = 1;
+			break;
+		case 'r':
+			options->reduce = 1;
+			break;
+		case 'I':
+			options->initial_engine = anchor_engine(optarg);
+			if(options->initial_engine < 0) {
+				argc = 0;
+			}
+			break;
+		case 'P':
+			options->perturb_engine = anchor_engine(optarg);
+			if(options->perturb_engine < 0) {
+				argc = 0;
+			}
+			break;
+		case 'B':
+			options->benchmark_anchors = 1;
+			break;
+		case 'T':
+			options->basis_tree = basis_tree_kind(optarg);
+			if(options->basis_tree < BASISTREE_NONE) {
+				argc = 0;
+			}
+			break;
+		case 'S':
+			options->service = optarg;
+			break;
+		case 'M':
+			options->scenarios = optarg;
+			break;
+		case 'j':
+			options->threads = atoi(optarg);
+			break;
+		case 'e':
+			options->epsilon = atof(optarg);
+			break;
+		case 'm':
+			options->max_points = atoi(optarg);
+			break;
+		case 'V':
+			options->verify = 1;
+			break;
+		case 't':
+			options->trace = optarg;
+			break;
+		case 'R':
+			options->replay = optarg;
+			break;
+		case 'D':
+			options->trace_diff = 1;
+			break;
+		case 'L':
+			options->load_threads = atoi(optarg);
+			break;
+		case 'A':
+			options->archive = optarg;
+			break;
+		case 'W':
+			options->warm_start = optarg;
+			break;
+		case 'U':
+			options->resume = optarg;
+			break;
+		case 'Y':
+			options->index = optarg;
+			break;
+		case 'Q':
+			options->query = optarg;
+			break;
+		case 'l':
+			options->time_limit = atof(optarg);
+			break;
+		case 'i':
+			options->iteration_limit = atoi(optarg);
+			break;
+		case 'K':
+			options->portfolio_db = optarg;
+			break;
+		case 'H':
+			options->huge_pages = mem_policy(optarg);
+			if(options->huge_pages < 0) {
+				argc = 0;
+			}
+			break;
+		default:
+			argc = 0;
+			break;
+		}
 	}
-}
-
 
-/** The function objective_value receives two arrays with the objective values of
- ** the objective function and the flow for each variable and the number of
- ** variables (arcs) and returns the objective value.
- **/
-double objective_value(double * objs, double * flow, int narcs)
-{
-	if(!objs || !flow) {
-		fprintf(stderr, "Unable to calculate objective flow due to NULL array.\n");
-		return 0.0;
+	/* the walk and its tools are bi-objective, more networks only allow -j, -I, -K and -H */
+	if(argc - optind > 2 && !options->query && (options->bidirectional || options->service || options->scenarios ||
+	                         options->output || options->writer_slots || options->perf_counters ||
+	                         options->perturb_engine || options->basis_tree != BASISTREE_NONE ||
+	                         options->load_threads || options->epsilon > 0.0 || options->max_points > 0 ||
+	                         options->verify || options->trace || options->replay || options->trace_diff ||
+	                         options->reduce || options->benchmark_anchors || options->archive ||
+	                         options->warm_start || options->resume || options->index ||
+	                         options->time_limit > 0.0 || options->iteration_limit > 0)) {
+		fprintf(stderr, "Only -I, -K, -j and -H apply to more than two networks.\n");
+		argc = 0;
+	}
+
+	/* both walks of -b run on private contexts with the default settings */
+	if(options->bidirectional && (options->output || options->writer_slots || options->perf_counters ||
+	                              options->reduce || options->load_threads || options->initial_engine ||
+	                              options->perturb_engine || options->benchmark_anchors ||
+	                              options->basis_tree != BASISTREE_NONE || options->service ||
+	                              options->scenarios || options->epsilon > 0.0 || options->max_points > 0 ||
+	                              options->verify || options->trace || options->replay || options->trace_diff ||
+	                              options->archive || options->warm_start || options->resume ||
+	                              options->index || options->query || options->portfolio_db ||
+	                              options->time_limit > 0.0 || options->iteration_limit > 0)) {
+		fprintf(stderr, "Only -H applies to the bidirectional walk.\n");
+		argc = 0;
+	}
+
+	/* the scenarios are solved by clones that only carry the solver settings */
+	if(options->scenarios && (options->service || options->writer_slots || options->perf_counters ||
+	                          options->reduce || options->benchmark_anchors || options->epsilon > 0.0 ||
+	                          options->max_points > 0 || options->verify || options->trace || options->replay ||
+	                          options->trace_diff || options->archive || options->warm_start ||
+	                          options->resume || options->index || options->query)) {
+		fprintf(stderr, "Only -o, -L, -I, -P, -K, -T, -j, -l, -i and -H apply to a scenario batch.\n");
+		argc = 0;
+	}
+
+	/* the service answers with the frontier itself, none of the output chain is built */
+	if(options->service && (options->output || options->writer_slots || options->perf_counters ||
+	                        options->benchmark_anchors || options->verify || options->trace || options->replay ||
+	                        options->trace_diff || options->archive || options->resume || options->index ||
+	                        options->query)) {
+		fprintf(stderr, "Only -r, -L, -I, -P, -K, -T, -j, -e, -m, -l, -i, -W and -H apply to the service.\n");
+		argc = 0;
+	}
+
+	if(argc - optind < (options->query ? 1 : 2)) {
+		fprintf(stderr, "Usage: ./solver [OPTIONS] [NETWORK1] [NETWORK2] [NETWORK3...]\n");
+		fprintf(stderr, "       ./solver -Q INDEX QUERY...\n");
+		fprintf(stderr, "  more than two networks give the supported extreme points of all objectives\n");
+		fprintf(stderr, "  -b, --bidirectional       walk the frontier from both ends on two threads\n");
+		fprintf(stderr, "  -o, --output FILE         write the solutions to FILE instead of stdout\n");
+		fprintf(stderr, "  -w, --writer-slots N      records buffered between the pivot loop and the writer\n");
+		fprintf(stderr, "  -p, --perf-counters       report hardware counters per phase of the loop\n");
+		fprintf(stderr, "  -r, --reduce              reduce the network before solving it\n");
+		fprintf(stderr, "  -L, --load-threads N      parse DIMACS networks natively on N threads\n");
+		fprintf(stderr, "  -I, --initial-engine E    engine of the anchor solve: simplex, scaling, dual, network,\n");
+		fprintf(stderr, "                            barrier or portfolio (race of configurations on -j threads)\n");
+		fprintf(stderr, "  -P, --perturb-engine E    engine of the perturbation solve, same choices\n");
+		fprintf(stderr, "  -K, --portfolio-db FILE   remember the portfolio winner of each instance class in FILE\n");
+		fprintf(stderr, "  -B, --benchmark-anchors   compare the engines on the anchor solves and exit\n");
+		fprintf(stderr, "  -T, --basis-tree KIND     update objective duals on a tree: none or array\n");
+		fprintf(stderr, "  -S, --service PATH        re-solve changes sent to a Unix socket at PATH\n");
+		fprintf(stderr, "  -M, --scenarios FILE      one frontier per supply vector of FILE, to OUTPUT.k or scenario.k\n");
+		fprintf(stderr, "  -j, --threads N           threads of the scenario batch, the verification and the\n");
+		fprintf(stderr, "                            weighted sums of more than two objectives\n");
+		fprintf(stderr, "  -e, --epsilon EPS         report an EPS-approximate frontier only\n");
+		fprintf(stderr, "  -m, --max-points N        report at most about N points of the frontier\n");
+		fprintf(stderr, "  -l, --time-limit SECONDS  stop after SECONDS, spreading the points found along the\n");
+		fprintf(stderr, "                            frontier and bounding the stretches left\n");
+		fprintf(stderr, "  -i, --iteration-limit N   same with a budget of N iterations; both budgets restart\n");
+		fprintf(stderr, "                            with every request of -S and scenario of -M\n");
+		fprintf(stderr, "  -V, --verify              check the optimality certificate of every point\n");
+		fprintf(stderr, "  -t, --trace FILE          record every pivot to the binary trace FILE\n");
+		fprintf(stderr, "  -R, --replay FILE         repeat the pivots of trace FILE without pricing\n");
+		fprintf(stderr, "  -D, --trace-diff          compare the traces given instead of the networks\n");
+		fprintf(stderr, "  -H, --huge-pages POLICY   back the solution arrays by default, thp or hugetlb pages\n");
+		fprintf(stderr, "  -A, --archive FILE        keep the packed basis of every point in FILE\n");
+		fprintf(stderr, "  -W, --warm-start FILE:K   warm start the solves from point K of archive FILE\n");
+		fprintf(stderr, "  -U, --resume FILE:K       walk on from point K of archive FILE, the last one by default\n");
+		fprintf(stderr, "  -Y, --index FILE          write the points sorted by objective 2 and their flows to FILE\n");
+		fprintf(stderr, "  -Q, --query FILE          answer budget=B, weight=W and point=K queries on index FILE\n");
+		return 1;
 	}
 
-	double value = 0.0;
-	int i = 0;
-
-	while(i < narcs) {
-		value += objs[i] * flow[i];
-		i++;
-	}
+	options->net_file1 = argv[optind];
+	options->net_file2 = argv[optind + 1];
+	options->net_files = argv + optind;
+	options->nfiles = argc - optind;
 
-	return value;
+	return 0;
 }
 
 
-/** Function: copy_cplex_problem
- ** The function receives three CPLEX objects (environment, net and lp) and a
- ** string with the filename of the network to be used and copies the network to
- ** the objects performing all the initialization necessary. If it fails, the
- ** function returns a value of -1. Otherwise, it returns a value of 0 or the
- ** error code of the error that happened. The CPLEX objetcs must be passed
- ** to the function already initialized by the respective CPLEX methods.
+/** Function: run_bidirectional
+ ** Computes the frontier from both extreme points on two threads and prints
+ ** the merged frontier to the standard output.
  **/
-int copy_cplex_problem(CPXENVptr env, CPXNETptr net, CPXLPptr lp, char * filename)
+static int run_bidirectional(const CLI_OPTIONS * options)
 {
-	if(!env) {
-		fprintf(stderr, "Unable to copy problem due to NULL environment.\n");
-		return -1;
-	}
+	FRONTIER * frontier = NULL;
+	int status = 0;
 
-	if(!net || !lp) {
-		fprintf(stderr, "Unable to copy problem due to NULL Net or Lp object.\n");
-		return -1;
+	frontier = create_frontier();
+	if(!frontier) {
+		return 1;
 	}
 
-	if(!filename) {
-		fprintf(stderr, "Unable to copy problem due to NULL file.\n");
-		return -1;
+	status = solve_bidirectional(options->net_file1, options->net_file2, frontier);
+	if(!status) {
+		print_frontier(frontier);
 	}
 
-	int status = 0;
-	
-	status = CPXNETreadcopyprob(env, net, filename);
-	if(status) {
-		fprintf(stderr, "Unable to copy problem to NET object.\n");
-		return status;
-	}
-	
-	status = CPXcopynettolp(env, lp, net);
-	if(status) {
-		fprintf(stderr, "Unable to copy problem to LP object.\n");
-		return status;
-	}
-	
-	status = CPXNETfreeprob(env, &net);
-	if(net) {
-		fprintf(stderr, "Unable to free NET problem object.\n");
-	}
-	
+	free_frontier(&frontier);
+
 	return status;
 }
 
 
-/** The function update_solution performs a single iteration that updates the
- ** information relative to the current basis stored in the LP problem object
- ** that is passed as an argument to the function.
- ** If any error is detected, the function returns a non-zero value and an error
- ** message is logged into standard error output stream.
+/** Function: run_weight_space
+ ** Computes the extreme supported points of the objective functions of all
+ ** network files by weight-space decomposition and prints them to the
+ ** standard output.
  **/
-int update_solution(CPXENVptr env, CPXLPptr lp, char * basis_file, NET_SOLUTION * sol, char * output_basis)
+static int run_weight_space(const CLI_OPTIONS * options)
 {
+	WEIGHT_SPACE * ws = NULL;
+	PORTFOLIO_SETTINGS portfolio;
 	int status = 0;
-	
-	/* Check if the input arguments are valid */
-	if(!env || !lp || !basis_file || !sol || !output_basis) {
-		fprintf(stderr, "Error: NULL pointer\n");
-		status = 1;
-		goto TERMINATE;
-	}
-	
-	/* Set the iteration limit to zero so that CPLEX doesn't change the current
-	 * basis
-	 */
-	status = CPXsetintparam(env, CPX_PARAM_ITLIM, 0);
-	if(status) {
-		fprintf(stderr, "Unable to set iteration limit to 0.\n");
-		goto TERMINATE;
-	}
-	
-	
-	status = CPXreadcopybase(env, lp, basis_file);
-	if(status) {
-		fprintf(stderr, "Error reading basis from file %s\n", basis_file),
-		status = 2;
-		goto TERMINATE;
-	}
-	
-	status = CPXprimopt(env, lp);
-	if(status) {
-		fprintf(stderr, "Error during optimization. ERROR %d\n", status);
-		goto TERMINATE;
-	}
-	
-	status = CPXsolution(env, lp, &sol->solstat, &sol->objval, sol->x, sol->pi, sol->slack, sol->dj);
-	if(status) {
-		fprintf(stderr, "Error getting solution. ERROR %d\n", status);
-		goto TERMINATE;
-	}
-	
-	status = CPXgetbase(env, lp, sol->basis->arc_basis, sol->basis->node_basis);
-	if(status) {
-		fprintf(stderr, "Error getting basis. ERROR %d\n", status);
-		goto TERMINATE;
-	}
-
-	status = CPXmbasewrite(env, lp, output_basis);
-	if(status) {
-		fprintf(stderr, "Error printing basis. ERROR %d\n", status);
-		goto TERMINATE;
-	}
-	
-	status = CPXsetintparam(env, CPX_PARAM_ITLIM, 1);
-	if(status) {
-		fprintf(stderr, "Unable to set iteration limit to 1.\n");
-		goto TERMINATE;
-	}
-	
-TERMINATE:
-
-	return status;
-}
 
+	/* the portfolio engine races one configuration per thread */
+	portfolio.database = options->portfolio_db;
+	portfolio.threads = options->threads;
 
-/** Function: entering_arc
- ** This method receives three arrays with the reduced costs of both objective
- ** functions and a valid basis and also receives an integer equal to the number
- ** of arcs in the problem (size of the arrays). It returns an integer equal to
- ** the index of the arc that will enter the basis.
- **/
-int entering_arc(double * dj1, double * dj2, int * basis, int size)
-{
-	int arc = 0;
-	int i;
-	
-	/* Sanity check of input data arrays --- if one of them its NULL the function
-	 * exists with a value of -1
-	 */
-	if(!dj1 || !dj2 || !basis) {
-		fprintf(stderr, "Error due to NULL pointer when calculating entering arc.\n");
-		return -1;
-	}
-	
-	double * ratios = malloc(size * sizeof(double));
-	if(!ratios) {
-		fprintf(stderr, "Unable to alloc ratios array.\n");
-		return -1;
-	}
-	
-	/* Calculate the ratio between the reduced costs of objective function 1 and
-	 * objective function 2.
-	 */
-	for(i = 0; i < size; i++) {
-		/* The ratio test must follow:
-		 * if basis[i] != 1 AND basis[i] == 0 (arc at lower bound) ----> dj2[i] must be < 0
-		 * if basis[i] != 1 AND basis[i] == 2 (arc at upper bound) ----> dj2[i] must be > 0
-		 */
-		if(basis[i] != 1 && basis[i] == 0 && dj2[i] < 0) {
-			ratios[i] = dj2[i] / dj1[i];
-			printf("DJ1: %lf DJ: %lf\n", dj1[i], dj2[i]);
-			printf("Ratio %d: %lf\n", i, ratios[i]);
-		} else if(basis[i] != 1 && basis[i] == 2 && dj2[i] > 0) {
-			ratios[i] = dj2[i] / dj1[i];
-			printf("DJ1: %lf DJ: %lf\n", dj1[i], dj2[i]);
-			printf("Ratio %d: %lf\n", i, ratios[i]);
-		} else {
-			ratios[i] = 0;
-		}
-	}
-
-	/* Find the best ratio, i.e., the slope that gives the highest rate of
-	 * decrease in the objective function 2.
-	 */
-	
-	for(i = 0; i < size; i++) {
-		if(ratios[i] != 0) {
-			if(ratios[i] < ratios[arc]) {
-				arc = i;
-			}
-		}
+	ws = create_weight_space(options->nfiles, options->net_files, options->threads, options->initial_engine,
+	                         &portfolio);
+	if(!ws) {
+		return 1;
 	}
-	
-	free(ratios);
-	
-	return arc;
-}
 
-/** Function: create_basis
- ** the function receives two variables of integer type equal to the number of
- ** arcs and nodes of the problem and returns a pointer to a NET_BASIS object.
- ** If any error is detected, an error is printed and NULL is returned.
- **/
-NET_BASIS * create_basis(int narcs, int nnodes)
-{
-	NET_BASIS * basis = malloc(sizeof(NET_BASIS));
-	if(!basis) {
-		fprintf(stderr, "Unable to alloc basis object.\n");
-		return NULL;
+	status = weight_space_solve(ws);
+	if(!status) {
+		fprint_weight_space(stdout, ws);
+		weight_space_report(stderr, ws);
 	}
 
-	basis->arc_basis = malloc(narcs * sizeof(int));
-	basis->node_basis = malloc(nnodes * sizeof(int));
-	if(!(basis->arc_basis) || !(basis->node_basis)) {
-		fprintf(stderr, "Unable to alloc basis arrays.\n");
-		return NULL;
+	if(options->huge_pages != MEM_DEFAULT) {
+		mem_report(stderr);
 	}
 
-	return basis;
-}
-
+	free_weight_space(&ws);
 
-/** Function: free_basis
- ** The function receives a double pointer to a NET_BASIS object that was
- ** previously allocated into dynamic memory and frees that memory.
- **/
-void free_basis(NET_BASIS ** basis)
-{
-	if(basis) {
-		free(*basis);
-		basis = NULL;
-	}
+	return status ? 1 : 0;
 }
 
 
-/** Function: create_solution
- ** This function receives two integers equal to the number of arcs and nodes in
- ** the network and creates an object to hold information of solutions of that
- ** problem, carrying out all the initialization procedurs necessary. If any
- ** error is found, the function returns NULL, otherwise it returns a pointer to
- ** the object.
+/** Function: archived_basis
+ ** Reads the basis of the point given as FILE or FILE:K, the last point of
+ ** FILE by default, from a basis archive written for the network of ctx.
+ ** Returns NULL on error.
  **/
-NET_SOLUTION * create_solution(int narcs, int nnodes)
+static NET_BASIS * archived_basis(const char * arg, const SOLVER_CTX * ctx)
 {
-	NET_SOLUTION * solution = (NET_SOLUTION *) malloc(sizeof(NET_SOLUTION));
-	if(!solution) {
-		fprintf(stderr, "Unable to alloc solution.\n");
-		return NULL;
-	}
-
-	solution->x = malloc(narcs * sizeof(double));
-	solution->dj = malloc(narcs * sizeof(double));
-	solution->pi = malloc(nnodes * sizeof(double));
-	solution->slack = malloc(nnodes * sizeof(double));
-	solution->objval = 0.0;
-	solution->solstat = 0;
-	solution->basis = create_basis(narcs, nnodes);
-
-	if(!(solution->x) || !(solution->dj) || !(solution->pi) || !(solution->slack) || !(solution->basis)) {
-		fprintf(stderr, "Error on alloc of solution arrays.\n");
+	NET_BASIS * basis = NULL;
+	ARCHIVE_ENTRY entry;
+	char * path = NULL;
+	int k;
+
+	if(parse_archive_point(arg, &path, &k)) {
+		fprintf(stderr, "Invalid archive point %s.\n", arg);
+		free(path);
 		return NULL;
 	}
 
-	return solution;
-}
-
-
-/** Function: free_solution
- ** the function receives a double pointer to a NET_SOLUTION object that was
- ** created using the create_solution method and frees the memory of that object
- ** also making all pointers NULL
- **/
-void free_solution(NET_SOLUTION ** solution)
-{
-	if(solution) {
-		//free_basis((NET_BASIS **) &(*solution)->basis);
-		free(*solution);
-		solution = NULL;
+	basis = read_archived_basis(path, k, ctx->narcs, ctx->nnodes, &entry);
+	if(basis) {
+		fprintf(stderr, "Starting from iteration %d of %s: %lf %lf\n", entry.iteration, path,
+		        entry.obj1, entry.obj2);
 	}
-}
 
+	free(path);
 
-/** Function: print_solution
- ** The function receives a NET_SOLUTION object and prints the solution stored
- ** in that object to the standard output stream.
- **/
-void print_solution(NET_SOLUTION * solution, int narcs, int nnodes)
-{
-	int i;
-	
-	if(!solution) {
-		return;
-	}
-	
-	fprintf(stdout, "********************************************************************\n");
-	fprintf(stdout, "Printing Solution Data:\n\n");
-	
-	fprintf(stdout, "Objective Value:\t\t%lf\n", solution->objval);
-	fprintf(stdout, "Objective Status:\t\t%d\n\n", solution->solstat);
-	
-	fprintf(stdout, "Objective Arc Data:\n");
-	for(i = 0; i < narcs; i++) {
-		fprintf(stdout, "Arc %d\tx: %lf\t reduced cost: %lf\t\tbasis: %d\n", i, solution->x[i], solution->dj[i], solution->basis->arc_basis[i]);
-	}
-	
-	fprintf(stdout, "Objective Node Data:\n");
-	for(i = 0; i < nnodes; i++) {
-		fprintf(stdout, "Node %d\tpi: %lf\t slack: %lf\t\tbasis: %d\n", i, solution->pi[i], solution->slack[i], solution->basis->node_basis[i]);
-	}
-	
-	fprintf(stdout, "\n");
+	return basis;
 }
 
 
-/** Function: get_initial_objective
- ** The function receives a string with a filename to a file that holds information
- ** of a network problem and than it solves that problem until an optimal
- ** solution is reached and returns a pointer to a NET_SOLUTION object with all
- ** the information of that solution. If any error is detected, the function 
- ** returns NULL.
+/** Function: run_query
+ ** Answers the queries given instead of the networks on the frontier index
+ ** file and prints the results to the standard output.
  **/
-NET_SOLUTION * get_initial_objective(char * net_file)
+static int run_query(const CLI_OPTIONS * options)
 {
-	if(!net_file) {
-		return NULL;
-	}
-	
+	FRONTIER_INDEX * index = NULL;
 	int status = 0;
-	CPXENVptr	env = NULL;
-	CPXNETptr	net = NULL;
-	CPXLPptr	lp = NULL;
-	
-	env = CPXopenCPLEX(&status);
-	if(!env) {
-		char errmsg[CPXMESSAGEBUFSIZE];
-		CPXgeterrorstring(env, status, errmsg);
-		fprintf(stderr, "Unable to start CPLEX free env, %d, %s\n", status, errmsg);
-		goto TERMINATE;
-	}
-
-	net = CPXNETcreateprob(env, &status, "network_free");
-	if(!net) {
-		fprintf(stderr, "Unable to create NET free problem object.\n");
-		goto TERMINATE;
-	}
-
-	lp = CPXcreateprob(env, &status, "lp_free");
-	if(!lp) {
-		fprintf(stderr, "Unable to create LP free problem object.\n");
-		goto TERMINATE;
-	}
-
-	status = CPXNETreadcopyprob(env, net, net_file);
-	if(status) {
-		fprintf(stderr, "Unable to copy problem to NET free object.\n");
-		goto TERMINATE;
-	}
-	
-	status = CPXcopynettolp(env, lp, net);
-	if(status) {
-		fprintf(stderr, "Unable to copy free problem.\n");
-		goto TERMINATE;
-	}
-
-	status = CPXsetintparam(env, CPX_PARAM_SCRIND, CPX_OFF);
-	if(status) {
-		fprintf(stderr, "Unable to set screen output.\n");
-		goto TERMINATE;
-	}
-
-	
-
-
-
-	int narcs = CPXgetnumcols(env, lp);
-	int nnodes = CPXgetnumrows(env, lp);
-
-	NET_SOLUTION * solution = create_solution(narcs, nnodes);
-	if(!solution) {
-		fprintf(stderr, "Error on free solution alloc.\n");
-		goto TERMINATE;
-	}
-
-	status = CPXprimopt(env, lp);
-	if(status) {
-		fprintf(stderr, "Error during optimization of free problem.\n");
-		goto TERMINATE;
-	}
-
-	status = CPXsolution(env, lp, &(solution->solstat), &(solution->objval), 
-		                     solution->x, solution->pi, solution->slack, solution->dj);
-	if(status) {
-		fprintf(stderr, "Unable to get solution.\n");
-		goto TERMINATE;
-	}
+	int i;
 
-	status = CPXgetbase(env, lp, solution->basis->arc_basis, solution->basis->node_basis);
-	if(status) {
-		fprintf(stderr, "Unable to get basis.\n");
-		goto TERMINATE;
+	index = open_frontier_index(options->query);
+	if(!index) {
+		return 1;
 	}
 
-TERMINATE:
-	
-	status = CPXNETfreeprob(env, &net);
-	if(net) {
-		fprintf(stderr, "Unable to free NET free problem object.\n");
-	}
-	
-	status = CPXfreeprob(env, &lp);
-	if(lp) {
-		fprintf(stderr, "Unable to free LP free problem object.\n");
+	for(i = 0; i < options->nfiles && !status; i++) {
+		status = index_query(index, options->net_files[i], stdout);
 	}
 
-	status = CPXcloseCPLEX(&env);
-	if(env) {
-		fprintf(stderr, "Unable to close CPLEX.\n");
-	}
+	close_frontier_index(&index);
 
-	return solution;
+	return status ? 1 : 0;
 }
 
 
-
-NET_SOLUTION * get_perturbation_solution(CPXENVptr env1, CPXENVptr env2, CPXLPptr lp1, CPXLPptr lp2)
+/** Function: stop_walk
+ ** Handler of SIGTERM and SIGINT: the walk stops after its current pivot and
+ ** the points found so far are written. A second signal ends the process.
+ **/
+static void stop_walk(int sig)
 {
-	int status = 0;
-	CPXENVptr penv = NULL;
-	CPXLPptr plp = NULL;
-	NET_SOLUTION * solution = NULL;
-	
-	double * costs1 = NULL;
-	double * costs2 = NULL;
-	double * costs3 = NULL;
-	int narcs, nnodes;
-
-	if(!env1 || !env2 || !lp1 || !lp2) {
-		fprintf(stderr, "Unable to perform perturbation.\n");
-		return NULL;
-	}
-
-	penv = CPXopenCPLEX(&status);
-	if(!penv) {
-		char errmsg[CPXMESSAGEBUFSIZE];
-		CPXgeterrorstring(penv, status, errmsg);
-		fprintf(stderr, "Unable to start CPLEX free env, %d, %s\n", status, errmsg);
-		goto TERMINATE;
-	}
-
-	plp = CPXcloneprob(penv, lp1, &status);
-	if(!plp) {
-		fprintf(stderr, "Unable to create LP free problem object.\n");
-		goto TERMINATE;
-	}	
-
-
-	/* Get the number of arcs and nodes ***/
-	narcs = CPXgetnumcols(env1, lp1);
-	nnodes = CPXgetnumrows(env1, lp1);
-
-
-	/* Get the cost arrays for each objective function ***/
-	costs1 = malloc(narcs * sizeof(double));
-	if(!costs1) {
-		fprintf(stderr, "Unable to alloc costs 1 array.\n");
-		goto TERMINATE;
-	}
-
-	status = CPXgetobj(env1, lp1, costs1, 0, narcs - 1);
-	if(status) {
-		fprintf(stderr, "Unable to get objective function 1 costs.\n");
-		goto TERMINATE;
-	}
-
-	costs2 = malloc(narcs * sizeof(double));
-	if(!costs2) {
-		fprintf(stderr, "Unable to alloc costs 2 array.\n");
-		goto TERMINATE;
-	}
+	solver_interrupt(signal_ctx);
+	signal(sig, SIG_DFL);
+}
 
-	status = CPXgetobj(env2, lp2, costs2, 0, narcs - 1);
-	if(status) {
-		fprintf(stderr, "Unable to get objective function 2 costs.\n");
-		goto TERMINATE;
-	}
-	
-	/* Build the new cost array and pass it to the new LP object */
-	costs3 = malloc(narcs * sizeof(double));
-	if(!costs3) {
-		fprintf(stderr, "Unable to alloc costs 2 array.\n");
-		goto TERMINATE;
-	}
 
-	int * index_list = malloc(narcs * sizeof(int));
-	if(!index_list) {
-		fprintf(stderr, "Error on index_list alloc.\n");
-		goto TERMINATE;
-	}
-	
-	int i;
-	for(i = 0; i < narcs; i++) {
-		costs3[i] = 0.999 * costs1[i] + 0.001 * costs2[i];
-		index_list[i] = i;
-	}
-	
-	status = CPXchgobj(penv, plp, narcs, index_list, costs3);
-	if(status) {
-		fprintf(stderr, "Unable to change objective values.\n");
-		goto TERMINATE;
-	}
-	
-	/* Alloc the solution object */
-	solution = create_solution(narcs, nnodes);
-	if(!solution) {
-		fprintf(stderr, "Unable to alloc solution.\n");
-		goto TERMINATE;
-	}
-	
-	/* Optimize */
-	status = CPXprimopt(penv, plp);
-	if(status) {
-		fprintf(stderr, "Unable to optimize problem.\n");
-		goto TERMINATE;
-	}
-	
-	/* Get solution */
-	status = CPXsolution(penv, plp, &(solution->solstat), &(solution->objval), 
-		                     solution->x, solution->pi, solution->slack, solution->dj);
-	if(status) {
-		fprintf(stderr, "Unable to get solution.\n");
-		goto TERMINATE;
-	}
-	
-	/* Get the basis */
-	status = CPXmbasewrite(penv, plp, "pbasis");
-	if(status) {
-		fprintf(stderr, "Unable to print basis.\n");
-		goto TERMINATE;
-	}
-	
-	status = CPXgetbase(penv, plp, solution->basis->arc_basis, solution->basis->node_basis);
-	if(status) {
-		fprintf(stderr, "Error getting basis from perturbation into struct.\n");
-		goto TERMINATE;
-	}
-	
+/** Function: write_remainder
+ ** Writes the box bounding every frontier point the walk left unexplored,
+ ** one per gap, after the points it found.
+ **/
+static void write_remainder(WRITER * writer, const SOLVER_CTX * ctx)
+{
+	int g;
 
-TERMINATE:
+	for(g = 0; g < ctx->ngaps; g++) {
+		const SOLVER_GAP * gap = &ctx->gaps[g];
 
-	free(costs1);
-	free(costs2);
-	
-	status = CPXfreeprob(penv, &plp);
-	if(status) {
-		fprintf(stderr, "Unable to free LP object.\n");
+		writer_text(writer, "Unexplored %d\tz1: [%lf, %lf]\tz2: [%lf, %lf]\n", g,
+		            gap->start1 < gap->end1 ? gap->start1 : gap->end1,
+		            gap->start1 < gap->end1 ? gap->end1 : gap->start1,
+		            gap->start2 < gap->end2 ? gap->start2 : gap->end2,
+		            gap->start2 < gap->end2 ? gap->end2 : gap->start2);
 	}
-	
-	status = CPXcloseCPLEX(&penv);
-	if(penv) {
-		fprintf(stderr, "Unable to close CPLEX.\n");
-	}	
-	
-	return solution;
 }
@@ -0,0 +1,644 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "hugepage.h"
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static void pack_status(unsigned char *, const int *, int);
+static void unpack_status(int *, const unsigned char *, int);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: free_and_null
+ ** The function receives a double pointer to some previously allocated memory
+ ** and frees that memory also setting all the necessary pointers to NULL
+ **/
+void free_and_null(void **ptr)
+{
+	if(ptr) {
+		free(*ptr);
+		*ptr = NULL;
+	}
+}
+
+
+/** The function objective_value receives two arrays with the objective values of
+ ** the objective function and the flow for each variable and the number of
+ ** variables (arcs) and returns the objective value.
+ **/
+double objective_value(double * objs, double * flow, int narcs)
+{
+	if(!objs || !flow) {
+		fprintf(stderr, "Unable to calculate objective flow due to NULL array.\n");
+		return 0.0;
+	}
+
+	double value = 0.0;
+	int i = 0;
+
+	while(i < narcs) {
+		value += objs[i] * flow[i];
+		i++;
+	}
+
+	return value;
+}
+
+
+/** Function: copy_cplex_problem
+ ** The function receives three CPLEX objects (environment, net and lp) and a
+ ** string with the filename of the network to be used and copies the network to
+ ** the objects performing all the initialization necessary. If it fails, the
+ ** function returns a value of -1. Otherwise, it returns a value of 0 or the
+ ** error code of the error that happened. The CPLEX objetcs must be passed
+ ** to the function already initialized by the respective CPLEX methods.
+ **/
+int copy_cplex_problem(CPXENVptr env, CPXNETptr net, CPXLPptr lp, const char * filename)
+{
+	if(!env) {
+		fprintf(stderr, "Unable to copy problem due to NULL environment.\n");
+		return -1;
+	}
+
+	if(!net || !lp) {
+		fprintf(stderr, "Unable to copy problem due to NULL Net or Lp object.\n");
+		return -1;
+	}
+
+	if(!filename) {
+		fprintf(stderr, "Unable to copy problem due to NULL file.\n");
+		return -1;
+	}
+
+	int status = 0;
+
+	status = CPXNETreadcopyprob(env, net, filename);
+	if(status) {
+		fprintf(stderr, "Unable to copy problem to NET object.\n");
+		return status;
+	}
+
+	status = CPXcopynettolp(env, lp, net);
+	if(status) {
+		fprintf(stderr, "Unable to copy problem to LP object.\n");
+		return status;
+	}
+
+	status = CPXNETfreeprob(env, &net);
+	if(net) {
+		fprintf(stderr, "Unable to free NET problem object.\n");
+	}
+
+	return status;
+}
+
+
+/** Function: create_basis
+ ** the function receives two variables of integer type equal to the number of
+ ** arcs and nodes of the problem and returns a pointer to a NET_BASIS object.
+ ** If any error is detected, an error is printed and NULL is returned.
+ **/
+NET_BASIS * create_basis(int narcs, int nnodes)
+{
+	NET_BASIS * basis = malloc(sizeof(NET_BASIS));
+	if(!basis) {
+		fprintf(stderr, "Unable to alloc basis object.\n");
+		return NULL;
+	}
+
+	basis->arc_basis = mem_alloc(narcs * sizeof(int));
+	basis->node_basis = mem_alloc(nnodes * sizeof(int));
+	if(!(basis->arc_basis) || !(basis->node_basis)) {
+		fprintf(stderr, "Unable to alloc basis arrays.\n");
+		free_basis(&basis);
+		return NULL;
+	}
+
+	return basis;
+}
+
+
+/** Function: free_basis
+ ** The function receives a double pointer to a NET_BASIS object that was
+ ** previously allocated into dynamic memory and frees that memory, including
+ ** the arc and node arrays, also making the pointer NULL.
+ **/
+void free_basis(NET_BASIS ** basis)
+{
+	if(basis && *basis) {
+		mem_free((*basis)->arc_basis);
+		mem_free((*basis)->node_basis);
+		free(*basis);
+		*basis = NULL;
+	}
+}
+
+
+/** Function: copy_basis
+ ** Copies the arc and node status arrays of the basis src into the basis dst.
+ ** Both objects must have been created for the same number of arcs and nodes.
+ **/
+void copy_basis(NET_BASIS * dst, const NET_BASIS * src, int narcs, int nnodes)
+{
+	if(!dst || !src || dst == src) {
+		return;
+	}
+
+	memcpy(dst->arc_basis, src->arc_basis, narcs * sizeof(int));
+	memcpy(dst->node_basis, src->node_basis, nnodes * sizeof(int));
+}
+
+
+/** Function: packed_basis_size
+ ** Returns the number of bytes of a packed basis: the arc statuses, then the
+ ** node statuses starting on a byte of their own.
+ **/
+size_t packed_basis_size(int narcs, int nnodes)
+{
+	return PACKED_SIZE(narcs) + PACKED_SIZE(nnodes);
+}
+
+
+/** Function: pack_basis
+ ** Packs the statuses of the basis into dst, four per byte with the first
+ ** one in the lowest bits. dst must hold packed_basis_size() bytes.
+ **/
+void pack_basis(unsigned char * dst, const NET_BASIS * basis, int narcs, int nnodes)
+{
+	pack_status(dst, basis->arc_basis, narcs);
+	pack_status(dst + PACKED_SIZE(narcs), basis->node_basis, nnodes);
+}
+
+
+/** Function: unpack_basis
+ ** Unpacks a basis packed by pack_basis() into the arrays of basis.
+ **/
+void unpack_basis(NET_BASIS * basis, const unsigned char * src, int narcs, int nnodes)
+{
+	unpack_status(basis->arc_basis, src, narcs);
+	unpack_status(basis->node_basis, src + PACKED_SIZE(narcs), nnodes);
+}
+
+
+/** Function: pack_status
+ ** Packs n statuses four to a byte. Whole bytes are built without branches
+ ** so the loop vectorizes; only the last byte may be partial.
+ **/
+static void pack_status(unsigned char * dst, const int * status, int n)
+{
+	int full = n / 4;
+	int i, j;
+	unsigned char last = 0;
+
+	for(i = 0; i < full; i++, status += 4) {
+		dst[i] = (unsigned char) ((status[0] & 3) | (status[1] & 3) << 2 |
+		                          (status[2] & 3) << 4 | (status[3] & 3) << 6);
+	}
+
+	if(n % 4) {
+		for(j = 0; j < n % 4; j++) {
+			last |= (unsigned char) ((status[j] & 3) << (2 * j));
+		}
+		dst[full] = last;
+	}
+}
+
+
+/** Function: unpack_status
+ ** Unpacks n statuses packed by pack_status().
+ **/
+static void unpack_status(int * status, const unsigned char * src, int n)
+{
+	int full = n / 4;
+	int i, j;
+
+	for(i = 0; i < full; i++, status += 4) {
+		unsigned int b = src[i];
+		status[0] = b & 3;
+		status[1] = (b >> 2) & 3;
+		status[2] = (b >> 4) & 3;
+		status[3] = b >> 6;
+	}
+
+	for(j = 0; j < n % 4; j++) {
+		status[j] = (src[full] >> (2 * j)) & 3;
+	}
+}
+
+
+/** Function: create_solution
+ ** This function receives two integers equal to the number of arcs and nodes in
+ ** the network and creates an object to hold information of solutions of that
+ ** problem, carrying out all the initialization procedurs necessary. If any
+ ** error is found, the function returns NULL, otherwise it returns a pointer to
+ ** the object.
+ **/
+NET_SOLUTION * create_solution(int narcs, int nnodes)
+{
+	NET_SOLUTION * solution = (NET_SOLUTION *) malloc(sizeof(NET_SOLUTION));
+	if(!solution) {
+		fprintf(stderr, "Unable to alloc solution.\n");
+		return NULL;
+	}
+
+	solution->x = mem_alloc(narcs * sizeof(double));
+	solution->dj = mem_alloc(narcs * sizeof(double));
+	solution->pi = mem_alloc(nnodes * sizeof(double));
+	solution->slack = mem_alloc(nnodes * sizeof(double));
+	solution->objval = 0.0;
+	solution->solstat = 0;
+	solution->basis = create_basis(narcs, nnodes);
+
+	if(!(solution->x) || !(solution->dj) || !(solution->pi) || !(solution->slack) || !(solution->basis)) {
+		fprintf(stderr, "Error on alloc of solution arrays.\n");
+		free_solution(&solution);
+		return NULL;
+	}
+
+	return solution;
+}
+
+
+/** Function: free_solution
+ ** the function receives a double pointer to a NET_SOLUTION object that was
+ ** created using the create_solution method and frees the memory of that object
+ ** also making all pointers NULL
+ **/
+void free_solution(NET_SOLUTION ** solution)
+{
+	if(solution && *solution) {
+		free_basis(&(*solution)->basis);
+		mem_free((*solution)->x);
+		mem_free((*solution)->dj);
+		mem_free((*solution)->pi);
+		mem_free((*solution)->slack);
+		free(*solution);
+		*solution = NULL;
+	}
+}
+
+
+/** Function: copy_solution
+ ** Copies every array, the objective value, the status and the basis of the
+ ** solution src into the solution dst. Both objects must have been created for
+ ** the same number of arcs and nodes.
+ **/
+void copy_solution(NET_SOLUTION * dst, const NET_SOLUTION * src, int narcs, int nnodes)
+{
+	if(!dst || !src || dst == src) {
+		return;
+	}
+
+	memcpy(dst->x, src->x, narcs * sizeof(double));
+	memcpy(dst->dj, src->dj, narcs * sizeof(double));
+	memcpy(dst->pi, src->pi, nnodes * sizeof(double));
+	memcpy(dst->slack, src->slack, nnodes * sizeof(double));
+	dst->objval = src->objval;
+	dst->solstat = src->solstat;
+	copy_basis(dst->basis, src->basis, narcs, nnodes);
+}
+
+
+/** Function: print_solution
+ ** The function receives a NET_SOLUTION object and prints the solution stored
+ ** in that object to the standard output stream.
+ **/
+void print_solution(const NET_SOLUTION * solution, int narcs, int nnodes)
+{
+	fprint_solution(stdout, solution, narcs, nnodes);
+}
+
+
+/** Function: fprint_solution
+ ** Same as print_solution but the solution is printed to the given stream.
+ **/
+void fprint_solution(FILE * out, const NET_SOLUTION * solution, int narcs, int nnodes)
+{
+	int i;
+
+	if(!solution || !out) {
+		return;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Printing Solution Data:\n\n");
+
+	fprintf(out, "Objective Value:\t\t%lf\n", solution->objval);
+	fprintf(out, "Objective Status:\t\t%d\n\n", solution->solstat);
+
+	fprintf(out, "Objective Arc Data:\n");
+	for(i = 0; i < narcs; i++) {
+		fprintf(out, "Arc %d\tx: %lf\t reduced cost: %lf\t\tbasis: %d\n", i, solution->x[i], solution->dj[i], solution->basis->arc_basis[i]);
+	}
+
+	fprintf(out, "Objective Node Data:\n");
+	for(i = 0; i < nnodes; i++) {
+		fprintf(out, "Node %d\tpi: %lf\t slack: %lf\t\tbasis: %d\n", i, solution->pi[i], solution->slack[i], solution->basis->node_basis[i]);
+	}
+
+	fprintf(out, "\n");
+}
+
+
+/** Function: create_topology
+ ** Allocates a NET_TOPOLOGY object with room for the given number of arcs and
+ ** nodes. Returns NULL if any allocation fails.
+ **/
+NET_TOPOLOGY * create_topology(int narcs, int nnodes)
+{
+	NET_TOPOLOGY * topo = calloc(1, sizeof(NET_TOPOLOGY));
+	if(!topo) {
+		fprintf(stderr, "Unable to alloc topology.\n");
+		return NULL;
+	}
+
+	topo->narcs = narcs;
+	topo->nnodes = nnodes;
+	topo->tail = malloc((narcs > 0 ? narcs : 1) * sizeof(int));
+	topo->head = malloc((narcs > 0 ? narcs : 1) * sizeof(int));
+	topo->lb = malloc((narcs > 0 ? narcs : 1) * sizeof(double));
+	topo->ub = malloc((narcs > 0 ? narcs : 1) * sizeof(double));
+	topo->supply = malloc((nnodes > 0 ? nnodes : 1) * sizeof(double));
+
+	if(!topo->tail || !topo->head || !topo->lb || !topo->ub || !topo->supply) {
+		fprintf(stderr, "Unable to alloc topology arrays.\n");
+		free_topology(&topo);
+		return NULL;
+	}
+
+	return topo;
+}
+
+
+/** Function: free_topology
+ ** Frees a NET_TOPOLOGY object and its arrays, setting the pointer to NULL.
+ **/
+void free_topology(NET_TOPOLOGY ** topo)
+{
+	if(topo && *topo) {
+		free((*topo)->tail);
+		free((*topo)->head);
+		free((*topo)->lb);
+		free((*topo)->ub);
+		free((*topo)->supply);
+		free(*topo);
+		*topo = NULL;
+	}
+}
+
+
+/** Function: read_network
+ ** Reads the network file into a temporary NET object of the environment and
+ ** copies its data into a new NET_TOPOLOGY object and a new array of arc
+ ** costs, both returned through the pointer arguments. Returns a non-zero
+ ** value if any error is detected, in which case nothing is returned.
+ **/
+int read_network(CPXENVptr env, const char * filename, NET_TOPOLOGY ** topo_p, double ** costs_p)
+{
+	int status = 0;
+	CPXNETptr net = NULL;
+	NET_TOPOLOGY * topo = NULL;
+	double * costs = NULL;
+	int narcs, nnodes;
+
+	if(!env || !filename || !topo_p || !costs_p) {
+		fprintf(stderr, "Unable to read network due to NULL argument.\n");
+		return -1;
+	}
+
+	net = CPXNETcreateprob(env, &status, "network_read");
+	if(!net) {
+		fprintf(stderr, "Unable to create NET problem object.\n");
+		return status ? status : -1;
+	}
+
+	status = CPXNETreadcopyprob(env, net, filename);
+	if(status) {
+		fprintf(stderr, "Unable to read network %s.\n", filename);
+		goto TERMINATE;
+	}
+
+	narcs = CPXNETgetnumarcs(env, net);
+	nnodes = CPXNETgetnumnodes(env, net);
+
+	topo = create_topology(narcs, nnodes);
+	costs = malloc((narcs > 0 ? narcs : 1) * sizeof(double));
+	if(!topo || !costs) {
+		fprintf(stderr, "Unable to alloc network %s.\n", filename);
+		status = -1;
+		goto TERMINATE;
+	}
+
+	if(narcs > 0) {
+		status = CPXNETgetarcnodes(env, net, topo->tail, topo->head, 0, narcs - 1);
+		if(!status) status = CPXNETgetlb(env, net, topo->lb, 0, narcs - 1);
+		if(!status) status = CPXNETgetub(env, net, topo->ub, 0, narcs - 1);
+		if(!status) status = CPXNETgetobj(env, net, costs, 0, narcs - 1);
+	}
+	if(!status && nnodes > 0) {
+		status = CPXNETgetsupply(env, net, topo->supply, 0, nnodes - 1);
+	}
+	if(status) {
+		fprintf(stderr, "Unable to get data of network %s.\n", filename);
+		goto TERMINATE;
+	}
+
+TERMINATE:
+
+	CPXNETfreeprob(env, &net);
+
+	if(status) {
+		free_topology(&topo);
+		free(costs);
+		return status;
+	}
+
+	*topo_p = topo;
+	*costs_p = costs;
+
+	return 0;
+}
+
+
+/** Function: copy_topology_to_lp
+ ** Copies the network given by the topology and the arc costs into the LP
+ ** object, going through a temporary NET object so that the LP has the same
+ ** layout as one built by copy_cplex_problem().
+ **/
+int copy_topology_to_lp(CPXENVptr env, CPXLPptr lp, const NET_TOPOLOGY * topo, const double * costs)
+{
+	int status = 0;
+	CPXNETptr net = NULL;
+
+	if(!env || !lp || !topo || !costs) {
+		fprintf(stderr, "Unable to copy topology due to NULL argument.\n");
+		return -1;
+	}
+
+	net = CPXNETcreateprob(env, &status, "network_copy");
+	if(!net) {
+		fprintf(stderr, "Unable to create NET problem object.\n");
+		return status ? status : -1;
+	}
+
+	status = CPXNETcopynet(env, net, CPX_MIN, topo->nnodes, topo->supply, NULL,
+	                       topo->narcs, topo->tail, topo->head, topo->lb, topo->ub, costs, NULL);
+	if(status) {
+		fprintf(stderr, "Unable to copy topology to NET object.\n");
+		goto TERMINATE;
+	}
+
+	status = CPXcopynettolp(env, lp, net);
+	if(status) {
+		fprintf(stderr, "Unable to copy topology to LP object.\n");
+		goto TERMINATE;
+	}
+
+TERMINATE:
+
+	CPXNETfreeprob(env, &net);
+
+	return status;
+}
+
+
+/** Function: same_topology
+ ** Returns 1 if both topologies have the same arcs, bounds and supplies, so
+ ** that they only differ by their arc costs, and 0 otherwise.
+ **/
+int same_topology(const NET_TOPOLOGY * a, const NET_TOPOLOGY * b)
+{
+	if(!a || !b || a->narcs != b->narcs || a->nnodes != b->nnodes) {
+		return 0;
+	}
+
+	return !memcmp(a->tail, b->tail, a->narcs * sizeof(int)) &&
+	       !memcmp(a->head, b->head, a->narcs * sizeof(int)) &&
+	       !memcmp(a->lb, b->lb, a->narcs * sizeof(double)) &&
+	       !memcmp(a->ub, b->ub, a->narcs * sizeof(double)) &&
+	       !memcmp(a->supply, b->supply, a->nnodes * sizeof(double));
+}
+
+
+/** Function: get_lp_network
+ ** Reads back the network held by an LP object built from a NET object. Every
+ ** column must have exactly two non-zero coefficients, 1 and -1, and every row
+ ** must be an equality. The arc goes from the row with coefficient 1 to the
+ ** row with coefficient -1 and the right-hand side is the supply of the node,
+ ** so the flow problem is the LP itself whatever sign convention was used to
+ ** build it. Returns a non-zero value if the LP is not a network.
+ **/
+int get_lp_network(CPXENVptr env, CPXLPptr lp, NET_TOPOLOGY ** topo_p, double ** costs_p)
+{
+	int status = 0;
+	NET_TOPOLOGY * topo = NULL;
+	double * costs = NULL;
+	char * sense = NULL;
+	int * matbeg = NULL;
+	int * matind = NULL;
+	double * matval = NULL;
+	int narcs, nnodes, nzcnt, surplus;
+	int i, j;
+
+	if(!env || !lp || !topo_p || !costs_p) {
+		return -1;
+	}
+
+	if(CPXgetobjsen(env, lp) != CPX_MIN) {
+		return -1;
+	}
+
+	narcs = CPXgetnumcols(env, lp);
+	nnodes = CPXgetnumrows(env, lp);
+	if(narcs <= 0 || nnodes <= 0) {
+		return -1;
+	}
+
+	topo = create_topology(narcs, nnodes);
+	costs = malloc(narcs * sizeof(double));
+	sense = malloc(nnodes * sizeof(char));
+	matbeg = malloc((narcs + 1) * sizeof(int));
+	matind = malloc(2 * narcs * sizeof(int));
+	matval = malloc(2 * narcs * sizeof(double));
+	if(!topo || !costs || !sense || !matbeg || !matind || !matval) {
+		fprintf(stderr, "Unable to alloc LP network.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	/* a negative surplus means some column has more than two entries */
+	status = CPXgetcols(env, lp, &nzcnt, matbeg, matind, matval, 2 * narcs, &surplus, 0, narcs - 1);
+	if(status || nzcnt != 2 * narcs) {
+		status = -1;
+		goto TERMINATE;
+	}
+	matbeg[narcs] = nzcnt;
+
+	status = CPXgetsense(env, lp, sense, 0, nnodes - 1);
+	if(!status) status = CPXgetrhs(env, lp, topo->supply, 0, nnodes - 1);
+	if(!status) status = CPXgetlb(env, lp, topo->lb, 0, narcs - 1);
+	if(!status) status = CPXgetub(env, lp, topo->ub, 0, narcs - 1);
+	if(!status) status = CPXgetobj(env, lp, costs, 0, narcs - 1);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	for(i = 0; i < nnodes; i++) {
+		if(sense[i] != 'E') {
+			status = -1;
+			goto TERMINATE;
+		}
+	}
+
+	for(j = 0; j < narcs; j++) {
+		int k = matbeg[j];
+
+		if(matbeg[j + 1] - k != 2 || matval[k] != -matval[k + 1] ||
+		   (matval[k] != 1.0 && matval[k] != -1.0)) {
+			status = -1;
+			goto TERMINATE;
+		}
+
+		topo->tail[j] = matval[k] > 0 ? matind[k] : matind[k + 1];
+		topo->head[j] = matval[k] > 0 ? matind[k + 1] : matind[k];
+	}
+
+TERMINATE:
+
+	free(sense);
+	free(matbeg);
+	free(matind);
+	free(matval);
+
+	if(status) {
+		free_topology(&topo);
+		free(costs);
+		return status;
+	}
+
+	*topo_p = topo;
+	*costs_p = costs;
+
+	return 0;
+}
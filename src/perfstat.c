@@ -0,0 +1,330 @@
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "perfstat.h"
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** Description of one hardware event: perf type, config and display name **/
+typedef struct perf_event_desc_struct {
+	unsigned int type;
+	unsigned long long config;
+	const char * name;
+} PERF_EVENT_DESC;
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+static const PERF_EVENT_DESC perf_events[PERF_NEVENTS] = {
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+	{PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+	                     (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+	                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), "L1d-misses"},
+	{PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+	                     (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+	                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), "LLC-misses"},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch-misses"}
+};
+
+static const char * perf_phase_names[PERF_NPHASES] = {
+	"entering_arc", "pivot", "retrieval", "update_solution", "output"
+};
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int open_counter(const PERF_EVENT_DESC *, int);
+static int read_group(const PERF_STATS *, unsigned long long *, unsigned long long *, unsigned long long *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: create_perf_stats
+ ** Opens one group of counters for the calling thread. The first event the
+ ** kernel accepts leads the group so all events are scheduled together. The
+ ** object is returned even if no counter could be opened, in which case only
+ ** wall-clock times are collected. Returns NULL if the allocation fails.
+ **/
+PERF_STATS * create_perf_stats(void)
+{
+	PERF_STATS * perf;
+	int i;
+
+	perf = calloc(1, sizeof(PERF_STATS));
+	if(!perf) {
+		fprintf(stderr, "Unable to alloc performance counters.\n");
+		return NULL;
+	}
+
+	perf->leader = -1;
+	perf->current = -1;
+
+	for(i = 0; i < PERF_NEVENTS; i++) {
+		perf->slot[i] = -1;
+		perf->fds[i] = open_counter(&perf_events[i], perf->leader);
+
+		if(perf->fds[i] < 0) {
+			if(!perf->open_errno) {
+				perf->open_errno = errno;
+			}
+			continue;
+		}
+
+		if(perf->leader < 0) {
+			perf->leader = perf->fds[i];
+		}
+
+		/* values are read back in the order the events joined the group */
+		perf->slot[i] = perf->nopen++;
+	}
+
+	if(perf->leader >= 0) {
+		ioctl(perf->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(perf->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	} else {
+		fprintf(stderr, "Hardware counters unavailable (%s), timing phases only.\n", strerror(perf->open_errno));
+	}
+
+	return perf;
+}
+
+
+/** Function: free_perf_stats
+ ** Closes every counter and frees the object, setting the pointer to NULL.
+ **/
+void free_perf_stats(PERF_STATS ** perf_p)
+{
+	int i;
+
+	if(!perf_p || !*perf_p) {
+		return;
+	}
+
+	for(i = 0; i < PERF_NEVENTS; i++) {
+		if((*perf_p)->fds[i] >= 0) {
+			close((*perf_p)->fds[i]);
+		}
+	}
+
+	free(*perf_p);
+	*perf_p = NULL;
+}
+
+
+/** Function: perf_begin
+ ** Marks the start of the given phase. Phases are not nested: a phase that
+ ** is still open is closed first. Does nothing if perf is NULL.
+ **/
+void perf_begin(PERF_STATS * perf, int phase)
+{
+	if(!perf || phase < 0 || phase >= PERF_NPHASES) {
+		return;
+	}
+
+	if(perf->current >= 0) {
+		perf_end(perf);
+	}
+
+	perf->current = phase;
+
+	/* a counter group that can't be read is dropped for the rest of the run */
+	if(perf->leader >= 0 &&
+	   read_group(perf, perf->start, &perf->start_enabled, &perf->start_running)) {
+		perf->open_errno = errno;
+		perf->leader = -1;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &perf->start_time);
+}
+
+
+/** Function: perf_end
+ ** Closes the phase opened by perf_begin() and adds the counts, scaled by
+ ** the fraction of time the group was actually scheduled, and the elapsed
+ ** time to its totals. Does nothing if perf is NULL.
+ **/
+void perf_end(PERF_STATS * perf)
+{
+	unsigned long long values[PERF_NEVENTS];
+	unsigned long long enabled, running;
+	struct timespec now;
+	PERF_PHASE * phase;
+	int i;
+
+	if(!perf || perf->current < 0) {
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	phase = &perf->phases[perf->current];
+	phase->seconds += (now.tv_sec - perf->start_time.tv_sec) + 1e-9 * (now.tv_nsec - perf->start_time.tv_nsec);
+	phase->calls++;
+	perf->current = -1;
+
+	if(perf->leader < 0 || read_group(perf, values, &enabled, &running)) {
+		return;
+	}
+
+	for(i = 0; i < PERF_NEVENTS; i++) {
+		double delta;
+
+		if(perf->slot[i] < 0) {
+			continue;
+		}
+
+		delta = (double) (values[perf->slot[i]] - perf->start[perf->slot[i]]);
+		if(running > perf->start_running && running - perf->start_running < enabled - perf->start_enabled) {
+			delta *= (double) (enabled - perf->start_enabled) / (double) (running - perf->start_running);
+		}
+
+		phase->counts[i] += (unsigned long long) delta;
+	}
+}
+
+
+/** Function: perf_report
+ ** Prints the totals of every phase, one line per phase, followed by the
+ ** instructions per cycle and the miss rates per thousand instructions. A
+ ** rate whose counter could not be opened is shown as n/a.
+ **/
+void perf_report(FILE * out, const PERF_STATS * perf)
+{
+	static const int misses[3] = {PERF_L1D_MISSES, PERF_LLC_MISSES, PERF_BRANCH_MISSES};
+	int p, i;
+
+	if(!out || !perf) {
+		return;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Performance Counters per Phase:\n\n");
+
+	if(perf->leader < 0) {
+		fprintf(out, "Hardware counters unavailable: %s\n", strerror(perf->open_errno));
+	}
+
+	fprintf(out, "%-16s %10s %12s", "phase", "calls", "seconds");
+	for(i = 0; i < PERF_NEVENTS; i++) {
+		if(perf->slot[i] >= 0) {
+			fprintf(out, " %16s", perf_events[i].name);
+		}
+	}
+	fprintf(out, "\n");
+
+	for(p = 0; p < PERF_NPHASES; p++) {
+		const PERF_PHASE * phase = &perf->phases[p];
+
+		fprintf(out, "%-16s %10lu %12.6lf", perf_phase_names[p], phase->calls, phase->seconds);
+		for(i = 0; i < PERF_NEVENTS; i++) {
+			if(perf->slot[i] >= 0) {
+				fprintf(out, " %16llu", phase->counts[i]);
+			}
+		}
+		fprintf(out, "\n");
+	}
+
+	if(perf->slot[PERF_CYCLES] < 0 || perf->slot[PERF_INSTRUCTIONS] < 0) {
+		fprintf(out, "\n");
+		return;
+	}
+
+	fprintf(out, "\n%-16s %8s %12s %12s %12s\n", "phase", "IPC", "L1d/kinst", "LLC/kinst", "br/kinst");
+	for(p = 0; p < PERF_NPHASES; p++) {
+		const PERF_PHASE * phase = &perf->phases[p];
+		double cycles = (double) phase->counts[PERF_CYCLES];
+		double kinst = (double) phase->counts[PERF_INSTRUCTIONS] / 1000.0;
+
+		if(cycles <= 0.0 || kinst <= 0.0) {
+			continue;
+		}
+
+		fprintf(out, "%-16s %8.3lf", perf_phase_names[p], 1000.0 * kinst / cycles);
+		for(i = 0; i < 3; i++) {
+			if(perf->slot[misses[i]] < 0) {
+				fprintf(out, " %12s", "n/a");
+			} else {
+				fprintf(out, " %12.3lf", phase->counts[misses[i]] / kinst);
+			}
+		}
+		fprintf(out, "\n");
+	}
+
+	fprintf(out, "\n");
+}
+
+
+/** Function: open_counter
+ ** Opens one counter of the calling thread on any CPU as a member of the
+ ** group led by group_fd (or as a new leader if group_fd is -1). Only user
+ ** space is counted: the phases of the loop run there, and unprivileged users
+ ** can't count the kernel at the default perf_event_paranoid level. Returns
+ ** the file descriptor or -1 on failure, with errno set by the kernel.
+ **/
+static int open_counter(const PERF_EVENT_DESC * desc, int group_fd)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = desc->type;
+	attr.config = desc->config;
+	attr.disabled = (group_fd < 0);
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return (int) syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0UL);
+}
+
+
+/** Function: read_group
+ ** Reads every counter of the group with a single read() on the leader.
+ ** Returns a non-zero value if the read failed.
+ **/
+static int read_group(const PERF_STATS * perf, unsigned long long * values,
+                      unsigned long long * enabled, unsigned long long * running)
+{
+	unsigned long long buffer[3 + PERF_NEVENTS];
+	ssize_t size = (ssize_t) ((3 + perf->nopen) * sizeof(unsigned long long));
+	int i;
+
+	if(read(perf->leader, buffer, size) != size) {
+		return 1;
+	}
+
+	*enabled = buffer[1];
+	*running = buffer[2];
+	for(i = 0; i < perf->nopen; i++) {
+		values[i] = buffer[3 + i];
+	}
+
+	return 0;
+}
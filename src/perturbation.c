@@ -0,0 +1,656 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "perturbation.h"
+#include "costscale.h"
+#include "portfolio.h"
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int seed_scaling_basis(CPXENVptr, CPXLPptr);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: get_initial_objective
+ ** The function receives a string with a filename to a file that holds information
+ ** of a network problem and than it solves that problem until an optimal
+ ** solution is reached and returns a pointer to a NET_SOLUTION object with all
+ ** the information of that solution. The engine is one of the ANCHOR_*
+ ** constants, portfolio holds the race settings of ANCHOR_PORTFOLIO, and
+ ** stats, if not NULL, receives how the solve went. If any
+ ** error is detected, the function returns NULL.
+ **/
+NET_SOLUTION * get_initial_objective(const char * net_file, int engine, const PORTFOLIO_SETTINGS * portfolio,
+                                     ANCHOR_STATS * stats)
+{
+	if(!net_file) {
+		return NULL;
+	}
+
+	int status = 0;
+	CPXENVptr	env = NULL;
+	CPXNETptr	net = NULL;
+	CPXLPptr	lp = NULL;
+	NET_SOLUTION * solution = NULL;
+	int narcs, nnodes;
+
+	env = CPXopenCPLEX(&status);
+	if(!env) {
+		char errmsg[CPXMESSAGEBUFSIZE];
+		CPXgeterrorstring(env, status, errmsg);
+		fprintf(stderr, "Unable to start CPLEX free env, %d, %s\n", status, errmsg);
+		goto TERMINATE;
+	}
+
+	net = CPXNETcreateprob(env, &status, "network_free");
+	if(!net) {
+		fprintf(stderr, "Unable to create NET free problem object.\n");
+		goto TERMINATE;
+	}
+
+	lp = CPXcreateprob(env, &status, "lp_free");
+	if(!lp) {
+		fprintf(stderr, "Unable to create LP free problem object.\n");
+		goto TERMINATE;
+	}
+
+	status = CPXNETreadcopyprob(env, net, net_file);
+	if(status) {
+		fprintf(stderr, "Unable to copy problem to NET free object.\n");
+		goto TERMINATE;
+	}
+
+	status = CPXcopynettolp(env, lp, net);
+	if(status) {
+		fprintf(stderr, "Unable to copy free problem.\n");
+		goto TERMINATE;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_SCRIND, CPX_OFF);
+	if(status) {
+		fprintf(stderr, "Unable to set screen output.\n");
+		goto TERMINATE;
+	}
+
+	narcs = CPXgetnumcols(env, lp);
+	nnodes = CPXgetnumrows(env, lp);
+
+	solution = create_solution(narcs, nnodes);
+	if(!solution) {
+		fprintf(stderr, "Error on free solution alloc.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = solve_anchor(env, lp, engine, portfolio, NULL, solution, stats);
+
+TERMINATE:
+
+	/* A partial solution is never handed back to the caller */
+	if(status) {
+		free_solution(&solution);
+	}
+
+	if(net) {
+		CPXNETfreeprob(env, &net);
+		if(net) {
+			fprintf(stderr, "Unable to free NET free problem object.\n");
+		}
+	}
+
+	if(lp) {
+		CPXfreeprob(env, &lp);
+		if(lp) {
+			fprintf(stderr, "Unable to free LP free problem object.\n");
+		}
+	}
+
+	CPXcloseCPLEX(&env);
+	if(env) {
+		fprintf(stderr, "Unable to close CPLEX.\n");
+	}
+
+	return solution;
+}
+
+
+/** Function: get_objective_solution
+ ** Solves the problem held by the given LP object to optimality on a private
+ ** copy, so the iteration limit and the basis of the caller's object are left
+ ** untouched, with the given engine, and returns the solution in a new
+ ** NET_SOLUTION object or NULL if any error is detected. If start is not NULL
+ ** the solve is warm started from that basis.
+ **/
+NET_SOLUTION * get_objective_solution(CPXENVptr env, CPXLPptr lp, int engine, const PORTFOLIO_SETTINGS * portfolio,
+                                      const NET_BASIS * start, ANCHOR_STATS * stats)
+{
+	int status = 0;
+	CPXENVptr penv = NULL;
+	CPXLPptr plp = NULL;
+	NET_SOLUTION * solution = NULL;
+	int narcs, nnodes;
+
+	if(!env || !lp) {
+		fprintf(stderr, "Unable to solve objective.\n");
+		return NULL;
+	}
+
+	penv = CPXopenCPLEX(&status);
+	if(!penv) {
+		char errmsg[CPXMESSAGEBUFSIZE];
+		CPXgeterrorstring(penv, status, errmsg);
+		fprintf(stderr, "Unable to start CPLEX free env, %d, %s\n", status, errmsg);
+		goto TERMINATE;
+	}
+
+	status = CPXsetintparam(penv, CPX_PARAM_SCRIND, CPX_OFF);
+	if(status) {
+		fprintf(stderr, "Unable to set screen output.\n");
+		goto TERMINATE;
+	}
+
+	plp = CPXcloneprob(penv, lp, &status);
+	if(!plp) {
+		fprintf(stderr, "Unable to create LP free problem object.\n");
+		goto TERMINATE;
+	}
+
+	narcs = CPXgetnumcols(env, lp);
+	nnodes = CPXgetnumrows(env, lp);
+
+	solution = create_solution(narcs, nnodes);
+	if(!solution) {
+		fprintf(stderr, "Error on free solution alloc.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = solve_anchor(penv, plp, engine, portfolio, start, solution, stats);
+
+TERMINATE:
+
+	if(status) {
+		free_solution(&solution);
+	}
+
+	if(plp) {
+		CPXfreeprob(penv, &plp);
+		if(plp) {
+			fprintf(stderr, "Unable to free LP free problem object.\n");
+		}
+	}
+
+	CPXcloseCPLEX(&penv);
+	if(penv) {
+		fprintf(stderr, "Unable to close CPLEX.\n");
+	}
+
+	return solution;
+}
+
+
+/** Function: get_perturbation_solution
+ ** The function receives the environments and LP objects of both objective
+ ** functions and the weight w given to the objective function 1, and solves
+ ** the problem Z(x) = w*z1(x) + (1 - w)*z2(x) on a private copy of the first
+ ** LP object with the given engine, warm started from the start basis if it
+ ** is not NULL. The solution, including its basis, is returned in a new
+ ** NET_SOLUTION object or NULL if any error is detected.
+ **/
+NET_SOLUTION * get_perturbation_solution(CPXENVptr env1, CPXENVptr env2, CPXLPptr lp1, CPXLPptr lp2, double weight,
+                                         int engine, const PORTFOLIO_SETTINGS * portfolio, const NET_BASIS * start,
+                                         ANCHOR_STATS * stats)
+{
+	int status = 0;
+	CPXENVptr penv = NULL;
+	CPXLPptr plp = NULL;
+	NET_SOLUTION * solution = NULL;
+
+	double * costs1 = NULL;
+	double * costs2 = NULL;
+	double * costs3 = NULL;
+	int * index_list = NULL;
+	int narcs, nnodes;
+	int i;
+
+	if(!env1 || !env2 || !lp1 || !lp2) {
+		fprintf(stderr, "Unable to perform perturbation.\n");
+		return NULL;
+	}
+
+	penv = CPXopenCPLEX(&status);
+	if(!penv) {
+		char errmsg[CPXMESSAGEBUFSIZE];
+		CPXgeterrorstring(penv, status, errmsg);
+		fprintf(stderr, "Unable to start CPLEX free env, %d, %s\n", status, errmsg);
+		goto TERMINATE;
+	}
+
+	status = CPXsetintparam(penv, CPX_PARAM_SCRIND, CPX_OFF);
+	if(status) {
+		fprintf(stderr, "Unable to set screen output.\n");
+		goto TERMINATE;
+	}
+
+	plp = CPXcloneprob(penv, lp1, &status);
+	if(!plp) {
+		fprintf(stderr, "Unable to create LP free problem object.\n");
+		goto TERMINATE;
+	}
+
+
+	/* Get the number of arcs and nodes ***/
+	narcs = CPXgetnumcols(env1, lp1);
+	nnodes = CPXgetnumrows(env1, lp1);
+
+
+	/* Get the cost arrays for each objective function ***/
+	costs1 = malloc(narcs * sizeof(double));
+	if(!costs1) {
+		fprintf(stderr, "Unable to alloc costs 1 array.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = CPXgetobj(env1, lp1, costs1, 0, narcs - 1);
+	if(status) {
+		fprintf(stderr, "Unable to get objective function 1 costs.\n");
+		goto TERMINATE;
+	}
+
+	costs2 = malloc(narcs * sizeof(double));
+	if(!costs2) {
+		fprintf(stderr, "Unable to alloc costs 2 array.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = CPXgetobj(env2, lp2, costs2, 0, narcs - 1);
+	if(status) {
+		fprintf(stderr, "Unable to get objective function 2 costs.\n");
+		goto TERMINATE;
+	}
+
+	/* Build the new cost array and pass it to the new LP object */
+	costs3 = malloc(narcs * sizeof(double));
+	if(!costs3) {
+		fprintf(stderr, "Unable to alloc costs 3 array.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	index_list = malloc(narcs * sizeof(int));
+	if(!index_list) {
+		fprintf(stderr, "Error on index_list alloc.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	for(i = 0; i < narcs; i++) {
+		costs3[i] = weight * costs1[i] + (1.0 - weight) * costs2[i];
+		index_list[i] = i;
+	}
+
+	status = CPXchgobj(penv, plp, narcs, index_list, costs3);
+	if(status) {
+		fprintf(stderr, "Unable to change objective values.\n");
+		goto TERMINATE;
+	}
+
+	/* Alloc the solution object */
+	solution = create_solution(narcs, nnodes);
+	if(!solution) {
+		fprintf(stderr, "Unable to alloc solution.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	/* Optimize and get the solution with its basis */
+	status = solve_anchor(penv, plp, engine, portfolio, start, solution, stats);
+
+
+TERMINATE:
+
+	if(status) {
+		free_solution(&solution);
+	}
+
+	free(costs1);
+	free(costs2);
+	free(costs3);
+	free(index_list);
+
+	if(plp) {
+		status = CPXfreeprob(penv, &plp);
+		if(status) {
+			fprintf(stderr, "Unable to free LP object.\n");
+		}
+	}
+
+	CPXcloseCPLEX(&penv);
+	if(penv) {
+		fprintf(stderr, "Unable to close CPLEX.\n");
+	}
+
+	return solution;
+}
+
+
+/** Function: get_weighted_solution
+ ** Solves the problem Z(x) = w[0]*z1(x) + ... + w[k-1]*zk(x) for the k cost
+ ** arrays given, blended the way get_perturbation_solution() blends two of
+ ** them. The blend replaces the objective function of the LP object itself,
+ ** which must be private to the caller, so that repeated solves skip the
+ ** copy of the problem. The solve uses the given engine and is warm started
+ ** from the start basis if it is not NULL. The solution, including its
+ ** basis, is returned in a new NET_SOLUTION object or NULL if any error is
+ ** detected.
+ **/
+NET_SOLUTION * get_weighted_solution(CPXENVptr env, CPXLPptr lp, int k, double * const * costs, const double * weights,
+                                     int engine, const PORTFOLIO_SETTINGS * portfolio, const NET_BASIS * start,
+                                     ANCHOR_STATS * stats)
+{
+	int status = 0;
+	NET_SOLUTION * solution = NULL;
+	double * blend = NULL;
+	int * index_list = NULL;
+	int narcs, nnodes;
+	int i, j;
+
+	if(!env || !lp || k < 1 || !costs || !weights) {
+		fprintf(stderr, "Unable to perform weighted solve.\n");
+		return NULL;
+	}
+
+	narcs = CPXgetnumcols(env, lp);
+	nnodes = CPXgetnumrows(env, lp);
+
+	blend = malloc(narcs * sizeof(double));
+	index_list = malloc(narcs * sizeof(int));
+	if(!blend || !index_list) {
+		fprintf(stderr, "Unable to alloc blended costs.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	for(i = 0; i < narcs; i++) {
+		blend[i] = 0.0;
+		for(j = 0; j < k; j++) {
+			blend[i] += weights[j] * costs[j][i];
+		}
+		index_list[i] = i;
+	}
+
+	status = CPXchgobj(env, lp, narcs, index_list, blend);
+	if(status) {
+		fprintf(stderr, "Unable to change objective values.\n");
+		goto TERMINATE;
+	}
+
+	solution = create_solution(narcs, nnodes);
+	if(!solution) {
+		fprintf(stderr, "Unable to alloc solution.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = solve_anchor(env, lp, engine, portfolio, start, solution, stats);
+
+
+TERMINATE:
+
+	if(status) {
+		free_solution(&solution);
+	}
+
+	free(blend);
+	free(index_list);
+
+	return solution;
+}
+
+
+/** Function: anchor_engine_name
+ ** Returns the name of the given anchor engine.
+ **/
+const char * anchor_engine_name(int engine)
+{
+	switch(engine) {
+	case ANCHOR_SCALING:
+		return "scaling";
+	case ANCHOR_DUAL:
+		return "dual";
+	case ANCHOR_NETWORK:
+		return "network";
+	case ANCHOR_BARRIER:
+		return "barrier";
+	case ANCHOR_PORTFOLIO:
+		return "portfolio";
+	default:
+		return "simplex";
+	}
+}
+
+
+/** Function: anchor_engine
+ ** Returns the anchor engine with the given name, or -1 if there is none.
+ **/
+int anchor_engine(const char * name)
+{
+	if(!name) {
+		return -1;
+	}
+
+	if(!strcmp(name, "simplex")) {
+		return ANCHOR_SIMPLEX;
+	}
+
+	if(!strcmp(name, "scaling")) {
+		return ANCHOR_SCALING;
+	}
+
+	if(!strcmp(name, "dual")) {
+		return ANCHOR_DUAL;
+	}
+
+	if(!strcmp(name, "network")) {
+		return ANCHOR_NETWORK;
+	}
+
+	if(!strcmp(name, "barrier")) {
+		return ANCHOR_BARRIER;
+	}
+
+	if(!strcmp(name, "portfolio")) {
+		return ANCHOR_PORTFOLIO;
+	}
+
+	return -1;
+}
+
+
+/** Function: solve_anchor
+ ** Solves the LP object to optimality and stores the solution and its basis.
+ ** With ANCHOR_SCALING the optimal flow is first found by the cost scaling
+ ** engine and turned into a spanning tree basis, so primal simplex starts from
+ ** an optimal flow and only has to fix the degenerate arcs of the tree. If the
+ ** engine can't handle the problem, primal simplex solves it from scratch.
+ ** A start basis replaces the cost scaling one: it stays primal feasible when
+ ** only costs changed since it was optimal and dual feasible when only
+ ** supplies or bounds did, so primal or dual simplex need few pivots from it.
+ ** ANCHOR_NETWORK and ANCHOR_BARRIER hand the whole solve to the network
+ ** simplex or to barrier and crossover, and ANCHOR_PORTFOLIO to the race of
+ ** portfolio_solve() under the given settings; with a start basis all three
+ ** use primal simplex. A solve
+ ** cancelled through CPXsetterminate() returns CPX_STAT_ABORT_USER quietly.
+ **/
+int solve_anchor(CPXENVptr env, CPXLPptr lp, int engine, const PORTFOLIO_SETTINGS * portfolio,
+                 const NET_BASIS * basis, NET_SOLUTION * solution, ANCHOR_STATS * stats)
+{
+	int status = 0;
+	ANCHOR_STATS local;
+	double start, end;
+
+	if(engine == ANCHOR_PORTFOLIO && !basis) {
+		return portfolio_solve(env, lp, portfolio, solution, stats);
+	}
+
+	if(!stats) {
+		stats = &local;
+	}
+	memset(stats, 0, sizeof(ANCHOR_STATS));
+
+	if(basis && engine != ANCHOR_DUAL) {
+		engine = ANCHOR_SIMPLEX;
+	}
+
+	if(basis) {
+		status = CPXsetintparam(env, CPX_PARAM_ADVIND, 1);
+		if(!status) status = CPXsetintparam(env, CPX_PARAM_PREIND, CPX_OFF);
+		if(!status) status = CPXcopybase(env, lp, basis->arc_basis, basis->node_basis);
+		if(status) {
+			fprintf(stderr, "Unable to copy the start basis of the anchor problem.\n");
+			return status;
+		}
+		stats->seeded = 1;
+	} else if(engine == ANCHOR_SCALING) {
+		CPXgettime(env, &start);
+		if(seed_scaling_basis(env, lp)) {
+			fprintf(stderr, "Cost scaling unavailable, the anchor is solved by primal simplex.\n");
+		} else {
+			stats->seeded = 1;
+		}
+		CPXgettime(env, &end);
+		stats->seed_time = end - start;
+	}
+
+	CPXgettime(env, &start);
+	switch(engine) {
+	case ANCHOR_DUAL:
+		status = CPXdualopt(env, lp);
+		break;
+	case ANCHOR_NETWORK:
+		status = CPXhybnetopt(env, lp, CPX_ALG_PRIMAL);
+		break;
+	case ANCHOR_BARRIER:
+		status = CPXbaropt(env, lp);
+		break;
+	default:
+		status = CPXprimopt(env, lp);
+		break;
+	}
+	if(status) {
+		fprintf(stderr, "Error during optimization of anchor problem.\n");
+		return status;
+	}
+	CPXgettime(env, &end);
+
+	if(CPXgetstat(env, lp) == CPX_STAT_ABORT_USER) {
+		return CPX_STAT_ABORT_USER;
+	}
+
+	stats->simplex_time = end - start;
+	stats->iterations = CPXgetitcnt(env, lp);
+
+	status = CPXsolution(env, lp, &(solution->solstat), &(solution->objval),
+		                     solution->x, solution->pi, solution->slack, solution->dj);
+	if(status) {
+		fprintf(stderr, "Unable to get solution.\n");
+		return status;
+	}
+
+	status = CPXgetbase(env, lp, solution->basis->arc_basis, solution->basis->node_basis);
+	if(status) {
+		fprintf(stderr, "Unable to get basis.\n");
+		return status;
+	}
+
+	return 0;
+}
+
+
+/** Function: seed_scaling_basis
+ ** Runs the cost scaling engine on the network held by the LP object and
+ ** copies the spanning tree basis of its flow into the object. Presolve is
+ ** turned off in the environment so the basis is used as it is. Returns a
+ ** non-zero value if no basis was copied.
+ **/
+static int seed_scaling_basis(CPXENVptr env, CPXLPptr lp)
+{
+	int status = 0;
+	NET_TOPOLOGY * topo = NULL;
+	double * costs = NULL;
+	double * x = NULL;
+	double * pi = NULL;
+	int * arc_basis = NULL;
+	int * node_basis = NULL;
+
+	status = get_lp_network(env, lp, &topo, &costs);
+	if(status) {
+		return status;
+	}
+
+	x = malloc(topo->narcs * sizeof(double));
+	pi = malloc(topo->nnodes * sizeof(double));
+	arc_basis = malloc(topo->narcs * sizeof(int));
+	node_basis = malloc(topo->nnodes * sizeof(int));
+	if(!x || !pi || !arc_basis || !node_basis) {
+		fprintf(stderr, "Unable to alloc cost scaling solution.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = cost_scaling_flow(topo, costs, x, pi);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	status = spanning_tree_basis(topo, costs, pi, x, arc_basis, node_basis);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_ADVIND, 1);
+	if(!status) status = CPXsetintparam(env, CPX_PARAM_PREIND, CPX_OFF);
+	if(status) {
+		fprintf(stderr, "Unable to set advanced start parameters.\n");
+		goto TERMINATE;
+	}
+
+	status = CPXcopybase(env, lp, arc_basis, node_basis);
+	if(status) {
+		fprintf(stderr, "Unable to copy cost scaling basis.\n");
+		goto TERMINATE;
+	}
+
+TERMINATE:
+
+	free_topology(&topo);
+	free(costs);
+	free(x);
+	free(pi);
+	free(arc_basis);
+	free(node_basis);
+
+	return status;
+}
@@ -0,0 +1,501 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "perturbation.h"
+#include "portfolio.h"
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The RACE struct is shared by the racers of one anchor solve. The first
+ ** racer to reach an optimal solution stores its index in winner and raises
+ ** cancel, which every racer's environment polls through CPXsetterminate().
+ **/
+typedef struct race_struct {
+	volatile int cancel;
+	atomic_int winner;
+} RACE;
+
+/** The RACER struct is one configuration of the race: its own environment,
+ ** its own copy of the problem and its own solution, so the threads share
+ ** nothing but the RACE.
+ **/
+typedef struct racer_struct {
+	const PORTFOLIO_CONFIG * config;
+	int index;
+	CPXENVptr env;
+	CPXLPptr lp;
+	NET_SOLUTION * solution;
+	ANCHOR_STATS stats;
+	RACE * race;
+	int status;
+} RACER;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int solve_config(CPXENVptr, CPXLPptr, const PORTFOLIO_CONFIG *, NET_SOLUTION *, ANCHOR_STATS *);
+static int race_anchor(CPXENVptr, CPXLPptr, const PORTFOLIO_SETTINGS *, const char *, NET_SOLUTION *,
+                       ANCHOR_STATS *);
+static int open_racer(RACER *, CPXENVptr, CPXLPptr);
+static void close_racer(RACER *);
+static void * run_racer(void *);
+static const PORTFOLIO_CONFIG * lookup_winner(const char *, const char *);
+static int record_winner(const char *, const char *, const char *);
+static int floor_log2(int);
+
+
+
+
+/************************
+ *** Global Variables ***
+ ************************/
+
+/** The configurations raced, in the order they get a thread when there are
+ ** fewer threads than configurations.
+ **/
+static const PORTFOLIO_CONFIG configs[] = {
+	{"network",      ANCHOR_NETWORK, 0, 0},
+	{"primal-devex", ANCHOR_SIMPLEX, CPX_PARAM_PPRIIND, CPX_PPRIIND_DEVEX},
+	{"dual-steep",   ANCHOR_DUAL,    CPX_PARAM_DPRIIND, CPX_DPRIIND_STEEP},
+	{"scaling",      ANCHOR_SCALING, 0, 0},
+	{"barrier",      ANCHOR_BARRIER, 0, 0},
+	{"primal-steep", ANCHOR_SIMPLEX, CPX_PARAM_PPRIIND, CPX_PPRIIND_STEEP},
+	{"primal",       ANCHOR_SIMPLEX, 0, 0},
+	{"dual",         ANCHOR_DUAL,    0, 0}
+};
+#define NCONFIGS ((int) (sizeof(configs) / sizeof(PORTFOLIO_CONFIG)))
+
+/** Keeps the anchor solves of several threads of this process from rewriting
+ ** a database at the same time.
+ **/
+static pthread_mutex_t database_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: portfolio_solve
+ ** Solves the anchor problem with the configuration recorded for its instance
+ ** class in the database. If there is none, or if it fails, the configurations
+ ** race on their own threads and environments: the first to find an optimal
+ ** solution wins, the others are cancelled, and the winner is recorded for the
+ ** class. The settings give the database, NULL for none, and how many
+ ** configurations race at once. The solution and stats are those of the
+ ** winner.
+ **/
+int portfolio_solve(CPXENVptr env, CPXLPptr lp, const PORTFOLIO_SETTINGS * settings,
+                    NET_SOLUTION * solution, ANCHOR_STATS * stats)
+{
+	const PORTFOLIO_CONFIG * config = NULL;
+	char key[PORTFOLIO_LINE];
+	int status;
+
+	key[0] = '\0';
+	if(settings && settings->database && !portfolio_class(env, lp, key, sizeof(key))) {
+		config = lookup_winner(settings->database, key);
+	}
+
+	if(config) {
+		status = solve_config(env, lp, config, solution, stats);
+		if(!status && solution->solstat == CPX_STAT_OPTIMAL) {
+			return 0;
+		}
+		fprintf(stderr, "Configuration %s failed on class %s, racing the portfolio.\n", config->name, key);
+	}
+
+	return race_anchor(env, lp, settings, key, solution, stats);
+}
+
+
+/** Function: portfolio_class
+ ** Writes the instance class of the problem to key: the binary orders of
+ ** magnitude of its number of arcs and of nodes, and whether any arc has a
+ ** finite capacity. Returns a non-zero value on error.
+ **/
+int portfolio_class(CPXENVptr env, CPXLPptr lp, char * key, size_t size)
+{
+	int narcs = CPXgetnumcols(env, lp);
+	int nnodes = CPXgetnumrows(env, lp);
+	int capacitated = 0;
+	double * ub;
+	int j;
+
+	if(narcs > 0) {
+		ub = malloc(narcs * sizeof(double));
+		if(!ub) {
+			fprintf(stderr, "Unable to alloc arc capacities.\n");
+			return -1;
+		}
+
+		if(CPXgetub(env, lp, ub, 0, narcs - 1)) {
+			fprintf(stderr, "Unable to get arc capacities.\n");
+			free(ub);
+			return -1;
+		}
+
+		for(j = 0; j < narcs && !capacitated; j++) {
+			capacitated = ub[j] < CPX_INFBOUND;
+		}
+		free(ub);
+	}
+
+	snprintf(key, size, "arcs%d-nodes%d-%s", floor_log2(narcs), floor_log2(nnodes),
+	         capacitated ? "cap" : "uncap");
+
+	return 0;
+}
+
+
+/** Function: solve_config
+ ** Solves the problem with one configuration. The parameter it sets is put
+ ** back afterwards, so later solves in the same environment are unaffected.
+ **/
+static int solve_config(CPXENVptr env, CPXLPptr lp, const PORTFOLIO_CONFIG * config,
+                        NET_SOLUTION * solution, ANCHOR_STATS * stats)
+{
+	ANCHOR_STATS local;
+	int saved = 0;
+	int status;
+
+	if(!stats) {
+		stats = &local;
+	}
+
+	if(config->param) {
+		status = CPXgetintparam(env, config->param, &saved);
+		if(!status) status = CPXsetintparam(env, config->param, config->value);
+		if(status) {
+			fprintf(stderr, "Unable to set the parameters of configuration %s.\n", config->name);
+			return status;
+		}
+	}
+
+	status = solve_anchor(env, lp, config->engine, NULL, NULL, solution, stats);
+	stats->config = config->name;
+
+	if(config->param) {
+		CPXsetintparam(env, config->param, saved);
+	}
+
+	return status;
+}
+
+
+/** Function: race_anchor
+ ** Races as many configurations as there are threads. Every racer gets a
+ ** private environment and a clone of the problem, both made here before any
+ ** thread starts, and the racers that can't be started are left out. With a
+ ** single thread the first configuration solves the problem alone and nothing
+ ** is recorded.
+ **/
+static int race_anchor(CPXENVptr env, CPXLPptr lp, const PORTFOLIO_SETTINGS * settings, const char * key,
+                       NET_SOLUTION * solution, ANCHOR_STATS * stats)
+{
+	RACE race;
+	RACER racers[NCONFIGS];
+	pthread_t threads[NCONFIGS];
+	int created[NCONFIGS];
+	int nracers = settings && settings->threads > 1 ? settings->threads : 1;
+	int started = 0;
+	int status = 0;
+	int winner;
+	int i;
+
+	if(nracers > NCONFIGS) {
+		nracers = NCONFIGS;
+	}
+
+	if(nracers < 2) {
+		return solve_config(env, lp, &configs[0], solution, stats);
+	}
+
+	race.cancel = 0;
+	atomic_init(&race.winner, -1);
+	memset(racers, 0, sizeof(racers));
+	memset(created, 0, sizeof(created));
+
+	for(i = 0; i < nracers; i++) {
+		racers[i].config = &configs[i];
+		racers[i].index = i;
+		racers[i].race = &race;
+		if(open_racer(&racers[i], env, lp)) {
+			close_racer(&racers[i]);
+		}
+	}
+
+	for(i = 0; i < nracers; i++) {
+		if(!racers[i].env) {
+			continue;
+		}
+		if(pthread_create(&threads[i], NULL, run_racer, &racers[i])) {
+			fprintf(stderr, "Unable to start the %s racer.\n", racers[i].config->name);
+			continue;
+		}
+		created[i] = 1;
+		started++;
+	}
+
+	/* without any thread the first racer still solves the problem */
+	if(!started && racers[0].env) {
+		run_racer(&racers[0]);
+	}
+
+	for(i = 0; i < nracers; i++) {
+		if(created[i]) {
+			pthread_join(threads[i], NULL);
+		}
+	}
+
+	winner = atomic_load(&race.winner);
+	if(winner < 0) {
+		fprintf(stderr, "No configuration of the portfolio solved the anchor problem.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	copy_solution(solution, racers[winner].solution, CPXgetnumcols(env, lp), CPXgetnumrows(env, lp));
+	if(stats) {
+		*stats = racers[winner].stats;
+	}
+
+	if(key[0]) {
+		record_winner(settings->database, key, racers[winner].config->name);
+	}
+
+TERMINATE:
+
+	for(i = 0; i < nracers; i++) {
+		close_racer(&racers[i]);
+	}
+
+	return status;
+}
+
+
+/** Function: open_racer
+ ** Opens the racer's environment, single threaded and silent, clones the
+ ** problem into it and ties its termination to the cancel flag of the race.
+ **/
+static int open_racer(RACER * racer, CPXENVptr env, CPXLPptr lp)
+{
+	int status = 0;
+
+	racer->env = CPXopenCPLEX(&status);
+	if(!racer->env) {
+		fprintf(stderr, "Unable to start CPLEX env of the %s racer.\n", racer->config->name);
+		return status ? status : -1;
+	}
+
+	status = CPXsetintparam(racer->env, CPX_PARAM_SCRIND, CPX_OFF);
+	if(!status) status = CPXsetintparam(racer->env, CPX_PARAM_THREADS, 1);
+	if(!status) status = CPXsetterminate(racer->env, &racer->race->cancel);
+	if(status) {
+		fprintf(stderr, "Unable to set the parameters of the %s racer.\n", racer->config->name);
+		return status;
+	}
+
+	racer->lp = CPXcloneprob(racer->env, lp, &status);
+	if(!racer->lp) {
+		fprintf(stderr, "Unable to clone the problem of the %s racer.\n", racer->config->name);
+		return status ? status : -1;
+	}
+
+	racer->solution = create_solution(CPXgetnumcols(env, lp), CPXgetnumrows(env, lp));
+	if(!racer->solution) {
+		fprintf(stderr, "Unable to alloc the solution of the %s racer.\n", racer->config->name);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/** Function: close_racer
+ ** Frees what open_racer() made, also after a partial failure.
+ **/
+static void close_racer(RACER * racer)
+{
+	free_solution(&racer->solution);
+
+	if(racer->lp) {
+		CPXfreeprob(racer->env, &racer->lp);
+	}
+
+	if(racer->env) {
+		CPXcloseCPLEX(&racer->env);
+		if(racer->env) {
+			fprintf(stderr, "Unable to close CPLEX.\n");
+		}
+		racer->env = NULL;
+	}
+}
+
+
+/** Function: run_racer
+ ** Thread routine of one racer. An optimal solution claims the win unless
+ ** another racer claimed it first, and the win cancels the other racers.
+ **/
+static void * run_racer(void * data)
+{
+	RACER * racer = data;
+	int expected = -1;
+
+	racer->status = solve_config(racer->env, racer->lp, racer->config, racer->solution, &racer->stats);
+
+	if(!racer->status && racer->solution->solstat == CPX_STAT_OPTIMAL &&
+	   atomic_compare_exchange_strong(&racer->race->winner, &expected, racer->index)) {
+		racer->race->cancel = 1;
+	}
+
+	return NULL;
+}
+
+
+/** Function: lookup_winner
+ ** Returns the configuration recorded for the class in the database, or NULL
+ ** if the class, or the database itself, is not there yet.
+ **/
+static const PORTFOLIO_CONFIG * lookup_winner(const char * database, const char * key)
+{
+	const PORTFOLIO_CONFIG * config = NULL;
+	char line[PORTFOLIO_LINE];
+	char name[PORTFOLIO_LINE];
+	char cls[PORTFOLIO_LINE];
+	FILE * in;
+	int i;
+
+	pthread_mutex_lock(&database_lock);
+
+	in = fopen(database, "r");
+	if(!in) {
+		goto TERMINATE;
+	}
+
+	while(!config && fgets(line, sizeof(line), in)) {
+		if(sscanf(line, "%127s %127s", cls, name) != 2 || strcmp(cls, key)) {
+			continue;
+		}
+		for(i = 0; i < NCONFIGS; i++) {
+			if(!strcmp(configs[i].name, name)) {
+				config = &configs[i];
+				break;
+			}
+		}
+	}
+
+	fclose(in);
+
+TERMINATE:
+
+	pthread_mutex_unlock(&database_lock);
+
+	return config;
+}
+
+
+/** Function: record_winner
+ ** Records the winning configuration of the class in the database, replacing
+ ** the one recorded before. The new database is written next to the old one
+ ** and renamed over it, so a reader never sees half of it.
+ **/
+static int record_winner(const char * database, const char * key, const char * name)
+{
+	char line[PORTFOLIO_LINE];
+	char cls[PORTFOLIO_LINE];
+	char * path = NULL;
+	size_t length = strlen(database) + 32;
+	FILE * in = NULL;
+	FILE * out = NULL;
+	int status = 0;
+
+	pthread_mutex_lock(&database_lock);
+
+	path = malloc(length);
+	if(!path) {
+		fprintf(stderr, "Unable to alloc portfolio database name.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+	snprintf(path, length, "%s.%ld", database, (long) getpid());
+
+	out = fopen(path, "w");
+	if(!out) {
+		fprintf(stderr, "Unable to create portfolio database %s.\n", path);
+		status = -1;
+		goto TERMINATE;
+	}
+
+	in = fopen(database, "r");
+	while(in && fgets(line, sizeof(line), in)) {
+		if(sscanf(line, "%127s", cls) == 1 && !strcmp(cls, key)) {
+			continue;
+		}
+		fputs(line, out);
+	}
+	fprintf(out, "%s %s\n", key, name);
+
+	status = fclose(out);
+	out = NULL;
+	if(!status) {
+		status = rename(path, database);
+	}
+	if(status) {
+		fprintf(stderr, "Unable to update portfolio database %s.\n", database);
+		remove(path);
+	}
+
+TERMINATE:
+
+	if(in) {
+		fclose(in);
+	}
+	if(out) {
+		fclose(out);
+	}
+	free(path);
+
+	pthread_mutex_unlock(&database_lock);
+
+	return status;
+}
+
+
+/** Function: floor_log2
+ ** Returns the binary order of magnitude of n, 0 for n <= 1.
+ **/
+static int floor_log2(int n)
+{
+	int k = 0;
+
+	while(n > 1) {
+		n >>= 1;
+		k++;
+	}
+
+	return k;
+}
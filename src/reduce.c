@@ -0,0 +1,666 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "reduce.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+#define REDUCE_TOL 1e-9
+
+/** Maximum number of rounds of the series and parallel rules. Each rule may
+ ** expose new candidates for the other, e.g. contracting two chains between
+ ** the same pair of nodes yields parallel arcs.
+ **/
+#define REDUCE_MAX_ROUNDS 16
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** Working state of the reduction: the data of every slot and the supplies
+ ** of the nodes, updated as the rules are applied.
+ **/
+typedef struct reduce_work_struct {
+	NET_REDUCTION * red;
+	int * tail;
+	int * head;
+	double * lb;
+	double * ub;
+	double * c1;
+	double * c2;
+	char * alive;
+	double * supply;
+	int nnodes;
+	int capacity;
+} REDUCE_WORK;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int new_slot(REDUCE_WORK *, int, int, double, double, double, double);
+static void fix_slot(REDUCE_WORK *, int, double);
+static int series_round(REDUCE_WORK *);
+static int parallel_round(REDUCE_WORK *);
+static int build_reduced(REDUCE_WORK *);
+static int compare_arcs(const void *, const void *);
+static double add_bounds(double, double);
+
+/* slot data read by compare_arcs(), only valid during parallel_round() */
+static __thread const REDUCE_WORK * sort_work = NULL;
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: reduce_network
+ ** Applies the fixing, series and parallel rules described in reduce.h to
+ ** the network given by the topology and the costs of both objectives, and
+ ** returns the reduced network with its mapping. Returns NULL if any
+ ** allocation fails.
+ **/
+NET_REDUCTION * reduce_network(const NET_TOPOLOGY * topo, const double * costs1, const double * costs2)
+{
+	REDUCE_WORK work;
+	NET_REDUCTION * red = NULL;
+	int capacity, i, round, changed;
+	int status = 0;
+
+	if(!topo || !costs1 || !costs2) {
+		fprintf(stderr, "Unable to reduce network due to NULL argument.\n");
+		return NULL;
+	}
+
+	memset(&work, 0, sizeof(REDUCE_WORK));
+
+	/* every rule creates at most one slot per slot it removes */
+	capacity = 2 * topo->narcs + 1;
+
+	red = calloc(1, sizeof(NET_REDUCTION));
+	if(!red) {
+		fprintf(stderr, "Unable to alloc network reduction.\n");
+		return NULL;
+	}
+
+	red->orig_narcs = topo->narcs;
+	red->orig_nnodes = topo->nnodes;
+	red->kind = malloc(capacity * sizeof(int));
+	red->parent = malloc(capacity * sizeof(int));
+	red->reduced = malloc(capacity * sizeof(int));
+	red->first_member = malloc(capacity * sizeof(int));
+	red->next_member = malloc(capacity * sizeof(int));
+	red->value = calloc(capacity, sizeof(double));
+	red->member_lb = calloc(capacity, sizeof(double));
+	red->member_ub = calloc(capacity, sizeof(double));
+	red->node_map = malloc((topo->nnodes > 0 ? topo->nnodes : 1) * sizeof(int));
+
+	work.red = red;
+	work.capacity = capacity;
+	work.nnodes = topo->nnodes;
+	work.tail = malloc(capacity * sizeof(int));
+	work.head = malloc(capacity * sizeof(int));
+	work.lb = malloc(capacity * sizeof(double));
+	work.ub = malloc(capacity * sizeof(double));
+	work.c1 = malloc(capacity * sizeof(double));
+	work.c2 = malloc(capacity * sizeof(double));
+	work.alive = malloc(capacity * sizeof(char));
+	work.supply = malloc((topo->nnodes > 0 ? topo->nnodes : 1) * sizeof(double));
+
+	if(!red->kind || !red->parent || !red->reduced || !red->first_member || !red->next_member ||
+	   !red->value || !red->member_lb || !red->member_ub || !red->node_map ||
+	   !work.tail || !work.head || !work.lb || !work.ub || !work.c1 || !work.c2 ||
+	   !work.alive || !work.supply) {
+		fprintf(stderr, "Unable to alloc network reduction arrays.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	memcpy(work.supply, topo->supply, topo->nnodes * sizeof(double));
+
+	for(i = 0; i < topo->narcs; i++) {
+		new_slot(&work, topo->tail[i], topo->head[i], topo->lb[i], topo->ub[i], costs1[i], costs2[i]);
+	}
+
+	/* Arcs whose flow can only take one value are fixed first */
+	for(i = 0; i < topo->narcs; i++) {
+		if(work.ub[i] < CPX_INFBOUND && work.ub[i] - work.lb[i] <= REDUCE_TOL) {
+			fix_slot(&work, i, work.lb[i]);
+			red->nfixed++;
+		}
+	}
+
+	for(round = 0; round < REDUCE_MAX_ROUNDS; round++) {
+		changed = series_round(&work);
+
+		status = parallel_round(&work);
+		if(status < 0) {
+			goto TERMINATE;
+		}
+		changed |= status;
+		status = 0;
+
+		if(!changed) {
+			break;
+		}
+	}
+
+	status = build_reduced(&work);
+
+TERMINATE:
+
+	free(work.tail);
+	free(work.head);
+	free(work.lb);
+	free(work.ub);
+	free(work.c1);
+	free(work.c2);
+	free(work.alive);
+	free(work.supply);
+
+	if(status) {
+		free_reduction(&red);
+	}
+
+	return red;
+}
+
+
+/** Function: free_reduction
+ ** Frees the reduction, including the reduced network, and sets the pointer
+ ** to NULL.
+ **/
+void free_reduction(NET_REDUCTION ** red_p)
+{
+	NET_REDUCTION * red;
+
+	if(!red_p || !*red_p) {
+		return;
+	}
+
+	red = *red_p;
+
+	free(red->kind);
+	free(red->parent);
+	free(red->reduced);
+	free(red->first_member);
+	free(red->next_member);
+	free(red->value);
+	free(red->member_lb);
+	free(red->member_ub);
+	free(red->node_map);
+	free(red->costs1);
+	free(red->costs2);
+	free_topology(&red->topo);
+
+	free(red);
+	*red_p = NULL;
+}
+
+
+/** Function: expand_flow
+ ** Maps the flow x of the reduced network back to the original arcs. The
+ ** slots are visited from the last one created, so the flow of a parent is
+ ** always known before its children. The array slot_flow is scratch space of
+ ** red->nslots entries and x_orig receives red->orig_narcs values.
+ **/
+void expand_flow(const NET_REDUCTION * red, const double * x, double * slot_flow, double * x_orig)
+{
+	int s, m;
+
+	if(!red || !x || !slot_flow || !x_orig) {
+		return;
+	}
+
+	for(s = red->nslots - 1; s >= 0; s--) {
+		switch(red->kind[s]) {
+		case REDUCE_KEPT:
+			slot_flow[s] = x[red->reduced[s]];
+			break;
+		case REDUCE_SERIES:
+			slot_flow[s] = slot_flow[red->parent[s]];
+			break;
+		case REDUCE_FIXED:
+			slot_flow[s] = red->value[s];
+			break;
+		default:
+			/* REDUCE_MEMBER, already set by its parent */
+			break;
+		}
+
+		/* Share the flow of a merged arc: every member gets its lower bound
+		 * and the remaining flow fills the members in order.
+		 */
+		if(red->first_member[s] >= 0) {
+			double rest = slot_flow[s];
+
+			for(m = red->first_member[s]; m >= 0; m = red->next_member[m]) {
+				rest -= red->member_lb[m];
+			}
+
+			for(m = red->first_member[s]; m >= 0; m = red->next_member[m]) {
+				double room = red->member_ub[m] - red->member_lb[m];
+				double share = (rest < room) ? rest : room;
+
+				if(share < 0.0) {
+					share = 0.0;
+				}
+
+				slot_flow[m] = red->member_lb[m] + share;
+				rest -= share;
+			}
+		}
+	}
+
+	memcpy(x_orig, slot_flow, red->orig_narcs * sizeof(double));
+}
+
+
+/** Function: print_reduction
+ ** Prints the size of the original and reduced networks and the number of
+ ** times each rule was applied.
+ **/
+void print_reduction(FILE * out, const NET_REDUCTION * red)
+{
+	double arcs_pct = 0.0, nodes_pct = 0.0;
+
+	if(!out || !red) {
+		return;
+	}
+
+	if(red->orig_narcs > 0) {
+		arcs_pct = 100.0 * (red->orig_narcs - red->topo->narcs) / red->orig_narcs;
+	}
+	if(red->orig_nnodes > 0) {
+		nodes_pct = 100.0 * (red->orig_nnodes - red->topo->nnodes) / red->orig_nnodes;
+	}
+
+	fprintf(out, "Network reduction: %d -> %d arcs (-%.1lf%%), %d -> %d nodes (-%.1lf%%)\n",
+	        red->orig_narcs, red->topo->narcs, arcs_pct, red->orig_nnodes, red->topo->nnodes, nodes_pct);
+	fprintf(out, "  series contractions: %d, parallel merges: %d, dominated arcs: %d, fixed arcs: %d\n",
+	        red->nseries, red->nparallel, red->ndominated, red->nfixed);
+}
+
+
+/** Function: new_slot
+ ** Appends a live slot with the given arc data and returns its index.
+ **/
+static int new_slot(REDUCE_WORK * work, int tail, int head, double lb, double ub, double c1, double c2)
+{
+	NET_REDUCTION * red = work->red;
+	int s = red->nslots++;
+
+	red->kind[s] = REDUCE_KEPT;
+	red->parent[s] = -1;
+	red->reduced[s] = -1;
+	red->first_member[s] = -1;
+	red->next_member[s] = -1;
+
+	work->tail[s] = tail;
+	work->head[s] = head;
+	work->lb[s] = lb;
+	work->ub[s] = ub;
+	work->c1[s] = c1;
+	work->c2[s] = c2;
+	work->alive[s] = 1;
+
+	return s;
+}
+
+
+/** Function: fix_slot
+ ** Fixes the flow of a live slot, moving it out of the network: the supplies
+ ** of its end nodes and the objective offsets absorb the fixed flow.
+ **/
+static void fix_slot(REDUCE_WORK * work, int s, double flow)
+{
+	NET_REDUCTION * red = work->red;
+
+	red->kind[s] = REDUCE_FIXED;
+	red->value[s] = flow;
+	work->alive[s] = 0;
+
+	work->supply[work->tail[s]] -= flow;
+	work->supply[work->head[s]] += flow;
+
+	red->offset1 += work->c1[s] * flow;
+	red->offset2 += work->c2[s] * flow;
+}
+
+
+/** Function: series_round
+ ** Contracts every transit node, i.e., a node with zero supply, one incoming
+ ** and one outgoing arc. Chains are contracted in a single round as the arcs
+ ** of the neighbour nodes are updated on the fly. Returns 1 if any node was
+ ** contracted.
+ **/
+static int series_round(REDUCE_WORK * work)
+{
+	NET_REDUCTION * red = work->red;
+	int * indeg = calloc(work->nnodes, sizeof(int));
+	int * outdeg = calloc(work->nnodes, sizeof(int));
+	int * in_arc = malloc(work->nnodes * sizeof(int));
+	int * out_arc = malloc(work->nnodes * sizeof(int));
+	int changed = 0;
+	int s, v;
+
+	if(!indeg || !outdeg || !in_arc || !out_arc) {
+		goto TERMINATE;
+	}
+
+	for(s = 0; s < red->nslots; s++) {
+		if(!work->alive[s]) {
+			continue;
+		}
+		outdeg[work->tail[s]]++;
+		out_arc[work->tail[s]] = s;
+		indeg[work->head[s]]++;
+		in_arc[work->head[s]] = s;
+	}
+
+	for(v = 0; v < work->nnodes; v++) {
+		int a, b, u, w, c;
+		double lb, ub;
+
+		if(indeg[v] != 1 || outdeg[v] != 1 || fabs(work->supply[v]) > REDUCE_TOL) {
+			continue;
+		}
+
+		a = in_arc[v];
+		b = out_arc[v];
+		u = work->tail[a];
+		w = work->head[b];
+
+		/* self loops and two-node cycles are left alone */
+		if(a == b || u == w) {
+			continue;
+		}
+
+		lb = (work->lb[a] > work->lb[b]) ? work->lb[a] : work->lb[b];
+		ub = (work->ub[a] < work->ub[b]) ? work->ub[a] : work->ub[b];
+		if(lb > ub + REDUCE_TOL) {
+			continue;
+		}
+
+		c = new_slot(work, u, w, lb, ub, work->c1[a] + work->c1[b], work->c2[a] + work->c2[b]);
+
+		red->kind[a] = REDUCE_SERIES;
+		red->kind[b] = REDUCE_SERIES;
+		red->parent[a] = c;
+		red->parent[b] = c;
+		work->alive[a] = 0;
+		work->alive[b] = 0;
+
+		if(out_arc[u] == a) {
+			out_arc[u] = c;
+		}
+		if(in_arc[w] == b) {
+			in_arc[w] = c;
+		}
+		indeg[v] = 0;
+		outdeg[v] = 0;
+
+		red->nseries++;
+		changed = 1;
+	}
+
+TERMINATE:
+
+	free(indeg);
+	free(outdeg);
+	free(in_arc);
+	free(out_arc);
+
+	return changed;
+}
+
+
+/** Function: parallel_round
+ ** Groups the live arcs by their end nodes. Inside a group, an arc dominated
+ ** in both objectives by an uncapacitated arc is fixed at its lower bound and
+ ** arcs with equal costs in both objectives are merged into one. Returns 1 if
+ ** any arc was removed, 0 if none was and -1 on allocation failure.
+ **/
+static int parallel_round(REDUCE_WORK * work)
+{
+	NET_REDUCTION * red = work->red;
+	int * arcs = malloc((red->nslots > 0 ? red->nslots : 1) * sizeof(int));
+	int narcs = 0;
+	int changed = 0;
+	int s, i, j, k, start, end;
+
+	if(!arcs) {
+		fprintf(stderr, "Unable to alloc parallel arcs array.\n");
+		return -1;
+	}
+
+	for(s = 0; s < red->nslots; s++) {
+		if(work->alive[s]) {
+			arcs[narcs++] = s;
+		}
+	}
+
+	sort_work = work;
+	qsort(arcs, narcs, sizeof(int), compare_arcs);
+	sort_work = NULL;
+
+	for(start = 0; start < narcs; start = end) {
+		end = start + 1;
+		while(end < narcs && work->tail[arcs[end]] == work->tail[arcs[start]] &&
+		      work->head[arcs[end]] == work->head[arcs[start]]) {
+			end++;
+		}
+
+		if(end - start < 2) {
+			continue;
+		}
+
+		/* Dominated arcs: any flow above the lower bound of j can be moved
+		 * to the uncapacitated arc i, improving one objective and worsening
+		 * none, so j is at its lower bound in every efficient solution.
+		 */
+		for(j = start; j < end; j++) {
+			int b = arcs[j];
+
+			for(i = start; i < end && work->alive[b]; i++) {
+				int a = arcs[i];
+
+				if(a == b || !work->alive[a] || work->ub[a] < CPX_INFBOUND) {
+					continue;
+				}
+
+				if(work->c1[a] <= work->c1[b] && work->c2[a] <= work->c2[b] &&
+				   (work->c1[a] < work->c1[b] || work->c2[a] < work->c2[b])) {
+					fix_slot(work, b, work->lb[b]);
+					red->ndominated++;
+					changed = 1;
+				}
+			}
+		}
+
+		/* Equal costs: the arcs are sorted by costs inside the group */
+		for(i = start; i < end; i = k) {
+			int a = arcs[i];
+			int g, last;
+
+			k = i + 1;
+			if(!work->alive[a]) {
+				continue;
+			}
+
+			while(k < end && (!work->alive[arcs[k]] ||
+			      (work->c1[arcs[k]] == work->c1[a] && work->c2[arcs[k]] == work->c2[a]))) {
+				k++;
+			}
+
+			last = -1;
+			for(j = i; j < k; j++) {
+				if(work->alive[arcs[j]]) {
+					last = j;
+				}
+			}
+			if(last == i) {
+				continue;
+			}
+
+			g = new_slot(work, work->tail[a], work->head[a], 0.0, 0.0, work->c1[a], work->c2[a]);
+
+			last = -1;
+			for(j = i; j < k; j++) {
+				int m = arcs[j];
+
+				if(!work->alive[m]) {
+					continue;
+				}
+
+				work->lb[g] += work->lb[m];
+				work->ub[g] = add_bounds(work->ub[g], work->ub[m]);
+
+				red->kind[m] = REDUCE_MEMBER;
+				red->parent[m] = g;
+				red->member_lb[m] = work->lb[m];
+				red->member_ub[m] = work->ub[m];
+				work->alive[m] = 0;
+
+				if(last < 0) {
+					red->first_member[g] = m;
+				} else {
+					red->next_member[last] = m;
+					red->nparallel++;
+				}
+				last = m;
+			}
+
+			changed = 1;
+		}
+	}
+
+	free(arcs);
+
+	return changed;
+}
+
+
+/** Function: build_reduced
+ ** Renumbers the live slots and the nodes still in use and copies them into
+ ** the reduced topology and cost arrays of the reduction.
+ **/
+static int build_reduced(REDUCE_WORK * work)
+{
+	NET_REDUCTION * red = work->red;
+	char * used = calloc(work->nnodes > 0 ? work->nnodes : 1, sizeof(char));
+	int narcs = 0, nnodes = 0;
+	int s, v, a;
+
+	if(!used) {
+		fprintf(stderr, "Unable to alloc node flags.\n");
+		return -1;
+	}
+
+	for(s = 0; s < red->nslots; s++) {
+		if(work->alive[s]) {
+			used[work->tail[s]] = 1;
+			used[work->head[s]] = 1;
+			narcs++;
+		}
+	}
+
+	/* nodes left without arcs are dropped unless they still have a supply,
+	 * which keeps an infeasible problem infeasible
+	 */
+	for(v = 0; v < work->nnodes; v++) {
+		if(used[v] || fabs(work->supply[v]) > REDUCE_TOL) {
+			red->node_map[v] = nnodes++;
+		} else {
+			red->node_map[v] = -1;
+		}
+	}
+
+	free(used);
+
+	red->topo = create_topology(narcs, nnodes);
+	red->costs1 = malloc((narcs > 0 ? narcs : 1) * sizeof(double));
+	red->costs2 = malloc((narcs > 0 ? narcs : 1) * sizeof(double));
+	if(!red->topo || !red->costs1 || !red->costs2) {
+		fprintf(stderr, "Unable to alloc reduced network.\n");
+		return -1;
+	}
+
+	for(v = 0; v < work->nnodes; v++) {
+		if(red->node_map[v] >= 0) {
+			red->topo->supply[red->node_map[v]] = work->supply[v];
+		}
+	}
+
+	a = 0;
+	for(s = 0; s < red->nslots; s++) {
+		if(!work->alive[s]) {
+			continue;
+		}
+
+		red->reduced[s] = a;
+		red->topo->tail[a] = red->node_map[work->tail[s]];
+		red->topo->head[a] = red->node_map[work->head[s]];
+		red->topo->lb[a] = work->lb[s];
+		red->topo->ub[a] = work->ub[s];
+		red->costs1[a] = work->c1[s];
+		red->costs2[a] = work->c2[s];
+		a++;
+	}
+
+	return 0;
+}
+
+
+/** Function: compare_arcs
+ ** qsort comparison of slot indices by tail, head and both costs.
+ **/
+static int compare_arcs(const void * pa, const void * pb)
+{
+	int a = *(const int *) pa;
+	int b = *(const int *) pb;
+	const REDUCE_WORK * w = sort_work;
+
+	if(w->tail[a] != w->tail[b]) return (w->tail[a] < w->tail[b]) ? -1 : 1;
+	if(w->head[a] != w->head[b]) return (w->head[a] < w->head[b]) ? -1 : 1;
+	if(w->c1[a] != w->c1[b]) return (w->c1[a] < w->c1[b]) ? -1 : 1;
+	if(w->c2[a] != w->c2[b]) return (w->c2[a] < w->c2[b]) ? -1 : 1;
+
+	return (a < b) ? -1 : (a > b);
+}
+
+
+/** Function: add_bounds
+ ** Adds two upper bounds, keeping CPX_INFBOUND as infinity.
+ **/
+static double add_bounds(double a, double b)
+{
+	if(a >= CPX_INFBOUND || b >= CPX_INFBOUND) {
+		return CPX_INFBOUND;
+	}
+
+	return a + b;
+}
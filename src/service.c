@@ -0,0 +1,300 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "solver.h"
+#include "frontier.h"
+#include "service.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/*** Outcome of one request ***/
+#define SERVICE_CONTINUE 0
+#define SERVICE_QUIT     1
+#define SERVICE_SHUTDOWN 2
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int open_socket(const char *);
+static int serve_client(SOLVER_CTX *, FRONTIER *, int);
+static int execute(SOLVER_CTX *, FRONTIER *, char *, FILE *);
+static int solve_frontier(SOLVER_CTX *, FRONTIER *, double *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: run_service
+ ** Serves the loaded context on a Unix domain socket bound to path until a
+ ** client asks for a shutdown. The networks stay loaded between requests and
+ ** the bases of the last frontier are the warm starts of the next one, so a
+ ** client can change a few costs, supplies or bounds and get the updated
+ ** frontier without paying for a cold solve. Clients are served one at a
+ ** time with a line protocol, one request per line:
+ **
+ **	cost OBJ ARC VALUE	cost of arc ARC in objective OBJ (1 or 2)
+ **	supply NODE VALUE	supply of node NODE
+ **	bound ARC L|U|B VALUE	lower, upper or both flow bounds of arc ARC
+ **	solve			re-optimizes and sends the new frontier
+ **	frontier		sends the last frontier again
+ **	quit			closes the connection
+ **	shutdown		closes the connection and stops the service
+ **
+ ** Every request is answered by a line starting with "ok" or "error". Arcs
+ ** and nodes are numbered from 0 in the order of the network files. The
+ ** frontier of the loaded problem is computed before the first client is
+ ** accepted.
+ **/
+int run_service(SOLVER_CTX * ctx, const char * path)
+{
+	int status = 0;
+	int listener = -1;
+	int outcome = SERVICE_CONTINUE;
+	FRONTIER * frontier = NULL;
+	double elapsed;
+
+	if(!ctx || !ctx->lp1 || !path) {
+		return -1;
+	}
+
+	/* a client leaving early must not kill the service */
+	signal(SIGPIPE, SIG_IGN);
+
+	frontier = create_frontier();
+	if(!frontier) {
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = solve_frontier(ctx, frontier, &elapsed);
+	if(status) {
+		fprintf(stderr, "Unable to solve the loaded problem.\n");
+		goto TERMINATE;
+	}
+
+	listener = open_socket(path);
+	if(listener < 0) {
+		status = -1;
+		goto TERMINATE;
+	}
+
+	fprintf(stderr, "Serving %d frontier points on %s.\n", frontier->npoints, path);
+
+	while(outcome != SERVICE_SHUTDOWN) {
+		int client = accept(listener, NULL, NULL);
+		if(client < 0) {
+			perror("Unable to accept client");
+			continue;
+		}
+
+		outcome = serve_client(ctx, frontier, client);
+	}
+
+
+TERMINATE:
+
+	if(listener >= 0) {
+		close(listener);
+		unlink(path);
+	}
+
+	free_frontier(&frontier);
+
+	return status;
+}
+
+
+/** Function: open_socket
+ ** Creates a stream socket bound to path, replacing any stale socket file,
+ ** and starts listening on it. Returns the socket or -1 on error.
+ **/
+static int open_socket(const char * path)
+{
+	struct sockaddr_un addr;
+	int fd;
+
+	if(strlen(path) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "Socket path %s is too long.\n", path);
+		return -1;
+	}
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd < 0) {
+		perror("Unable to create socket");
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	unlink(path);
+
+	if(bind(fd, (struct sockaddr *) &addr, sizeof(addr)) || listen(fd, SERVICE_BACKLOG)) {
+		perror("Unable to listen on socket");
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+
+/** Function: serve_client
+ ** Answers the requests of one client until it quits, disconnects or shuts
+ ** the service down. Returns the outcome of the last request.
+ **/
+static int serve_client(SOLVER_CTX * ctx, FRONTIER * frontier, int fd)
+{
+	FILE * in = NULL;
+	FILE * out = NULL;
+	char line[SERVICE_LINE];
+	int outcome = SERVICE_CONTINUE;
+	int wfd;
+
+	wfd = dup(fd);
+	in = fdopen(fd, "r");
+	out = wfd >= 0 ? fdopen(wfd, "w") : NULL;
+	if(!in || !out) {
+		fprintf(stderr, "Unable to open client streams.\n");
+		if(in) fclose(in); else close(fd);
+		if(out) fclose(out); else if(wfd >= 0) close(wfd);
+		return SERVICE_CONTINUE;
+	}
+
+	while(outcome == SERVICE_CONTINUE && fgets(line, sizeof(line), in)) {
+		outcome = execute(ctx, frontier, line, out);
+		if(fflush(out)) {
+			break;
+		}
+	}
+
+	fclose(in);
+	fclose(out);
+
+	return outcome == SERVICE_SHUTDOWN ? SERVICE_SHUTDOWN : SERVICE_CONTINUE;
+}
+
+
+/** Function: execute
+ ** Parses one request line, carries it out and writes the answer to out.
+ **/
+static int execute(SOLVER_CTX * ctx, FRONTIER * frontier, char * line, FILE * out)
+{
+	char command[16];
+	char lu;
+	int objective, index;
+	double value, elapsed;
+
+	if(sscanf(line, "%15s", command) != 1) {
+		fprintf(out, "error empty request\n");
+		return SERVICE_CONTINUE;
+	}
+
+	if(!strcmp(command, "cost")) {
+		if(sscanf(line, "%*s %d %d %lf", &objective, &index, &value) != 3 ||
+		   index < 0 || index >= ctx->narcs) {
+			fprintf(out, "error usage: cost OBJ ARC VALUE\n");
+		} else if(solver_change_costs(ctx, objective, 1, &index, &value)) {
+			fprintf(out, "error cost not changed\n");
+		} else {
+			fprintf(out, "ok\n");
+		}
+	} else if(!strcmp(command, "supply")) {
+		if(sscanf(line, "%*s %d %lf", &index, &value) != 2 || index < 0 || index >= ctx->nnodes) {
+			fprintf(out, "error usage: supply NODE VALUE\n");
+		} else if(solver_change_supplies(ctx, 1, &index, &value)) {
+			fprintf(out, "error supply not changed\n");
+		} else {
+			fprintf(out, "ok\n");
+		}
+	} else if(!strcmp(command, "bound")) {
+		if(sscanf(line, "%*s %d %c %lf", &index, &lu, &value) != 3 || index < 0 || index >= ctx->narcs ||
+		   (lu != 'L' && lu != 'U' && lu != 'B')) {
+			fprintf(out, "error usage: bound ARC L|U|B VALUE\n");
+		} else if(solver_change_bounds(ctx, 1, &index, &lu, &value)) {
+			fprintf(out, "error bound not changed\n");
+		} else {
+			fprintf(out, "ok\n");
+		}
+	} else if(!strcmp(command, "solve")) {
+		if(solve_frontier(ctx, frontier, &elapsed)) {
+			fprintf(out, "error solve failed\n");
+		} else {
+			fprint_frontier(out, frontier);
+			fprintf(out, "ok %d points %.6lf s\n", frontier->npoints, elapsed);
+		}
+	} else if(!strcmp(command, "frontier")) {
+		fprint_frontier(out, frontier);
+		fprintf(out, "ok %d points\n", frontier->npoints);
+	} else if(!strcmp(command, "quit")) {
+		fprintf(out, "ok\n");
+		return SERVICE_QUIT;
+	} else if(!strcmp(command, "shutdown")) {
+		fprintf(out, "ok\n");
+		return SERVICE_SHUTDOWN;
+	} else {
+		fprintf(out, "error unknown request %s\n", command);
+	}
+
+	return SERVICE_CONTINUE;
+}
+
+
+/** Function: solve_frontier
+ ** Walks the frontier of the current problem again into the given frontier,
+ ** starting from the bases of the previous walk when there is one, and
+ ** stores the time it took in elapsed.
+ **/
+static int solve_frontier(SOLVER_CTX * ctx, FRONTIER * frontier, double * elapsed)
+{
+	int status = 0;
+	double start, end;
+
+	CPXgettime(ctx->env1, &start);
+
+	status = solver_reset(ctx);
+	if(status) {
+		return status;
+	}
+
+	frontier->npoints = 0;
+	solver_set_callback(ctx, frontier_record, frontier);
+
+	status = solver_run(ctx);
+	if(status) {
+		return status;
+	}
+
+	frontier_finalize(frontier);
+
+	CPXgettime(ctx->env1, &end);
+	*elapsed = end - start;
+
+	return 0;
+}
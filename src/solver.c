@@ -0,0 +1,2503 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <signal.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "perturbation.h"
+#include "solver.h"
+#include "hugepage.h"
+#include "dimacs.h"
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int open_objective(CPXENVptr *, CPXLPptr *, const char *, int);
+static int load_topology(SOLVER_CTX *, const char *, const char *);
+static void add_offsets(SOLVER_CTX *);
+static int prepare_loop(SOLVER_CTX *);
+static int set_loop_parameters(CPXENVptr);
+static int notify_iteration(SOLVER_CTX *, int, double);
+static int target_reached(const SOLVER_CTX *);
+static char * copy_string(const char *);
+static int warm_engine(const SOLVER_CTX *, int);
+static int supply_sign(SOLVER_CTX *);
+static int topology_sign(SOLVER_CTX *, const NET_TOPOLOGY *);
+static int pivot_arc(SOLVER_CTX *, int, double, TRACE_RECORD *);
+static void fill_record(const SOLVER_CTX *, int, const NET_SOLUTION *, double, const double *, TRACE_RECORD *);
+static int approx_active(const SOLVER_CTX *);
+static int approx_keep(SOLVER_CTX *);
+static int approx_jump(SOLVER_CTX *);
+static int load_far_end(SOLVER_CTX *);
+static int load_basis(SOLVER_CTX *, const NET_BASIS *);
+static void objective_pair(const SOLVER_CTX *, double *, double *);
+static double relative_gap(double, double);
+static int start_walk(SOLVER_CTX *);
+static void flip_secondary(SOLVER_CTX *, int, double);
+static int out_of_budget(SOLVER_CTX *);
+static int behind_schedule(const SOLVER_CTX *);
+static int anytime_jump(SOLVER_CTX *);
+static int anchor_secondary(SOLVER_CTX *);
+static int add_gap(SOLVER_CTX *, double, double, double);
+static void drop_gap(SOLVER_CTX *, int);
+static int walk_gap(SOLVER_CTX *);
+static int keep_remainder(SOLVER_CTX *);
+static void free_gaps(SOLVER_CTX *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: solver_create
+ ** Allocates an empty solver context. Every pointer of the context starts as
+ ** NULL and is only filled by solver_load() and the solve routines. Returns
+ ** NULL if the allocation fails.
+ **/
+SOLVER_CTX * solver_create(void)
+{
+	SOLVER_CTX * ctx = calloc(1, sizeof(SOLVER_CTX));
+	if(!ctx) {
+		fprintf(stderr, "Unable to alloc solver context.\n");
+		return NULL;
+	}
+
+	ctx->tree_kind = BASISTREE_NONE;
+	ctx->gap = -1;
+
+	return ctx;
+}
+
+
+/** Function: solver_free
+ ** Frees every object owned by the solver context, closes both CPLEX
+ ** environments and sets the context pointer to NULL.
+ **/
+void solver_free(SOLVER_CTX ** ctx_p)
+{
+	SOLVER_CTX * ctx;
+
+	if(!ctx_p || !*ctx_p) {
+		return;
+	}
+
+	ctx = *ctx_p;
+
+	free_solution(&ctx->solution1);
+	free_solution(&ctx->solution2);
+	free_solution(&ctx->perturbsol);
+	free_solution(&ctx->initial_sol1);
+	free_solution(&ctx->initial_sol2);
+
+	mem_free(ctx->ratios);
+	ctx->ratios = NULL;
+	free_and_null((void **) &ctx->net_file1);
+	free_and_null((void **) &ctx->net_file2);
+	free_reduction(&ctx->reduction);
+	free_basis_tree(&ctx->tree);
+	free_basis(&ctx->warm_anchor);
+	free_basis(&ctx->warm_perturb);
+	free_basis(&ctx->trace_basis);
+	free_gaps(ctx);
+
+	if(ctx->lp1) {
+		CPXfreeprob(ctx->env1, &ctx->lp1);
+	}
+
+	if(ctx->lp2) {
+		CPXfreeprob(ctx->env2, &ctx->lp2);
+	}
+
+	if(ctx->env1) {
+		CPXcloseCPLEX(&ctx->env1);
+		if(ctx->env1) {
+			fprintf(stderr, "Unable to close CPLEX.\n");
+		}
+	}
+
+	if(ctx->env2) {
+		CPXcloseCPLEX(&ctx->env2);
+		if(ctx->env2) {
+			fprintf(stderr, "Unable to close CPLEX.\n");
+		}
+	}
+
+	free(ctx);
+	*ctx_p = NULL;
+}
+
+
+/** Function: solver_set_callback
+ ** Registers the function called after every new basis of the bi-objective
+ ** problem. The pointer data is passed untouched to the callback.
+ **/
+void solver_set_callback(SOLVER_CTX * ctx, SOLVER_CALLBACK callback, void * data)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->callback = callback;
+	ctx->cbdata = data;
+}
+
+
+/** Function: solver_set_direction
+ ** Chooses the direction of the walk, SOLVER_FORWARD (the default) or
+ ** SOLVER_BACKWARD. It must be called before the anchor solutions are found.
+ **/
+void solver_set_direction(SOLVER_CTX * ctx, int direction)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->direction = (direction == SOLVER_BACKWARD) ? SOLVER_BACKWARD : SOLVER_FORWARD;
+}
+
+
+/** Function: solver_set_perf
+ ** Attaches the performance counters that every phase of solver_step() is
+ ** charged to. The counters must have been opened on the thread that steps
+ ** the context. Passing NULL turns the accounting off.
+ **/
+void solver_set_perf(SOLVER_CTX * ctx, PERF_STATS * perf)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->perf = perf;
+}
+
+
+/** Function: solver_set_reduce
+ ** Turns the network reduction on or off. It must be called before
+ ** solver_load(). With the reduction on, both LP objects hold the reduced
+ ** network and the objective values reported by the context already include
+ ** the cost of the flows fixed by the reduction.
+ **/
+void solver_set_reduce(SOLVER_CTX * ctx, int reduce)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->reduce = reduce ? 1 : 0;
+}
+
+
+/** Function: solver_set_loader
+ ** Selects how solver_load() reads the network files: with nthreads zero
+ ** (the default) CPLEX reads them, otherwise they are parsed as DIMACS
+ ** minimum cost flow files by read_dimacs() on nthreads threads. It must be
+ ** called before solver_load().
+ **/
+void solver_set_loader(SOLVER_CTX * ctx, int nthreads)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->load_threads = nthreads > 0 ? nthreads : 0;
+}
+
+
+/** Function: solver_set_engines
+ ** Selects the engine (one of the ANCHOR_* constants) used for the anchor
+ ** solve of solver_initial_solve() and for the one of solver_perturbation().
+ **/
+void solver_set_engines(SOLVER_CTX * ctx, int initial_engine, int perturb_engine)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->initial_engine = initial_engine;
+	ctx->perturb_engine = perturb_engine;
+}
+
+
+/** Function: solver_set_portfolio
+ ** Sets how the ANCHOR_PORTFOLIO engine solves the anchors of the context:
+ ** the database file that keeps the winning configuration of every instance
+ ** class, NULL for none and owned by the caller, and the number of
+ ** configurations raced at once.
+ **/
+void solver_set_portfolio(SOLVER_CTX * ctx, const char * database, int nthreads)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->portfolio.database = database;
+	ctx->portfolio.threads = nthreads > 0 ? nthreads : 1;
+}
+
+
+/** Function: solver_set_basis_tree
+ ** Selects how the secondary objective follows the pivots of the primary
+ ** one: with BASISTREE_NONE (the default) CPLEX refactors the basis after
+ ** every pivot, with BASISTREE_ARRAY a BASIS_TREE updates the potentials of
+ ** the subtree moved by the pivot. It takes effect on the next
+ ** call to solver_perturbation().
+ **/
+void solver_set_basis_tree(SOLVER_CTX * ctx, int kind)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->tree_kind = kind;
+}
+
+
+/** Function: solver_set_approximation
+ ** Turns on the approximation mode. A point of the walk is only reported if
+ ** its pivoted objective improved by more than a relative eps on the last
+ ** reported point, and stretches of the frontier where the walk makes little
+ ** progress are jumped over by weighted-sum solves. max_points, if positive,
+ ** caps the number of reported points by raising eps as needed. Both zero
+ ** turn the mode off.
+ **/
+void solver_set_approximation(SOLVER_CTX * ctx, double eps, int max_points)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->approx_eps = eps > 0.0 ? eps : 0.0;
+	ctx->approx_points = max_points > 0 ? max_points : 0;
+}
+
+
+/** Function: solver_set_trace
+ ** Writes a trace record for every pivot of the walk to the given trace,
+ ** which stays owned by the caller. NULL stops tracing.
+ **/
+void solver_set_trace(SOLVER_CTX * ctx, TRACE * trace)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->trace = trace;
+}
+
+
+/** Function: solver_set_budget
+ ** Runs the walks of the context in anytime mode, with a budget of seconds
+ ** from now and of iterations per walk. solver_reset() starts the time
+ ** budget over, so every later solve gets the whole of it. A value of 0
+ ** leaves that budget out and both at 0 turn the mode off.
+ **/
+void solver_set_budget(SOLVER_CTX * ctx, double seconds, int iterations)
+{
+	if(!ctx) {
+		return;
+	}
+
+	ctx->time_budget = seconds > 0.0 ? seconds : 0.0;
+	ctx->deadline = ctx->time_budget > 0.0 ? trace_clock() + ctx->time_budget : 0.0;
+	ctx->iteration_budget = iterations > 0 ? iterations : 0;
+}
+
+
+/** Function: solver_interrupt
+ ** Asks the walk of the context to stop after its current step, keeping what
+ ** is left of the frontier as gaps. Only sets a flag of the context, so it
+ ** may be called from a signal handler or another thread.
+ **/
+void solver_interrupt(SOLVER_CTX * ctx)
+{
+	if(ctx) {
+		ctx->interrupted = 1;
+	}
+}
+
+
+/** Function: solver_load
+ ** The CPLEX environments are initialized here, with the LP objects also set
+ ** from the NET objects generated from the two input files. The parameters
+ ** used by the pivot loop are set once for both environments and the memory
+ ** used during the optimization is alloc'd.
+ **
+ ** We make the assumption that the number of rows and colums in both
+ ** objective functions is the same. If not, an error is returned as the
+ ** solutions of both objectives could not share a basis.
+ **/
+int solver_load(SOLVER_CTX * ctx, const char * net_file1, const char * net_file2)
+{
+	int status = 0;
+
+	if(!ctx || !net_file1 || !net_file2) {
+		fprintf(stderr, "Unable to load problem due to NULL argument.\n");
+		return -1;
+	}
+
+	ctx->net_file1 = copy_string(net_file1);
+	ctx->net_file2 = copy_string(net_file2);
+	if(!ctx->net_file1 || !ctx->net_file2) {
+		fprintf(stderr, "Unable to alloc network filenames.\n");
+		return -1;
+	}
+
+	status = open_objective(&ctx->env1, &ctx->lp1, ctx->reduce || ctx->load_threads ? NULL : net_file1, 1);
+	if(status) {
+		return status;
+	}
+
+	status = open_objective(&ctx->env2, &ctx->lp2, ctx->reduce || ctx->load_threads ? NULL : net_file2, 2);
+	if(status) {
+		return status;
+	}
+
+	if(ctx->reduce || ctx->load_threads) {
+		status = load_topology(ctx, net_file1, net_file2);
+		if(status) {
+			return status;
+		}
+	}
+
+	return prepare_loop(ctx);
+}
+
+
+/** Function: solver_clone
+ ** Creates a context holding a private copy of the problem loaded into src,
+ ** with its own CPLEX environments, so both can be solved concurrently
+ ** without reading the network files again. The settings of src are copied
+ ** but not its solutions. Reduced problems can't be cloned. Returns NULL if
+ ** any error is detected.
+ **/
+SOLVER_CTX * solver_clone(SOLVER_CTX * src)
+{
+	int status = 0;
+	SOLVER_CTX * ctx = NULL;
+
+	if(!src || !src->lp1 || !src->lp2 || src->reduction) {
+		fprintf(stderr, "Unable to clone the solver context.\n");
+		return NULL;
+	}
+
+	/* computed once here rather than by every clone */
+	if(!supply_sign(src)) {
+		return NULL;
+	}
+
+	ctx = solver_create();
+	if(!ctx) {
+		return NULL;
+	}
+
+	ctx->direction = src->direction;
+	ctx->initial_engine = src->initial_engine;
+	ctx->perturb_engine = src->perturb_engine;
+	ctx->portfolio = src->portfolio;
+	ctx->tree_kind = src->tree_kind;
+	ctx->load_threads = src->load_threads;
+	ctx->approx_eps = src->approx_eps;
+	ctx->approx_points = src->approx_points;
+	solver_set_budget(ctx, src->time_budget, src->iteration_budget);
+	ctx->supply_sign = src->supply_sign;
+	ctx->changed_costs = src->changed_costs;
+	ctx->changed_bounds = src->changed_bounds;
+
+	ctx->net_file1 = copy_string(src->net_file1);
+	ctx->net_file2 = copy_string(src->net_file2);
+	if(!ctx->net_file1 || !ctx->net_file2) {
+		fprintf(stderr, "Unable to alloc network filenames.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = open_objective(&ctx->env1, &ctx->lp1, NULL, 1);
+	if(!status) status = open_objective(&ctx->env2, &ctx->lp2, NULL, 2);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	CPXfreeprob(ctx->env1, &ctx->lp1);
+	CPXfreeprob(ctx->env2, &ctx->lp2);
+
+	ctx->lp1 = CPXcloneprob(ctx->env1, src->lp1, &status);
+	if(ctx->lp1) ctx->lp2 = CPXcloneprob(ctx->env2, src->lp2, &status);
+	if(!ctx->lp1 || !ctx->lp2) {
+		fprintf(stderr, "Unable to clone LP objects.\n");
+		status = status ? status : -1;
+		goto TERMINATE;
+	}
+
+	status = prepare_loop(ctx);
+
+
+TERMINATE:
+
+	if(status) {
+		solver_free(&ctx);
+	}
+
+	return ctx;
+}
+
+
+/** Function: solver_initial_solve
+ ** Finds the global minimum of the objective function the walk pivots on,
+ ** objective 2 for the forward walk and objective 1 for the backward walk.
+ ** Its objective value is the stop criterion of the bi-objective loop.
+ **/
+int solver_initial_solve(SOLVER_CTX * ctx)
+{
+	if(!ctx || !ctx->net_file1 || !ctx->net_file2) {
+		fprintf(stderr, "Unable to solve the anchor of an unloaded problem.\n");
+		return -1;
+	}
+
+	/* The reduced network only lives in the LP objects, so the anchor is
+	 * solved on a copy of them instead of reading the file again. The same
+	 * holds once the LP objects were changed or a warm start is kept, and
+	 * when the native loader read the files, to skip the CPLEX reader.
+	 */
+	if(ctx->direction == SOLVER_BACKWARD) {
+		free_solution(&ctx->initial_sol1);
+
+		if(ctx->reduction || ctx->load_threads || ctx->warm_anchor || ctx->changed_costs || ctx->changed_bounds) {
+			ctx->initial_sol1 = get_objective_solution(ctx->env1, ctx->lp1, warm_engine(ctx, ctx->initial_engine),
+			                                           &ctx->portfolio, ctx->warm_anchor, &ctx->initial_stats);
+		} else {
+			ctx->initial_sol1 = get_initial_objective(ctx->net_file1, ctx->initial_engine, &ctx->portfolio,
+			                                          &ctx->initial_stats);
+		}
+		if(!ctx->initial_sol1) {
+			fprintf(stderr, "Failed to get global objective 1 minimum.\n");
+			return -1;
+		}
+
+		if(ctx->reduction) {
+			ctx->initial_sol1->objval += ctx->reduction->offset1;
+		}
+
+		return 0;
+	}
+
+	free_solution(&ctx->initial_sol2);
+
+	if(ctx->reduction || ctx->load_threads || ctx->warm_anchor || ctx->changed_costs || ctx->changed_bounds) {
+		ctx->initial_sol2 = get_objective_solution(ctx->env2, ctx->lp2, warm_engine(ctx, ctx->initial_engine),
+		                                           &ctx->portfolio, ctx->warm_anchor, &ctx->initial_stats);
+	} else {
+		ctx->initial_sol2 = get_initial_objective(ctx->net_file2, ctx->initial_engine, &ctx->portfolio,
+		                                          &ctx->initial_stats);
+	}
+	if(!ctx->initial_sol2) {
+		fprintf(stderr, "Failed to get global objective 2 minimum.\n");
+		return -1;
+	}
+
+	if(ctx->reduction) {
+		ctx->initial_sol2->objval += ctx->reduction->offset2;
+	}
+
+	return 0;
+}
+
+
+/** Function: solver_perturbation
+ ** Gets the initial basis of the bi-objective problem using the perturbation
+ ** Z(x) = 0.999*z1(x) + 0.001*z2(x), or the mirrored 0.001/0.999 blend for
+ ** the backward walk, and loads it into the LP objects of both objective
+ ** functions. The resulting solutions are reported to the callback as
+ ** iteration 0.
+ **/
+int solver_perturbation(SOLVER_CTX * ctx)
+{
+	double weight = PERTURBATION_WEIGHT;
+
+	if(!ctx || !ctx->lp1 || !ctx->lp2) {
+		fprintf(stderr, "Unable to perturb an unloaded problem.\n");
+		return -1;
+	}
+
+	free_solution(&ctx->perturbsol);
+
+	if(ctx->direction == SOLVER_BACKWARD) {
+		weight = 1.0 - PERTURBATION_WEIGHT;
+	}
+
+	ctx->perturbsol = get_perturbation_solution(ctx->env1, ctx->env2, ctx->lp1, ctx->lp2, weight,
+	                                            warm_engine(ctx, ctx->perturb_engine), &ctx->portfolio,
+	                                            ctx->warm_perturb, &ctx->perturb_stats);
+	if(!ctx->perturbsol) {
+		fprintf(stderr, "Error on perturbation method..\n");
+		return -1;
+	}
+
+	/* both anchors are now optimal for the changed problem */
+	ctx->changed_costs = 0;
+	ctx->changed_bounds = 0;
+
+	return start_walk(ctx);
+}
+
+
+/** Function: solver_resume
+ ** Starts the walk from the given basis of the bi-objective problem instead of
+ ** the one of the perturbation method, e.g. a point of an earlier run kept in
+ ** a basis archive. The basis must be optimal for some blend of the
+ ** objectives for the walk to stay on the frontier. Its solutions are
+ ** reported to the callback as iteration 0.
+ **/
+int solver_resume(SOLVER_CTX * ctx, const NET_BASIS * basis)
+{
+	int status = 0;
+
+	if(!ctx || !ctx->lp1 || !ctx->lp2 || !basis) {
+		fprintf(stderr, "Unable to resume an unloaded problem.\n");
+		return -1;
+	}
+
+	free_solution(&ctx->perturbsol);
+
+	ctx->perturbsol = create_solution(ctx->narcs, ctx->nnodes);
+	if(!ctx->perturbsol) {
+		fprintf(stderr, "Unable to alloc resumed solution.\n");
+		return -1;
+	}
+
+	status = update_solution(ctx->env1, ctx->lp1, basis, ctx->perturbsol);
+	if(status) {
+		fprintf(stderr, "Unable to load the resumed basis.\n");
+		free_solution(&ctx->perturbsol);
+		return status;
+	}
+
+	return start_walk(ctx);
+}
+
+
+/** Function: start_walk
+ ** Loads the basis of perturbsol into the LP objects of both objective
+ ** functions, builds the basis tree and reports iteration 0.
+ **/
+static int start_walk(SOLVER_CTX * ctx)
+{
+	int status = 0;
+
+	/* Copy the initial basis found by the perturbation and stored in perturbsol
+	 * to both solution1 and solution2.
+	 */
+	status = update_solution(ctx->env1, ctx->lp1, ctx->perturbsol->basis, ctx->solution1);
+	if(status) {
+		return status;
+	}
+
+	status = update_solution(ctx->env2, ctx->lp2, ctx->perturbsol->basis, ctx->solution2);
+	if(status) {
+		return status;
+	}
+
+	/* the tree follows the secondary objective, which is never pivoted on */
+	free_basis_tree(&ctx->tree);
+	if(ctx->tree_kind != BASISTREE_NONE) {
+		if(ctx->direction == SOLVER_FORWARD) {
+			ctx->tree = create_basis_tree(ctx->env1, ctx->lp1);
+		} else {
+			ctx->tree = create_basis_tree(ctx->env2, ctx->lp2);
+		}
+
+		if(ctx->tree && basis_tree_load(ctx->tree, ctx->perturbsol->basis)) {
+			free_basis_tree(&ctx->tree);
+		}
+
+		if(!ctx->tree) {
+			fprintf(stderr, "Basis tree unavailable, CPLEX updates the secondary objective.\n");
+		}
+	}
+
+	add_offsets(ctx);
+
+	/* the anchor of the secondary objective is only computed when needed */
+	memset(&ctx->approx, 0, sizeof(APPROX_STATE));
+	ctx->approx.anchor_s = HUGE_VAL;
+
+	free_gaps(ctx);
+	objective_pair(ctx, &ctx->start_p, &ctx->approx.last_s);
+	ctx->approx.last_p = ctx->start_p;
+	ctx->walk_start = trace_clock();
+	ctx->last_jump = 0;
+	ctx->stop = SOLVER_STOP_NONE;
+	ctx->gaps_walked = 0;
+
+	ctx->iteration = 0;
+	ctx->pivots = 0;
+	ctx->flips = 0;
+	ctx->finished = target_reached(ctx);
+
+	status = notify_iteration(ctx, -1, 0.0);
+
+	return status;
+}
+
+
+/** Function: solver_step
+ ** Performs one iteration of the bi-objective loop: the entering arc is found
+ ** with the ratio test over the reduced costs of both objectives, the pivot is
+ ** made on the objective the walk is minimizing (objective 2 forward,
+ ** objective 1 backward) and the resulting basis is loaded into the other
+ ** one. The finished flag of the context is set once the minimum of the
+ ** pivoted objective is reached.
+ **/
+int solver_step(SOLVER_CTX * ctx)
+{
+	int status = 0;
+	int arc;
+	double start;
+	double pricing = 0.0;
+	NET_SOLUTION * psol;
+	NET_SOLUTION * ssol;
+
+	if(!ctx || !ctx->perturbsol ||
+	   (ctx->direction == SOLVER_FORWARD ? !ctx->initial_sol2 : !ctx->initial_sol1)) {
+		fprintf(stderr, "The anchor solutions must be found before stepping.\n");
+		return -1;
+	}
+
+	if(ctx->finished) {
+		return 0;
+	}
+
+	/* a flat stretch of the frontier is jumped over instead of walked */
+	if(approx_active(ctx) && ctx->approx.since >= APPROX_FLAT_PIVOTS) {
+		status = approx_jump(ctx);
+		if(status) {
+			return status;
+		}
+
+		ctx->iteration++;
+		ctx->finished = target_reached(ctx);
+
+		return notify_iteration(ctx, -1, 0.0);
+	}
+
+	/* behind the pace of the budget, skip ahead and come back later */
+	if(behind_schedule(ctx)) {
+		status = anytime_jump(ctx);
+		if(status) {
+			return status;
+		}
+
+		ctx->iteration++;
+		ctx->finished = target_reached(ctx);
+
+		return notify_iteration(ctx, -1, 0.0);
+	}
+
+	/* The primary objective is the one being pivoted on and the secondary
+	 * objective follows its basis.
+	 */
+	if(ctx->direction == SOLVER_FORWARD) {
+		psol = ctx->solution2;
+		ssol = ctx->solution1;
+	} else {
+		psol = ctx->solution1;
+		ssol = ctx->solution2;
+	}
+
+	status = CPXgettime(ctx->env1, &start);
+	if(status) {
+		fprintf(stderr, "Unable to get time.\n");
+		return status;
+	}
+
+	if(ctx->trace) {
+		pricing = trace_clock();
+	}
+
+	/* Find the entering arc. The backward walk uses the mirrored ratio rule,
+	 * i.e., the roles of both reduced cost arrays are swapped.
+	 */
+	perf_begin(ctx->perf, PERF_PRICING);
+	arc = entering_arc(ssol->dj, psol->dj, psol->basis->arc_basis, ctx->ratios, ctx->narcs);
+	perf_end(ctx->perf);
+	if(arc == -1) {
+		fprintf(stderr, "Error calculating entering arc. Break.\n");
+		return -1;
+	}
+
+	if(ctx->trace) {
+		TRACE_RECORD record;
+
+		pricing = trace_clock() - pricing;
+		status = pivot_arc(ctx, arc, start, &record);
+		record.usec[TRACE_PRICING] = (float) (pricing * 1e6);
+		if(!status && trace_write(ctx->trace, &record)) {
+			status = -1;
+		}
+
+		return status;
+	}
+
+	return pivot_arc(ctx, arc, start, NULL);
+}
+
+
+/** Function: solver_pivot
+ ** Performs one iteration of the bi-objective loop entering the given arc,
+ ** as found by an earlier walk, instead of pricing. If record is not NULL it
+ ** receives the trace record of the iteration, without the pricing time.
+ **/
+int solver_pivot(SOLVER_CTX * ctx, int arc, TRACE_RECORD * record)
+{
+	double start;
+
+	if(!ctx || !ctx->perturbsol || arc < 0 || arc >= ctx->narcs) {
+		fprintf(stderr, "Unable to pivot arc %d.\n", arc);
+		return -1;
+	}
+
+	if(CPXgettime(ctx->env1, &start)) {
+		fprintf(stderr, "Unable to get time.\n");
+		return -1;
+	}
+
+	return pivot_arc(ctx, arc, start, record);
+}
+
+
+/** Function: solver_replay
+ ** Walks the frontier again along the pivots of a trace, skipping pricing,
+ ** so the pivot and update machinery can be timed on its own and two builds
+ ** compared on the same path. The anchor solutions are found first if they
+ ** weren't yet. Every iteration is written to the trace of the context, if
+ ** any, and the first record whose objective pair differs from the one
+ ** reached is reported. Returns a non-zero value on error.
+ **/
+int solver_replay(SOLVER_CTX * ctx, TRACE * in, FILE * report)
+{
+	static const char * phases[TRACE_NPHASES] = {"pricing", "pivot", "retrieve", "update"};
+	TRACE_RECORD expected, record;
+	double totals[TRACE_NPHASES] = {0.0};
+	long replayed = 0;
+	long diverged = -1;
+	int status = 0;
+	int k, p;
+
+	if(!ctx || !in || !report) {
+		return -1;
+	}
+
+	if(in->header.narcs != ctx->narcs || in->header.nnodes != ctx->nnodes ||
+	   in->header.direction != ctx->direction) {
+		fprintf(stderr, "The trace was recorded on a different problem.\n");
+		return -1;
+	}
+
+	if(ctx->direction == SOLVER_FORWARD ? !ctx->initial_sol2 : !ctx->initial_sol1) {
+		status = solver_initial_solve(ctx);
+		if(status) {
+			return status;
+		}
+	}
+
+	if(!ctx->perturbsol) {
+		status = solver_perturbation(ctx);
+		if(status) {
+			return status;
+		}
+	}
+
+	while((k = trace_read(in, &expected)) > 0) {
+		status = solver_pivot(ctx, expected.entering, &record);
+		if(status) {
+			return status;
+		}
+
+		if(diverged < 0 &&
+		   (record.leaving != expected.leaving ||
+		    fabs(record.obj1 - expected.obj1) > TRACE_TOL * (1.0 + fabs(expected.obj1)) ||
+		    fabs(record.obj2 - expected.obj2) > TRACE_TOL * (1.0 + fabs(expected.obj2)))) {
+			diverged = replayed;
+			fprintf(report, "Replay diverges at record %ld (iteration %d): leaving %d, z1 %lf, z2 %lf"
+			        " instead of leaving %d, z1 %lf, z2 %lf.\n", replayed, expected.iteration,
+			        record.leaving, record.obj1, record.obj2, expected.leaving, expected.obj1, expected.obj2);
+		}
+
+		if(ctx->trace && trace_write(ctx->trace, &record)) {
+			return -1;
+		}
+
+		for(p = 0; p < TRACE_NPHASES; p++) {
+			totals[p] += record.usec[p] * 1e-6;
+		}
+		replayed++;
+	}
+	if(k < 0) {
+		return -1;
+	}
+
+	fprintf(report, "********************************************************************\n");
+	fprintf(report, "Replay of %ld pivots%s:\n\n", replayed, diverged < 0 ? "" : " (diverged)");
+	for(p = TRACE_PIVOT; p < TRACE_NPHASES; p++) {
+		fprintf(report, "%-10s %14.6lf s\n", phases[p], totals[p]);
+	}
+	fprintf(report, "\n");
+
+	return 0;
+}
+
+
+/** Function: pivot_arc
+ ** Enters the given arc into the basis of the pivoted objective, loads the
+ ** new basis into the secondary one and reports the iteration with the time
+ ** elapsed since start. If record is not NULL the trace record of the
+ ** iteration is filled, all but its pricing time.
+ **/
+static int pivot_arc(SOLVER_CTX * ctx, int arc, double start, TRACE_RECORD * record)
+{
+	int status = 0;
+	int flipped;
+	double end;
+	double flow;
+	double clock[4] = {0.0};
+	CPXENVptr penv, senv;
+	CPXLPptr plp, slp;
+	NET_SOLUTION * psol;
+	NET_SOLUTION * ssol;
+
+	if(ctx->direction == SOLVER_FORWARD) {
+		penv = ctx->env2; plp = ctx->lp2; psol = ctx->solution2;
+		senv = ctx->env1; slp = ctx->lp1; ssol = ctx->solution1;
+	} else {
+		penv = ctx->env1; plp = ctx->lp1; psol = ctx->solution1;
+		senv = ctx->env2; slp = ctx->lp2; ssol = ctx->solution2;
+	}
+
+	if(record && !ctx->trace_basis) {
+		ctx->trace_basis = create_basis(ctx->narcs, ctx->nnodes);
+		if(!ctx->trace_basis) {
+			fprintf(stderr, "Unable to alloc trace basis.\n");
+			return -1;
+		}
+	}
+
+	if(record) {
+		memcpy(ctx->trace_basis->arc_basis, psol->basis->arc_basis, ctx->narcs * sizeof(int));
+		memcpy(ctx->trace_basis->node_basis, psol->basis->node_basis, ctx->nnodes * sizeof(int));
+		clock[0] = trace_clock();
+	}
+
+	flow = psol->x[arc];
+
+	/* Enter the arc using CPXpivot. CPLEX makes the ratio test, moving the
+	 * arc away from its bound by the sign of its reduced cost, and either
+	 * some basic arc leaves or the arc only flips to its other bound.
+	 */
+	perf_begin(ctx->perf, PERF_PIVOT);
+	status = CPXpivot(penv, plp, arc, CPX_NO_VARIABLE, CPX_AT_LOWER);
+	perf_end(ctx->perf);
+	if(status) {
+		fprintf(stderr, "CPXpivot failed.\n");
+		return status;
+	}
+
+	status = CPXgettime(penv, &end);
+	if(status) {
+		fprintf(stderr, "Unable to get time.\n");
+		return status;
+	}
+
+	if(record) {
+		clock[1] = trace_clock();
+	}
+
+	/* Get the solution */
+	perf_begin(ctx->perf, PERF_RETRIEVE);
+	status = CPXsolution(penv, plp, &psol->solstat, &psol->objval,
+	                     psol->x, psol->pi, psol->slack, psol->dj);
+	if(status) {
+		perf_end(ctx->perf);
+		fprintf(stderr, "Error getting solution at end of loop.\n");
+		return status;
+	}
+
+	status = CPXgetbase(penv, plp, psol->basis->arc_basis, psol->basis->node_basis);
+	perf_end(ctx->perf);
+	if(status) {
+		fprintf(stderr, "Error getting base at end of loop.\n");
+		return status;
+	}
+
+	if(record) {
+		clock[2] = trace_clock();
+	}
+
+	/* Update the secondary objective to the new basis. An arc that is still
+	 * nonbasic only moved to its other bound: the basis is the same, so the
+	 * secondary duals are too and CPLEX needn't solve it again.
+	 */
+	flipped = psol->basis->arc_basis[arc] != CPX_BASIC;
+
+	perf_begin(ctx->perf, PERF_UPDATE);
+	if(ctx->tree) {
+		status = basis_tree_update(ctx->tree, psol, ssol);
+	} else if(flipped) {
+		flip_secondary(ctx, arc, psol->x[arc] - flow);
+	} else {
+		status = update_solution(senv, slp, psol->basis, ssol);
+	}
+	perf_end(ctx->perf);
+	if(status) {
+		return status;
+	}
+
+	add_offsets(ctx);
+
+	if(flipped) {
+		ctx->flips++;
+	} else {
+		ctx->pivots++;
+	}
+
+	ctx->iteration++;
+	ctx->finished = target_reached(ctx);
+
+	if(record) {
+		clock[3] = trace_clock();
+		fill_record(ctx, arc, psol, flow, clock, record);
+	}
+
+	perf_begin(ctx->perf, PERF_OUTPUT);
+	status = notify_iteration(ctx, arc, end - start);
+	perf_end(ctx->perf);
+
+	return status;
+}
+
+
+
+
+/** Function: fill_record
+ ** Fills the trace record of the pivot just made on arc: the variable that
+ ** left the basis, found by comparing the basis before the pivot kept in
+ ** trace_basis, the change of flow on the arc, the objective pair and the
+ ** times of the pivot, retrieve and update phases.
+ **/
+static void fill_record(const SOLVER_CTX * ctx, int arc, const NET_SOLUTION * psol, double flow,
+                        const double * clock, TRACE_RECORD * record)
+{
+	const NET_BASIS * before = ctx->trace_basis;
+	const NET_BASIS * after = psol->basis;
+	int i;
+
+	memset(record, 0, sizeof(TRACE_RECORD));
+	record->iteration = ctx->iteration;
+	record->entering = arc;
+	record->leaving = TRACE_NO_LEAVING;
+	record->step = psol->x[arc] - flow;
+	record->obj1 = ctx->solution1->objval;
+	record->obj2 = ctx->solution2->objval;
+	record->usec[TRACE_PIVOT] = (float) ((clock[1] - clock[0]) * 1e6);
+	record->usec[TRACE_RETRIEVE] = (float) ((clock[2] - clock[1]) * 1e6);
+	record->usec[TRACE_UPDATE] = (float) ((clock[3] - clock[2]) * 1e6);
+
+	for(i = 0; i < ctx->narcs; i++) {
+		if(before->arc_basis[i] == CPX_BASIC && after->arc_basis[i] != CPX_BASIC) {
+			record->leaving = i;
+			return;
+		}
+	}
+
+	for(i = 0; i < ctx->nnodes; i++) {
+		if(before->node_basis[i] == CPX_BASIC && after->node_basis[i] != CPX_BASIC) {
+			record->leaving = TRACE_ROW(i);
+			return;
+		}
+	}
+}
+
+
+/** Function: solver_run
+ ** Runs every step needed to reach the end of the bi-objective problem. The
+ ** anchor solutions are found first if they weren't yet. The loop stops when
+ ** the minimum of objective 2 is reached, when an error is detected or when
+ ** the callback asks for it.
+ **/
+int solver_run(SOLVER_CTX * ctx)
+{
+	int status = 0;
+
+	if(!ctx) {
+		return -1;
+	}
+
+	if(ctx->direction == SOLVER_FORWARD ? !ctx->initial_sol2 : !ctx->initial_sol1) {
+		status = solver_initial_solve(ctx);
+		if(status) {
+			return status;
+		}
+	}
+
+	if(!ctx->perturbsol) {
+		status = solver_perturbation(ctx);
+		if(status) {
+			return status;
+		}
+	}
+
+	for(;;) {
+		if(ctx->finished) {
+			if(ctx->stop) {
+				return keep_remainder(ctx);
+			}
+
+			/* the walk reached its anchor, then every gap it left is walked */
+			if(ctx->gap >= 0) {
+				drop_gap(ctx, ctx->gap);
+				ctx->gap = -1;
+				ctx->gaps_walked++;
+			}
+			if(ctx->ngaps == 0) {
+				return 0;
+			}
+			if(out_of_budget(ctx)) {
+				return 0;
+			}
+
+			status = walk_gap(ctx);
+		} else if(out_of_budget(ctx)) {
+			return keep_remainder(ctx);
+		} else {
+			status = solver_step(ctx);
+		}
+
+		if(status) {
+			return status;
+		}
+	}
+}
+
+
+/** Function: solver_finished
+ ** Returns 1 if the loop of the context reached its end and 0 otherwise.
+ **/
+int solver_finished(const SOLVER_CTX * ctx)
+{
+	return ctx ? ctx->finished : 1;
+}
+
+
+/** The function update_solution performs a single iteration that updates the
+ ** information relative to the basis passed as an argument, which is loaded
+ ** into the LP problem object before the solution is read.
+ ** If any error is detected, the function returns a non-zero value and an error
+ ** message is logged into standard error output stream.
+ **/
+int update_solution(CPXENVptr env, CPXLPptr lp, const NET_BASIS * basis, NET_SOLUTION * sol)
+{
+	int status = 0;
+
+	/* Check if the input arguments are valid */
+	if(!env || !lp || !basis || !sol) {
+		fprintf(stderr, "Error: NULL pointer\n");
+		status = 1;
+		goto TERMINATE;
+	}
+
+	/* Set the iteration limit to zero so that CPLEX doesn't change the current
+	 * basis
+	 */
+	status = CPXsetintparam(env, CPX_PARAM_ITLIM, 0);
+	if(status) {
+		fprintf(stderr, "Unable to set iteration limit to 0.\n");
+		goto TERMINATE;
+	}
+
+	status = CPXcopybase(env, lp, basis->arc_basis, basis->node_basis);
+	if(status) {
+		fprintf(stderr, "Error copying basis. ERROR %d\n", status);
+		status = 2;
+		goto TERMINATE;
+	}
+
+	status = CPXprimopt(env, lp);
+	if(status) {
+		fprintf(stderr, "Error during optimization. ERROR %d\n", status);
+		goto TERMINATE;
+	}
+
+	status = CPXsolution(env, lp, &sol->solstat, &sol->objval, sol->x, sol->pi, sol->slack, sol->dj);
+	if(status) {
+		fprintf(stderr, "Error getting solution. ERROR %d\n", status);
+		goto TERMINATE;
+	}
+
+	status = CPXgetbase(env, lp, sol->basis->arc_basis, sol->basis->node_basis);
+	if(status) {
+		fprintf(stderr, "Error getting basis. ERROR %d\n", status);
+		goto TERMINATE;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_ITLIM, 1);
+	if(status) {
+		fprintf(stderr, "Unable to set iteration limit to 1.\n");
+		goto TERMINATE;
+	}
+
+TERMINATE:
+
+	return status;
+}
+
+
+/** Function: entering_arc
+ ** This method receives three arrays with the reduced costs of both objective
+ ** functions and a valid basis, a scratch array to hold the ratios and also
+ ** receives an integer equal to the number of arcs in the problem (size of the
+ ** arrays). It returns an integer equal to the index of the arc that will
+ ** enter the basis.
+ **/
+int entering_arc(double * dj1, double * dj2, int * basis, double * ratios, int size)
+{
+	int arc = 0;
+	int i;
+
+	/* Sanity check of input data arrays --- if one of them its NULL the function
+	 * exists with a value of -1
+	 */
+	if(!dj1 || !dj2 || !basis || !ratios) {
+		fprintf(stderr, "Error due to NULL pointer when calculating entering arc.\n");
+		return -1;
+	}
+
+	/* Calculate the ratio between the reduced costs of objective function 1 and
+	 * objective function 2.
+	 */
+	for(i = 0; i < size; i++) {
+		/* The ratio test must follow:
+		 * if basis[i] != 1 AND basis[i] == 0 (arc at lower bound) ----> dj2[i] must be < 0
+		 * if basis[i] != 1 AND basis[i] == 2 (arc at upper bound) ----> dj2[i] must be > 0
+		 */
+		if(basis[i] != 1 && basis[i] == 0 && dj2[i] < 0) {
+			ratios[i] = dj2[i] / dj1[i];
+#ifdef SOLVER_DEBUG
+			printf("DJ1: %lf DJ: %lf\n", dj1[i], dj2[i]);
+			printf("Ratio %d: %lf\n", i, ratios[i]);
+#endif
+		} else if(basis[i] != 1 && basis[i] == 2 && dj2[i] > 0) {
+			ratios[i] = dj2[i] / dj1[i];
+#ifdef SOLVER_DEBUG
+			printf("DJ1: %lf DJ: %lf\n", dj1[i], dj2[i]);
+			printf("Ratio %d: %lf\n", i, ratios[i]);
+#endif
+		} else {
+			ratios[i] = 0;
+		}
+	}
+
+	/* Find the best ratio, i.e., the slope that gives the highest rate of
+	 * decrease in the objective function 2.
+	 */
+
+	for(i = 0; i < size; i++) {
+		if(ratios[i] != 0) {
+			if(ratios[i] < ratios[arc]) {
+				arc = i;
+			}
+		}
+	}
+
+	return arc;
+}
+
+
+/** Function: open_objective
+ ** Opens a CPLEX environment and an LP object for the objective function with
+ ** the given number and copies the network read from filename into it. If
+ ** filename is NULL the LP object is left empty for the caller to fill. The
+ ** screen output is turned off and the iteration limit is set to 1.
+ **/
+static int open_objective(CPXENVptr * env_p, CPXLPptr * lp_p, const char * filename, int number)
+{
+	int status = 0;
+	CPXNETptr net = NULL;
+	char name[32];
+
+	*env_p = CPXopenCPLEX(&status);
+	if(!*env_p) {
+		char errmsg[CPXMESSAGEBUFSIZE];
+		CPXgeterrorstring(*env_p, status, errmsg);
+		fprintf(stderr, "Unable to start CPLEX environment %d, %d, %s\n", number, status, errmsg);
+		return status ? status : -1;
+	}
+
+	/* the LP problem object is also created now ***/
+	snprintf(name, sizeof(name), "lp%d", number);
+	*lp_p = CPXcreateprob(*env_p, &status, name);
+	if(!*lp_p) {
+		fprintf(stderr, "Unable to create LP problem object %d.\n", number);
+		return status ? status : -1;
+	}
+
+	/* finally the objective function problem data is copied from the file.
+	 * copy_cplex_problem() sets the NET object free when it is done with it.
+	 */
+	if(filename) {
+		snprintf(name, sizeof(name), "network%d", number);
+		net = CPXNETcreateprob(*env_p, &status, name);
+		if(!net) {
+			fprintf(stderr, "Unable to create NET problem object %d.\n", number);
+			return status ? status : -1;
+		}
+
+		status = copy_cplex_problem(*env_p, net, *lp_p, filename);
+		if(status) {
+			fprintf(stderr, "An error ocurred copying problem %d data.\n", number);
+			return status;
+		}
+	}
+
+	/*** CPLEX PARAMETERS SETTINGS:
+	 *** 	- CPLEX SCREEN OUTPUT   = OFF
+	 ***	- CPLEX ITERATION LIMIT = 1
+	 ***/
+	status = CPXsetintparam(*env_p, CPX_PARAM_SCRIND, CPX_OFF);
+	if(status) {
+		fprintf(stderr, "Unable to set screen output.\n");
+		return status;
+	}
+
+	status = CPXsetintparam(*env_p, CPX_PARAM_ITLIM, 1);
+	if(status) {
+		fprintf(stderr, "Unable to set iteration limit to 1.\n");
+		return status;
+	}
+
+	return 0;
+}
+
+
+/** Function: prepare_loop
+ ** Sets the parameters used by the pivot loop on both environments of a
+ ** loaded context and allocs the memory used during the optimization.
+ **/
+static int prepare_loop(SOLVER_CTX * ctx)
+{
+	int status = 0;
+
+	/* Turn off presolve and set parameters for CPLEX accept advanced basis.
+	 * Both environments are set as the backward walk pivots on objective 1.
+	 */
+	status = set_loop_parameters(ctx->env1);
+	if(status) {
+		return status;
+	}
+
+	status = set_loop_parameters(ctx->env2);
+	if(status) {
+		return status;
+	}
+
+	/* Geting the number of arcs and number of nodes with:
+	 *		n. of arcs  = n. of cols
+	 *		n. of nodes = n. of rows
+	 */
+	ctx->narcs  = CPXgetnumcols(ctx->env1, ctx->lp1);
+	ctx->nnodes = CPXgetnumrows(ctx->env1, ctx->lp1);
+
+	if(ctx->narcs != CPXgetnumcols(ctx->env2, ctx->lp2) ||
+	   ctx->nnodes != CPXgetnumrows(ctx->env2, ctx->lp2)) {
+		fprintf(stderr, "Both networks must have the same number of arcs and nodes.\n");
+		return -1;
+	}
+
+	/* solution1 object holds the status of the solution relative to the first
+	 * objective function.
+	 */
+	ctx->solution1 = create_solution(ctx->narcs, ctx->nnodes);
+	if(!ctx->solution1) {
+		fprintf(stderr, "Error on solution 1 alloc.\n");
+		return -1;
+	}
+
+	/* solution2 object holds the information of the solution relative to the
+	 * second objective function. Notice that the data stored in solution2->basis
+	 * must be the same ALWAYS as the data stored in solution1->basis. If this
+	 * does not hold, something is wrong with the optimization.
+	 */
+	ctx->solution2 = create_solution(ctx->narcs, ctx->nnodes);
+	if(!ctx->solution2) {
+		fprintf(stderr, "Error on solution 2 alloc.\n");
+		return -1;
+	}
+
+	/* scratch buffer of the ratio test made by entering_arc() */
+	ctx->ratios = mem_alloc(ctx->narcs * sizeof(double));
+	if(!ctx->ratios) {
+		fprintf(stderr, "Unable to alloc ratios array.\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/** Function: set_loop_parameters
+ ** Turns off presolve, aggregation and scaling and sets CPLEX to accept an
+ ** advanced basis on the given environment so that CPXpivot works on the
+ ** basis loaded by the solver.
+ **/
+static int set_loop_parameters(CPXENVptr env)
+{
+	int status = 0;
+
+	status = CPXsetintparam(env, CPX_PARAM_ADVIND, 2);
+	if(status) {
+		fprintf(stderr, "Unable to set advanced start switch to 1.\n");
+		return status;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_PREIND, CPX_OFF);
+	if(status) {
+		fprintf(stderr, "Error turning off presolve. ERROR %d\n", status);
+		return status;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_AGGIND, 0);
+	if(status) {
+		fprintf(stderr, "Error turning off aggregator. ERROR: %d\n", status);
+		return status;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_DEPIND, 0);
+	if(status) {
+		fprintf(stderr, "Error turning off DEPIND. ERROR: %d\n", status);
+		return status;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_PREDUAL, -1);
+	if(status) {
+		fprintf(stderr, "Error turning off PREDUAL. ERROR: %d\n", status);
+		return status;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_PREPASS, 0);
+	if(status) {
+		fprintf(stderr, "Error turning off PREPASS. ERROR: %d\n", status);
+		return status;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_SCAIND, -1);
+	if(status) {
+		fprintf(stderr, "Error turning off SCAIND. ERROR: %d\n", status);
+		return status;
+	}
+
+	status = CPXsetintparam(env, CPX_PARAM_SIMDISPLAY, 2);
+	if(status) {
+		fprintf(stderr, "Error setting SIMDISPLAY. ERROR: %d\n", status);
+		return status;
+	}
+
+	return 0;
+}
+
+
+/** Function: notify_iteration
+ ** Hands the current solutions of the context to the iteration callback. If
+ ** the callback asks the solver to stop, the context is marked as finished.
+ **/
+static int notify_iteration(SOLVER_CTX * ctx, int arc, double elapsed)
+{
+	SOLVER_ITERATION it;
+
+	if(approx_active(ctx) && !approx_keep(ctx)) {
+		return 0;
+	}
+
+	if(!ctx->callback) {
+		return 0;
+	}
+
+	it.iteration = ctx->iteration;
+	it.arc = arc;
+	it.elapsed = elapsed;
+	it.solution1 = ctx->solution1;
+	it.solution2 = ctx->solution2;
+
+	if(ctx->callback(&it, ctx->cbdata)) {
+		ctx->finished = 1;
+		ctx->stop = SOLVER_STOP_CALLBACK;
+	}
+
+	return 0;
+}
+
+
+/** Function: solver_benchmark_anchors
+ ** Solves the three anchor problems of a loaded context (both objectives and
+ ** the perturbation of the walk direction) with every engine and prints the
+ ** times, the simplex iterations and the objective values found, which must
+ ** agree between engines. The context itself is left untouched.
+ **/
+int solver_benchmark_anchors(SOLVER_CTX * ctx, FILE * out)
+{
+	static const char * phases[3] = {"objective 1", "objective 2", "perturbation"};
+	static const int engines[] = {ANCHOR_SIMPLEX, ANCHOR_SCALING, ANCHOR_DUAL, ANCHOR_NETWORK, ANCHOR_BARRIER};
+	static const int nengines = sizeof(engines) / sizeof(engines[0]);
+	double weight = PERTURBATION_WEIGHT;
+	int phase, e;
+
+	if(!ctx || !ctx->lp1 || !ctx->lp2 || !out) {
+		return -1;
+	}
+
+	if(ctx->direction == SOLVER_BACKWARD) {
+		weight = 1.0 - PERTURBATION_WEIGHT;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Anchor Solve Benchmark:\n\n");
+	fprintf(out, "%-14s %-8s %18s %10s %10s %10s %10s\n",
+	        "phase", "engine", "objective", "seed (s)", "simplex(s)", "total (s)", "pivots");
+
+	for(phase = 0; phase < 3; phase++) {
+		double reference = 0.0;
+		int has_reference = 0;
+
+		for(e = 0; e < nengines; e++) {
+			NET_SOLUTION * solution;
+			ANCHOR_STATS stats;
+
+			if(phase == 0) {
+				solution = get_objective_solution(ctx->env1, ctx->lp1, engines[e], &ctx->portfolio, NULL, &stats);
+			} else if(phase == 1) {
+				solution = get_objective_solution(ctx->env2, ctx->lp2, engines[e], &ctx->portfolio, NULL, &stats);
+			} else {
+				solution = get_perturbation_solution(ctx->env1, ctx->env2, ctx->lp1, ctx->lp2,
+				                                     weight, engines[e], &ctx->portfolio, NULL, &stats);
+			}
+
+			if(!solution) {
+				fprintf(out, "%-14s %-8s %18s\n", phases[phase], anchor_engine_name(engines[e]), "failed");
+				continue;
+			}
+
+			fprintf(out, "%-14s %-8s %18.6lf %10.4lf %10.4lf %10.4lf %10d%s",
+			        phases[phase], anchor_engine_name(engines[e]), solution->objval,
+			        stats.seed_time, stats.simplex_time, stats.seed_time + stats.simplex_time,
+			        stats.iterations, engines[e] == ANCHOR_SCALING && !stats.seeded ? " (fallback)" : "");
+
+			if(!has_reference) {
+				reference = solution->objval;
+				has_reference = 1;
+			} else if(fabs(solution->objval - reference) > 1e-6 * (1.0 + fabs(reference))) {
+				fprintf(out, " MISMATCH");
+			}
+			fprintf(out, "\n");
+
+			free_solution(&solution);
+		}
+	}
+
+	fprintf(out, "\n");
+
+	return 0;
+}
+
+
+/** Function: solver_reset
+ ** Drops the anchor and perturbation solutions of the last run so the next
+ ** solver_run() walks the frontier again. Their bases are kept as warm starts
+ ** of the next anchor solves, which only need a few pivots when the problem
+ ** was changed a little in between. The time budget starts over.
+ **/
+int solver_reset(SOLVER_CTX * ctx)
+{
+	const NET_SOLUTION * anchor;
+
+	if(!ctx) {
+		return -1;
+	}
+
+	anchor = ctx->direction == SOLVER_BACKWARD ? ctx->initial_sol1 : ctx->initial_sol2;
+
+	if((anchor || ctx->perturbsol) &&
+	   solver_set_warm_start(ctx, anchor ? anchor->basis : NULL, ctx->perturbsol ? ctx->perturbsol->basis : NULL)) {
+		return -1;
+	}
+
+	free_solution(&ctx->initial_sol1);
+	free_solution(&ctx->initial_sol2);
+	free_solution(&ctx->perturbsol);
+	free_basis_tree(&ctx->tree);
+	free_gaps(ctx);
+
+	ctx->iteration = 0;
+	ctx->finished = 0;
+	ctx->stop = SOLVER_STOP_NONE;
+	ctx->interrupted = 0;
+	ctx->deadline = ctx->time_budget > 0.0 ? trace_clock() + ctx->time_budget : 0.0;
+
+	return 0;
+}
+
+
+/** Function: solver_set_warm_start
+ ** Replaces the warm start bases of the next anchor and perturbation solves
+ ** by copies of the given ones, e.g. those of a similar problem solved by
+ ** another context. A NULL basis keeps the current warm start.
+ **/
+int solver_set_warm_start(SOLVER_CTX * ctx, const NET_BASIS * anchor, const NET_BASIS * perturb)
+{
+	if(!ctx || !ctx->narcs) {
+		return -1;
+	}
+
+	if(anchor) {
+		if(!ctx->warm_anchor) {
+			ctx->warm_anchor = create_basis(ctx->narcs, ctx->nnodes);
+		}
+		copy_basis(ctx->warm_anchor, anchor, ctx->narcs, ctx->nnodes);
+	}
+
+	if(perturb) {
+		if(!ctx->warm_perturb) {
+			ctx->warm_perturb = create_basis(ctx->narcs, ctx->nnodes);
+		}
+		copy_basis(ctx->warm_perturb, perturb, ctx->narcs, ctx->nnodes);
+	}
+
+	if((anchor && !ctx->warm_anchor) || (perturb && !ctx->warm_perturb)) {
+		fprintf(stderr, "Unable to alloc warm start bases.\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/** Function: solver_change_costs
+ ** Sets the cost of cnt arcs of the given objective (1 or 2) to the values
+ ** given. The change takes effect on the next run, see solver_reset().
+ **/
+int solver_change_costs(SOLVER_CTX * ctx, int objective, int cnt, const int * arcs, const double * values)
+{
+	int status = 0;
+
+	if(!ctx || !ctx->lp1 || !ctx->lp2 || (objective != 1 && objective != 2)) {
+		return -1;
+	}
+
+	/* the arcs of a reduced network are not those of the input files */
+	if(ctx->reduction) {
+		fprintf(stderr, "Unable to change a reduced network.\n");
+		return -1;
+	}
+
+	if(objective == 1) {
+		status = CPXchgobj(ctx->env1, ctx->lp1, cnt, arcs, values);
+	} else {
+		status = CPXchgobj(ctx->env2, ctx->lp2, cnt, arcs, values);
+	}
+	if(status) {
+		fprintf(stderr, "Unable to change costs of objective %d.\n", objective);
+		return status;
+	}
+
+	ctx->changed_costs = 1;
+
+	return 0;
+}
+
+
+/** Function: solver_change_supplies
+ ** Sets the supply of cnt nodes, with the sign used by the network files, in
+ ** the LP objects of both objectives.
+ **/
+int solver_change_supplies(SOLVER_CTX * ctx, int cnt, const int * nodes, const double * values)
+{
+	int status = 0;
+	int sign;
+	int i;
+	double * rhs = NULL;
+
+	if(!ctx || !ctx->lp1 || !ctx->lp2) {
+		return -1;
+	}
+
+	if(ctx->reduction) {
+		fprintf(stderr, "Unable to change a reduced network.\n");
+		return -1;
+	}
+
+	sign = supply_sign(ctx);
+	if(!sign) {
+		return -1;
+	}
+
+	rhs = malloc(cnt * sizeof(double));
+	if(!rhs) {
+		fprintf(stderr, "Unable to alloc rhs array.\n");
+		return -1;
+	}
+
+	for(i = 0; i < cnt; i++) {
+		rhs[i] = sign * values[i];
+	}
+
+	status = CPXchgrhs(ctx->env1, ctx->lp1, cnt, nodes, rhs);
+	if(!status) status = CPXchgrhs(ctx->env2, ctx->lp2, cnt, nodes, rhs);
+	if(status) {
+		fprintf(stderr, "Unable to change supplies.\n");
+	} else {
+		ctx->changed_bounds = 1;
+	}
+
+	free(rhs);
+
+	return status;
+}
+
+
+/** Function: solver_change_bounds
+ ** Sets the lower ('L'), upper ('U') or both ('B') flow bounds of cnt arcs in
+ ** the LP objects of both objectives.
+ **/
+int solver_change_bounds(SOLVER_CTX * ctx, int cnt, const int * arcs, const char * lu, const double * values)
+{
+	int status = 0;
+
+	if(!ctx || !ctx->lp1 || !ctx->lp2) {
+		return -1;
+	}
+
+	if(ctx->reduction) {
+		fprintf(stderr, "Unable to change a reduced network.\n");
+		return -1;
+	}
+
+	status = CPXchgbds(ctx->env1, ctx->lp1, cnt, arcs, lu, values);
+	if(!status) status = CPXchgbds(ctx->env2, ctx->lp2, cnt, arcs, lu, values);
+	if(status) {
+		fprintf(stderr, "Unable to change bounds.\n");
+		return status;
+	}
+
+	ctx->changed_bounds = 1;
+
+	return 0;
+}
+
+
+/** Function: load_topology
+ ** Reads both networks, checks they only differ by their costs and copies
+ ** them with the costs of each objective into the (empty) LP objects of the
+ ** context, reduced first if the reduction is on. With the native loader on,
+ ** read_dimacs() parses both files in one pass and checks their arcs itself.
+ **/
+static int load_topology(SOLVER_CTX * ctx, const char * net_file1, const char * net_file2)
+{
+	int status = 0;
+	NET_TOPOLOGY * topo1 = NULL;
+	NET_TOPOLOGY * topo2 = NULL;
+	double * costs1 = NULL;
+	double * costs2 = NULL;
+
+	if(ctx->load_threads) {
+		status = read_dimacs(net_file1, net_file2, ctx->load_threads, &topo1, &costs1, &costs2);
+		if(status) {
+			goto TERMINATE;
+		}
+	} else {
+		status = read_network(ctx->env1, net_file1, &topo1, &costs1);
+		if(status) {
+			goto TERMINATE;
+		}
+
+		status = read_network(ctx->env2, net_file2, &topo2, &costs2);
+		if(status) {
+			goto TERMINATE;
+		}
+
+		if(!same_topology(topo1, topo2)) {
+			fprintf(stderr, "Both networks must have the same arcs, bounds and supplies to be reduced.\n");
+			status = -1;
+			goto TERMINATE;
+		}
+	}
+
+	if(!ctx->reduce) {
+		status = copy_topology_to_lp(ctx->env1, ctx->lp1, topo1, costs1);
+		if(!status) status = copy_topology_to_lp(ctx->env2, ctx->lp2, topo1, costs2);
+
+		/* the files are not read again to orient the supplies */
+		if(!status && !topology_sign(ctx, topo1)) {
+			status = -1;
+		}
+		goto TERMINATE;
+	}
+
+	ctx->reduction = reduce_network(topo1, costs1, costs2);
+	if(!ctx->reduction) {
+		status = -1;
+		goto TERMINATE;
+	}
+
+	status = copy_topology_to_lp(ctx->env1, ctx->lp1, ctx->reduction->topo, ctx->reduction->costs1);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	status = copy_topology_to_lp(ctx->env2, ctx->lp2, ctx->reduction->topo, ctx->reduction->costs2);
+
+TERMINATE:
+
+	free_topology(&topo1);
+	free_topology(&topo2);
+	free(costs1);
+	free(costs2);
+
+	return status;
+}
+
+
+/** Function: add_offsets
+ ** Adds the cost of the flows fixed by the network reduction to the objective
+ ** values of both current solutions, so they are values of the original
+ ** network.
+ **/
+static void add_offsets(SOLVER_CTX * ctx)
+{
+	if(!ctx->reduction) {
+		return;
+	}
+
+	ctx->solution1->objval += ctx->reduction->offset1;
+	ctx->solution2->objval += ctx->reduction->offset2;
+}
+
+
+/** Function: target_reached
+ ** Returns 1 if the pivoted objective reached its global minimum, which is
+ ** the stop criterion of the walk.
+ **/
+static int target_reached(const SOLVER_CTX * ctx)
+{
+	if(ctx->gap >= 0) {
+		double p, s, target = ctx->gaps[ctx->gap].target;
+
+		objective_pair(ctx, &p, &s);
+		return !(p > target + APPROX_TOL * (1.0 + fabs(target)));
+	}
+
+	if(ctx->direction == SOLVER_BACKWARD) {
+		return ctx->initial_sol1 && !(ctx->solution1->objval > ctx->initial_sol1->objval);
+	}
+
+	return ctx->initial_sol2 && !(ctx->solution2->objval > ctx->initial_sol2->objval);
+}
+
+
+/** Function: copy_string
+ ** Returns a newly alloc'd copy of the string s or NULL on failure.
+ **/
+static char * copy_string(const char * s)
+{
+	size_t len = strlen(s) + 1;
+	char * copy = malloc(len);
+
+	if(copy) {
+		memcpy(copy, s, len);
+	}
+
+	return copy;
+}
+
+
+/** Function: warm_engine
+ ** Returns the engine of the next anchor solve. A warm start basis stays
+ ** dual feasible when only supplies or bounds changed, so dual simplex is
+ ** used then; after a change of costs it is re-optimized by primal simplex.
+ ** Without warm starts the configured engine is kept.
+ **/
+static int warm_engine(const SOLVER_CTX * ctx, int engine)
+{
+	if(!ctx->warm_anchor && !ctx->warm_perturb) {
+		return engine;
+	}
+
+	return (ctx->changed_bounds && !ctx->changed_costs) ? ANCHOR_DUAL : ANCHOR_SIMPLEX;
+}
+
+
+/** Function: supply_sign
+ ** Returns 1 if the right-hand sides of the LP objects are the supplies of the
+ ** network files and -1 if they are their opposites, which depends on how
+ ** CPLEX oriented the flow conservation rows. The first arc of the file is
+ ** compared with the first column of the LP. Returns 0 on error.
+ **/
+static int supply_sign(SOLVER_CTX * ctx)
+{
+	NET_TOPOLOGY * topo = NULL;
+	double * costs = NULL;
+
+	if(ctx->supply_sign) {
+		return ctx->supply_sign;
+	}
+
+	if(read_network(ctx->env1, ctx->net_file1, &topo, &costs)) {
+		return 0;
+	}
+
+	topology_sign(ctx, topo);
+
+	free_topology(&topo);
+	free(costs);
+
+	return ctx->supply_sign;
+}
+
+
+/** Function: topology_sign
+ ** Sets the supply sign of the context by comparing the first arc of the
+ ** topology the LP objects were built from with the first column of the LP.
+ **/
+static int topology_sign(SOLVER_CTX * ctx, const NET_TOPOLOGY * topo)
+{
+	int nzcnt, surplus;
+	int matbeg;
+	int rows[2];
+	double vals[2];
+
+	ctx->supply_sign = 1;
+	if(topo->narcs > 0 &&
+	   !CPXgetcols(ctx->env1, ctx->lp1, &nzcnt, &matbeg, rows, vals, 2, &surplus, 0, 0) && nzcnt == 2) {
+		int lp_tail = vals[0] > 0.0 ? rows[0] : rows[1];
+		ctx->supply_sign = lp_tail == topo->tail[0] ? 1 : -1;
+	}
+
+	return ctx->supply_sign;
+}
+
+
+/** Function: solver_pivot_report
+ ** Prints how many steps of the walk changed the basis and how many only
+ ** moved the entering arc to its other bound.
+ **/
+void solver_pivot_report(FILE * out, const SOLVER_CTX * ctx)
+{
+	if(!out || !ctx || ctx->pivots + ctx->flips == 0) {
+		return;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Pivots:\n\n");
+	fprintf(out, "Basis changes:\t%d\n", ctx->pivots);
+	fprintf(out, "Bound flips:\t%d\n\n", ctx->flips);
+}
+
+
+/** Function: solver_anytime_report
+ ** Prints why the walk stopped, how often the anytime mode jumped ahead and
+ ** how many of the gaps it left were walked afterwards.
+ **/
+void solver_anytime_report(FILE * out, const SOLVER_CTX * ctx)
+{
+	static const char * reasons[] = {"anchor reached", "callback", "budget", "signal"};
+
+	if(!out || !ctx || (ctx->deadline <= 0.0 && ctx->iteration_budget == 0 && ctx->stop != SOLVER_STOP_SIGNAL)) {
+		return;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Anytime:\n\n");
+	fprintf(out, "Stopped by:\t%s\n", reasons[ctx->stop]);
+	fprintf(out, "Iterations:\t%d\n", ctx->iteration);
+	fprintf(out, "Jumps:\t%d\n", ctx->approx.jumps);
+	fprintf(out, "Gaps walked:\t%d\n", ctx->gaps_walked);
+	fprintf(out, "Gaps left:\t%d\n\n", ctx->ngaps);
+}
+
+
+/** Function: solver_approx_report
+ ** Prints the outcome of the approximation mode of the last walk: the
+ ** tolerance used, the points reported and skipped, the jumps made and the
+ ** approximation factor guaranteed for the reported points.
+ **/
+void solver_approx_report(FILE * out, const SOLVER_CTX * ctx)
+{
+	if(!out || !ctx || !approx_active(ctx)) {
+		return;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Approximation:\n\n");
+	fprintf(out, "Tolerance:\t%lf\n", ctx->approx.eps);
+	fprintf(out, "Recorded points:\t%d\n", ctx->approx.recorded);
+	fprintf(out, "Skipped points:\t%d\n", ctx->approx.skipped);
+	fprintf(out, "Weighted-sum jumps:\t%d\n", ctx->approx.jumps);
+	fprintf(out, "Guaranteed factor:\t1 + %lf\n\n", ctx->approx.factor);
+}
+
+
+/** Function: approx_active
+ ** Returns 1 if the approximation mode is on.
+ **/
+static int approx_active(const SOLVER_CTX * ctx)
+{
+	return ctx->approx_eps > 0.0 || ctx->approx_points > 0;
+}
+
+
+/** Function: approx_keep
+ ** Decides if the current point of the walk is reported. Walking forward the
+ ** pivoted objective p decreases and the secondary one s increases, so the
+ ** last reported point covers the current one within 1 + g in both
+ ** objectives, g being the relative decrease of p since then. The point is
+ ** skipped while g stays within eps; the first point past it, the first one
+ ** of the walk and the last one are always reported.
+ **/
+static int approx_keep(SOLVER_CTX * ctx)
+{
+	APPROX_STATE * a = &ctx->approx;
+	double p, s, gap;
+
+	objective_pair(ctx, &p, &s);
+
+	if(ctx->iteration == 0) {
+		const NET_SOLUTION * anchor = ctx->direction == SOLVER_BACKWARD ? ctx->initial_sol1 : ctx->initial_sol2;
+		double end_p = anchor->objval;
+
+		memset(a, 0, sizeof(APPROX_STATE));
+		a->eps = ctx->approx_eps;
+
+		/* the geometric spacing that fits max_points points between both ends */
+		if(ctx->approx_points > 1 && p > end_p) {
+			double eps;
+
+			if(end_p >= APPROX_FLOOR) {
+				eps = pow(p / end_p, 1.0 / (ctx->approx_points - 1)) - 1.0;
+			} else {
+				eps = (p - end_p) / (ctx->approx_points - 1) / APPROX_FLOOR;
+			}
+
+			if(eps > a->eps) {
+				a->eps = eps;
+			}
+		}
+
+		a->anchor_s = HUGE_VAL;
+		a->last_p = p;
+		a->last_s = s;
+		a->recorded = 1;
+
+		return 1;
+	}
+
+	gap = relative_gap(a->last_p, p);
+
+	if(gap > a->eps || ctx->finished) {
+		a->last_p = p;
+		a->last_s = s;
+		a->since = 0;
+		a->recorded++;
+		return 1;
+	}
+
+	if(gap > a->factor) {
+		a->factor = gap;
+	}
+	a->since++;
+	a->skipped++;
+
+	return 0;
+}
+
+
+/** Function: approx_jump
+ ** Moves the walk from the current point c to the minimum r of the weighted
+ ** sum whose level lines are parallel to the chord between c and the far end
+ ** of the walk (the next step of the non-inferior set estimation method),
+ ** warm started from the current basis. The far end is the anchor, or the
+ ** end point of the gap being walked, so r never leaves the gap. If r is c,
+ ** the frontier from c to the far end is a single segment and the walk jumps
+ ** to the far end. Points
+ ** skipped by the jump have p within [r.p, c.p] and s within [c.s, r.s], so
+ ** the last reported point or r covers them within the smaller of the two
+ ** gaps below, which is added to the guaranteed factor.
+ **/
+static int approx_jump(SOLVER_CTX * ctx)
+{
+	int status = 0;
+	APPROX_STATE * a = &ctx->approx;
+	const NET_SOLUTION * anchor = ctx->direction == SOLVER_BACKWARD ? ctx->initial_sol1 : ctx->initial_sol2;
+	NET_SOLUTION * jump = NULL;
+	double c_p, c_s, r_p, r_s;
+	double end_p, end_s;
+	double dp, ds, weight;
+
+	a->since = 0;
+	objective_pair(ctx, &c_p, &c_s);
+
+	if(ctx->gap >= 0) {
+		end_p = ctx->gaps[ctx->gap].target;
+		end_s = ctx->direction == SOLVER_BACKWARD ? ctx->gaps[ctx->gap].end2 : ctx->gaps[ctx->gap].end1;
+	} else {
+		/* the secondary objective at the anchor, computed on the first jump */
+		status = anchor_secondary(ctx);
+		if(status) {
+			return status;
+		}
+		end_p = anchor->objval;
+		end_s = a->anchor_s;
+	}
+
+	/* w*z1 + (1 - w)*z2 is constant along the chord */
+	dp = c_p - end_p;
+	ds = end_s - c_s;
+	if(dp <= 0.0 || ds <= 0.0) {
+		return load_far_end(ctx);
+	}
+
+	weight = ctx->direction == SOLVER_BACKWARD ? ds / (dp + ds) : dp / (dp + ds);
+
+	jump = get_perturbation_solution(ctx->env1, ctx->env2, ctx->lp1, ctx->lp2, weight, ANCHOR_SIMPLEX, NULL,
+	                                 (ctx->direction == SOLVER_BACKWARD ? ctx->solution1 : ctx->solution2)->basis,
+	                                 NULL);
+	if(!jump) {
+		fprintf(stderr, "Weighted-sum jump failed.\n");
+		return -1;
+	}
+
+	status = load_basis(ctx, jump->basis);
+	free_solution(&jump);
+	if(status) {
+		return status;
+	}
+
+	objective_pair(ctx, &r_p, &r_s);
+
+	if(!(r_p < c_p - APPROX_TOL * (1.0 + fabs(c_p)))) {
+		status = load_far_end(ctx);
+		if(status) {
+			return status;
+		}
+		objective_pair(ctx, &r_p, &r_s);
+	}
+
+	dp = relative_gap(a->last_p, r_p);
+	ds = relative_gap(r_s, c_s);
+	if((dp < ds ? dp : ds) > a->factor) {
+		a->factor = dp < ds ? dp : ds;
+	}
+	a->jumps++;
+
+	return 0;
+}
+
+
+/** Function: load_far_end
+ ** Loads the basis of the far end of the walk: the end point of the gap
+ ** being walked, or the anchor.
+ **/
+static int load_far_end(SOLVER_CTX * ctx)
+{
+	NET_BASIS * basis;
+	int status = 0;
+
+	if(ctx->gap < 0) {
+		return load_basis(ctx, (ctx->direction == SOLVER_BACKWARD ? ctx->initial_sol1 : ctx->initial_sol2)->basis);
+	}
+
+	basis = create_basis(ctx->narcs, ctx->nnodes);
+	if(!basis) {
+		fprintf(stderr, "Unable to alloc the basis of a gap.\n");
+		return -1;
+	}
+
+	unpack_basis(basis, ctx->gaps[ctx->gap].end_basis, ctx->narcs, ctx->nnodes);
+	status = load_basis(ctx, basis);
+	free_basis(&basis);
+
+	return status;
+}
+
+
+/** Function: anchor_secondary
+ ** Computes the secondary objective value of the anchor of the walk into the
+ ** approximation state, once per walk.
+ **/
+static int anchor_secondary(SOLVER_CTX * ctx)
+{
+	APPROX_STATE * a = &ctx->approx;
+	const NET_SOLUTION * anchor = ctx->direction == SOLVER_BACKWARD ? ctx->initial_sol1 : ctx->initial_sol2;
+	CPXENVptr senv = ctx->direction == SOLVER_BACKWARD ? ctx->env2 : ctx->env1;
+	CPXLPptr slp = ctx->direction == SOLVER_BACKWARD ? ctx->lp2 : ctx->lp1;
+	double * costs;
+	int i;
+
+	if(a->anchor_s != HUGE_VAL) {
+		return 0;
+	}
+
+	costs = malloc(ctx->narcs * sizeof(double));
+	if(!costs || CPXgetobj(senv, slp, costs, 0, ctx->narcs - 1)) {
+		fprintf(stderr, "Unable to get costs of the secondary objective.\n");
+		free(costs);
+		return -1;
+	}
+
+	a->anchor_s = 0.0;
+	for(i = 0; i < ctx->narcs; i++) {
+		a->anchor_s += costs[i] * anchor->x[i];
+	}
+	if(ctx->reduction) {
+		a->anchor_s += ctx->direction == SOLVER_BACKWARD ? ctx->reduction->offset2 : ctx->reduction->offset1;
+	}
+
+	free(costs);
+
+	return 0;
+}
+
+
+/** Function: load_basis
+ ** Loads the given basis into the LP objects of both objectives and the
+ ** basis tree, as the perturbation method does with its basis.
+ **/
+static int load_basis(SOLVER_CTX * ctx, const NET_BASIS * basis)
+{
+	int status = 0;
+
+	status = update_solution(ctx->env1, ctx->lp1, basis, ctx->solution1);
+	if(status) {
+		return status;
+	}
+
+	status = update_solution(ctx->env2, ctx->lp2, basis, ctx->solution2);
+	if(status) {
+		return status;
+	}
+
+	if(ctx->tree && basis_tree_load(ctx->tree, basis)) {
+		free_basis_tree(&ctx->tree);
+		fprintf(stderr, "Basis tree unavailable, CPLEX updates the secondary objective.\n");
+	}
+
+	add_offsets(ctx);
+
+	return 0;
+}
+
+
+/** Function: objective_pair
+ ** Returns the values of the pivoted and the secondary objectives of the
+ ** current solutions.
+ **/
+static void objective_pair(const SOLVER_CTX * ctx, double * p, double * s)
+{
+	if(ctx->direction == SOLVER_BACKWARD) {
+		*p = ctx->solution1->objval;
+		*s = ctx->solution2->objval;
+	} else {
+		*p = ctx->solution2->objval;
+		*s = ctx->solution1->objval;
+	}
+}
+
+
+/** Function: relative_gap
+ ** Returns (a - b) relative to the larger of |b| and APPROX_FLOOR.
+ **/
+static double relative_gap(double a, double b)
+{
+	double scale = fabs(b) > APPROX_FLOOR ? fabs(b) : APPROX_FLOOR;
+
+	return (a - b) / scale;
+}
+
+
+/** Function: flip_secondary
+ ** Follows a bound flip of the given arc on the secondary objective without
+ ** re-solving it. The flow moved by step around the cycle of the arc, which
+ ** changes the objective by its reduced cost times step. The offset of a
+ ** reduced network is left out since add_offsets() adds it again.
+ **/
+static void flip_secondary(SOLVER_CTX * ctx, int arc, double step)
+{
+	NET_SOLUTION * psol = ctx->direction == SOLVER_FORWARD ? ctx->solution2 : ctx->solution1;
+	NET_SOLUTION * ssol = ctx->direction == SOLVER_FORWARD ? ctx->solution1 : ctx->solution2;
+
+	ssol->objval += ssol->dj[arc] * step;
+	if(ctx->reduction) {
+		ssol->objval -= ctx->direction == SOLVER_FORWARD ? ctx->reduction->offset1 : ctx->reduction->offset2;
+	}
+
+	memcpy(ssol->x, psol->x, ctx->narcs * sizeof(double));
+	memcpy(ssol->slack, psol->slack, ctx->nnodes * sizeof(double));
+	ssol->basis->arc_basis[arc] = psol->basis->arc_basis[arc];
+	ssol->solstat = psol->solstat;
+}
+
+
+/** Function: out_of_budget
+ ** Returns 1 and sets the stop reason if the walk must stop before its next
+ ** step: solver_interrupt() was called or the budget ran out.
+ **/
+static int out_of_budget(SOLVER_CTX * ctx)
+{
+	if(ctx->interrupted) {
+		ctx->stop = SOLVER_STOP_SIGNAL;
+	} else if((ctx->deadline > 0.0 && trace_clock() >= ctx->deadline) ||
+	          (ctx->iteration_budget > 0 && ctx->iteration >= ctx->iteration_budget)) {
+		ctx->stop = SOLVER_STOP_BUDGET;
+	}
+
+	return ctx->stop != SOLVER_STOP_NONE;
+}
+
+
+/** Function: behind_schedule
+ ** Returns 1 if the walk to the anchor covered a smaller share of the range
+ ** of the pivoted objective than the share of the budget spent so far, and
+ ** walked at least ANYTIME_PIVOTS steps since its last jump. Gaps are walked
+ ** at whatever pace the budget left allows.
+ **/
+static int behind_schedule(const SOLVER_CTX * ctx)
+{
+	const NET_SOLUTION * anchor = ctx->direction == SOLVER_BACKWARD ? ctx->initial_sol1 : ctx->initial_sol2;
+	double p, s, spent = 0.0;
+
+	if(ctx->gap >= 0 || (ctx->deadline <= 0.0 && ctx->iteration_budget == 0) ||
+	   ctx->iteration - ctx->last_jump < ANYTIME_PIVOTS || !(ctx->start_p > anchor->objval)) {
+		return 0;
+	}
+
+	if(ctx->deadline > 0.0) {
+		spent = ctx->deadline > ctx->walk_start ?
+		        (trace_clock() - ctx->walk_start) / (ctx->deadline - ctx->walk_start) : 1.0;
+	}
+	if(ctx->iteration_budget > 0 && (double) ctx->iteration / ctx->iteration_budget > spent) {
+		spent = (double) ctx->iteration / ctx->iteration_budget;
+	}
+
+	objective_pair(ctx, &p, &s);
+
+	return (ctx->start_p - p) / (ctx->start_p - anchor->objval) < spent;
+}
+
+
+/** Function: anytime_jump
+ ** Moves the walk ahead by the weighted-sum jump of the approximation mode
+ ** and keeps the stretch between the current point and the one reached as a
+ ** gap, unless the jump found it to be a single segment.
+ **/
+static int anytime_jump(SOLVER_CTX * ctx)
+{
+	int status = 0;
+	double p, s;
+	double start1 = ctx->solution1->objval;
+	double start2 = ctx->solution2->objval;
+
+	/* the gap keeps the basis of the point the walk leaves */
+	status = add_gap(ctx, start1, start2, 0.0);
+	if(status) {
+		return status;
+	}
+
+	status = approx_jump(ctx);
+	if(status) {
+		return status;
+	}
+
+	ctx->last_jump = ctx->iteration + 1;
+
+	objective_pair(ctx, &p, &s);
+	ctx->gaps[ctx->ngaps - 1].end1 = ctx->solution1->objval;
+	ctx->gaps[ctx->ngaps - 1].end2 = ctx->solution2->objval;
+	ctx->gaps[ctx->ngaps - 1].target = p;
+	pack_basis(ctx->gaps[ctx->ngaps - 1].end_basis, ctx->solution1->basis, ctx->narcs, ctx->nnodes);
+
+	/* a single segment from the start point to the anchor has nothing to walk */
+	if(ctx->approx.anchor_s != HUGE_VAL && target_reached(ctx) &&
+	   !(s < ctx->approx.anchor_s - APPROX_TOL * (1.0 + fabs(ctx->approx.anchor_s)))) {
+		drop_gap(ctx, ctx->ngaps - 1);
+	}
+
+	return 0;
+}
+
+
+/** Function: add_gap
+ ** Appends a gap that starts at the current point, whose objective values are
+ ** (start1, start2), and packs the current basis into it. Its end, basis
+ ** included, is that point too until the caller sets it. target is the value of the pivoted
+ ** objective at the end.
+ **/
+static int add_gap(SOLVER_CTX * ctx, double start1, double start2, double target)
+{
+	SOLVER_GAP * gap;
+
+	if(ctx->ngaps == ctx->cgaps) {
+		int capacity = ctx->cgaps ? 2 * ctx->cgaps : 16;
+		SOLVER_GAP * gaps = realloc(ctx->gaps, capacity * sizeof(SOLVER_GAP));
+		if(!gaps) {
+			fprintf(stderr, "Unable to grow the gaps of the walk to %d.\n", capacity);
+			return -1;
+		}
+
+		ctx->gaps = gaps;
+		ctx->cgaps = capacity;
+	}
+
+	gap = &ctx->gaps[ctx->ngaps];
+	gap->basis = malloc(packed_basis_size(ctx->narcs, ctx->nnodes));
+	gap->end_basis = malloc(packed_basis_size(ctx->narcs, ctx->nnodes));
+	if(!gap->basis || !gap->end_basis) {
+		fprintf(stderr, "Unable to alloc the basis of a gap.\n");
+		free(gap->basis);
+		free(gap->end_basis);
+		return -1;
+	}
+
+	pack_basis(gap->basis, ctx->solution1->basis, ctx->narcs, ctx->nnodes);
+	pack_basis(gap->end_basis, ctx->solution1->basis, ctx->narcs, ctx->nnodes);
+	gap->start1 = gap->end1 = start1;
+	gap->start2 = gap->end2 = start2;
+	gap->target = target;
+	ctx->ngaps++;
+
+	return 0;
+}
+
+
+/** Function: drop_gap
+ ** Removes gap g, moving the last gap into its place.
+ **/
+static void drop_gap(SOLVER_CTX * ctx, int g)
+{
+	free(ctx->gaps[g].basis);
+	free(ctx->gaps[g].end_basis);
+	ctx->gaps[g] = ctx->gaps[--ctx->ngaps];
+}
+
+
+/** Function: walk_gap
+ ** Loads the start basis of the widest gap, the one spanning the largest box,
+ ** so the walk goes on from there until it reaches the end of the gap. The
+ ** start point was already reported and isn't reported again.
+ **/
+static int walk_gap(SOLVER_CTX * ctx)
+{
+	NET_BASIS * basis;
+	double area, widest = -1.0;
+	int status = 0;
+	int g;
+
+	for(g = 0; g < ctx->ngaps; g++) {
+		const SOLVER_GAP * gap = &ctx->gaps[g];
+
+		area = fabs(gap->end1 - gap->start1) * fabs(gap->end2 - gap->start2);
+		if(area > widest) {
+			widest = area;
+			ctx->gap = g;
+		}
+	}
+
+	basis = create_basis(ctx->narcs, ctx->nnodes);
+	if(!basis) {
+		fprintf(stderr, "Unable to alloc the basis of a gap.\n");
+		return -1;
+	}
+
+	unpack_basis(basis, ctx->gaps[ctx->gap].basis, ctx->narcs, ctx->nnodes);
+	status = load_basis(ctx, basis);
+	free_basis(&basis);
+	if(status) {
+		return status;
+	}
+
+	objective_pair(ctx, &ctx->approx.last_p, &ctx->approx.last_s);
+	ctx->finished = target_reached(ctx);
+
+	return 0;
+}
+
+
+/** Function: keep_remainder
+ ** Keeps what is left of the frontier when the walk stops early: the rest of
+ ** the gap being walked, or the stretch from the current point to the anchor.
+ **/
+static int keep_remainder(SOLVER_CTX * ctx)
+{
+	const NET_SOLUTION * anchor;
+	SOLVER_GAP * gap;
+	int status = 0;
+
+	if(ctx->gap >= 0) {
+		gap = &ctx->gaps[ctx->gap];
+		gap->start1 = ctx->solution1->objval;
+		gap->start2 = ctx->solution2->objval;
+		pack_basis(gap->basis, ctx->solution1->basis, ctx->narcs, ctx->nnodes);
+		ctx->gap = -1;
+		return 0;
+	}
+
+	/* a callback stops the walk on purpose, e.g. where another walk started */
+	if(ctx->stop == SOLVER_STOP_CALLBACK || target_reached(ctx)) {
+		return 0;
+	}
+
+	anchor = ctx->direction == SOLVER_BACKWARD ? ctx->initial_sol1 : ctx->initial_sol2;
+
+	status = anchor_secondary(ctx);
+	if(!status) {
+		status = add_gap(ctx, ctx->solution1->objval, ctx->solution2->objval, anchor->objval);
+	}
+	if(status) {
+		return status;
+	}
+
+	gap = &ctx->gaps[ctx->ngaps - 1];
+	pack_basis(gap->end_basis, anchor->basis, ctx->narcs, ctx->nnodes);
+	if(ctx->direction == SOLVER_BACKWARD) {
+		gap->end1 = anchor->objval;
+		gap->end2 = ctx->approx.anchor_s;
+	} else {
+		gap->end1 = ctx->approx.anchor_s;
+		gap->end2 = anchor->objval;
+	}
+
+	return 0;
+}
+
+
+/** Function: free_gaps
+ ** Frees every gap of the context.
+ **/
+static void free_gaps(SOLVER_CTX * ctx)
+{
+	while(ctx->ngaps > 0) {
+		drop_gap(ctx, ctx->ngaps - 1);
+	}
+
+	free(ctx->gaps);
+	ctx->gaps = NULL;
+	ctx->cgaps = 0;
+	ctx->gap = -1;
+}
@@ -0,0 +1,286 @@
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "trace.h"
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int same_value(double, double);
+static void add_times(double *, const TRACE_RECORD *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: open_trace_writer
+ ** Creates the trace file at path for a walk over a network of the given
+ ** size and direction and writes its header. Returns NULL on error.
+ **/
+TRACE * open_trace_writer(const char * path, int narcs, int nnodes, int direction)
+{
+	TRACE * trace = calloc(1, sizeof(TRACE));
+	if(!trace) {
+		fprintf(stderr, "Unable to alloc trace.\n");
+		return NULL;
+	}
+
+	trace->fp = fopen(path, "wb");
+	if(!trace->fp) {
+		fprintf(stderr, "Unable to create trace file %s.\n", path);
+		free(trace);
+		return NULL;
+	}
+
+	trace->writing = 1;
+	trace->header.magic = TRACE_MAGIC;
+	trace->header.version = TRACE_VERSION;
+	trace->header.narcs = narcs;
+	trace->header.nnodes = nnodes;
+	trace->header.direction = direction;
+
+	if(fwrite(&trace->header, sizeof(TRACE_HEADER), 1, trace->fp) != 1) {
+		fprintf(stderr, "Unable to write trace header.\n");
+		close_trace(&trace);
+		return NULL;
+	}
+
+	return trace;
+}
+
+
+/** Function: open_trace_reader
+ ** Opens the trace file at path and reads its header. Returns NULL if the
+ ** file can't be read or isn't a trace of this version.
+ **/
+TRACE * open_trace_reader(const char * path)
+{
+	TRACE * trace = calloc(1, sizeof(TRACE));
+	if(!trace) {
+		fprintf(stderr, "Unable to alloc trace.\n");
+		return NULL;
+	}
+
+	trace->fp = fopen(path, "rb");
+	if(!trace->fp) {
+		fprintf(stderr, "Unable to open trace file %s.\n", path);
+		free(trace);
+		return NULL;
+	}
+
+	if(fread(&trace->header, sizeof(TRACE_HEADER), 1, trace->fp) != 1 ||
+	   trace->header.magic != TRACE_MAGIC || trace->header.version != TRACE_VERSION) {
+		fprintf(stderr, "%s is not a pivot trace.\n", path);
+		close_trace(&trace);
+		return NULL;
+	}
+
+	return trace;
+}
+
+
+/** Function: close_trace
+ ** Closes the trace file and frees the object. Returns a non-zero value if
+ ** the records written could not be flushed.
+ **/
+int close_trace(TRACE ** trace_p)
+{
+	int status = 0;
+
+	if(!trace_p || !*trace_p) {
+		return 0;
+	}
+
+	if((*trace_p)->fp && fclose((*trace_p)->fp)) {
+		fprintf(stderr, "Unable to close trace file.\n");
+		status = -1;
+	}
+
+	free(*trace_p);
+	*trace_p = NULL;
+
+	return status;
+}
+
+
+/** Function: trace_write
+ ** Appends one record to the trace.
+ **/
+int trace_write(TRACE * trace, const TRACE_RECORD * record)
+{
+	if(!trace || !trace->writing) {
+		return -1;
+	}
+
+	if(fwrite(record, sizeof(TRACE_RECORD), 1, trace->fp) != 1) {
+		fprintf(stderr, "Unable to write trace record %ld.\n", trace->records);
+		return -1;
+	}
+
+	trace->records++;
+
+	return 0;
+}
+
+
+/** Function: trace_read
+ ** Reads the next record of the trace. Returns 1 if a record was read, 0 at
+ ** the end of the trace and -1 on error or on a truncated record.
+ **/
+int trace_read(TRACE * trace, TRACE_RECORD * record)
+{
+	if(!trace || trace->writing) {
+		return -1;
+	}
+
+	if(fread(record, sizeof(TRACE_RECORD), 1, trace->fp) != 1) {
+		if(feof(trace->fp) && !ferror(trace->fp)) {
+			return 0;
+		}
+		fprintf(stderr, "Unable to read trace record %ld.\n", trace->records);
+		return -1;
+	}
+
+	trace->records++;
+
+	return 1;
+}
+
+
+/** Function: trace_diff
+ ** Compares two traces record by record and reports the first one where
+ ** they take a different pivot or reach a different objective pair, then
+ ** the time spent per phase by each trace over their common path. Returns 0
+ ** if both traces follow the same path, 1 if they diverge and -1 on error.
+ **/
+int trace_diff(const char * path_a, const char * path_b, FILE * out)
+{
+	static const char * phases[TRACE_NPHASES] = {"pricing", "pivot", "retrieve", "update"};
+	TRACE * a = NULL;
+	TRACE * b = NULL;
+	TRACE_RECORD ra, rb;
+	double time_a[TRACE_NPHASES] = {0.0};
+	double time_b[TRACE_NPHASES] = {0.0};
+	long common = 0;
+	int diverged = 0;
+	int status = 0;
+	int ka, kb, p;
+
+	a = open_trace_reader(path_a);
+	b = open_trace_reader(path_b);
+	if(!a || !b) {
+		status = -1;
+		goto TERMINATE;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Trace Comparison:\n\n");
+
+	if(a->header.narcs != b->header.narcs || a->header.nnodes != b->header.nnodes ||
+	   a->header.direction != b->header.direction) {
+		fprintf(out, "The traces walk different problems.\n\n");
+		status = 1;
+		goto TERMINATE;
+	}
+
+	for(;;) {
+		ka = trace_read(a, &ra);
+		kb = trace_read(b, &rb);
+		if(ka < 0 || kb < 0) {
+			status = -1;
+			goto TERMINATE;
+		}
+
+		if(!ka || !kb) {
+			if(ka != kb) {
+				fprintf(out, "Trace %s ends at record %ld.\n", ka ? path_b : path_a, common);
+				diverged = 1;
+			}
+			break;
+		}
+
+		if(ra.entering != rb.entering || ra.leaving != rb.leaving ||
+		   !same_value(ra.obj1, rb.obj1) || !same_value(ra.obj2, rb.obj2)) {
+			fprintf(out, "First divergence at record %ld (iteration %d):\n", common, ra.iteration);
+			fprintf(out, "  %s\tentering: %d\tleaving: %d\tz1: %lf\tz2: %lf\n",
+			        path_a, ra.entering, ra.leaving, ra.obj1, ra.obj2);
+			fprintf(out, "  %s\tentering: %d\tleaving: %d\tz1: %lf\tz2: %lf\n",
+			        path_b, rb.entering, rb.leaving, rb.obj1, rb.obj2);
+			diverged = 1;
+			break;
+		}
+
+		add_times(time_a, &ra);
+		add_times(time_b, &rb);
+		common++;
+	}
+
+	if(!diverged) {
+		fprintf(out, "Both traces follow the same path of %ld pivots.\n", common);
+	}
+
+	fprintf(out, "\n%-10s %14s %14s %10s\n", "phase", "first (s)", "second (s)", "ratio");
+	for(p = 0; p < TRACE_NPHASES; p++) {
+		fprintf(out, "%-10s %14.6lf %14.6lf %10.3lf\n", phases[p], time_a[p], time_b[p],
+		        time_a[p] > 0.0 ? time_b[p] / time_a[p] : 0.0);
+	}
+	fprintf(out, "(over the first %ld common pivots)\n\n", common);
+
+	status = diverged;
+
+
+TERMINATE:
+
+	close_trace(&a);
+	close_trace(&b);
+
+	return status;
+}
+
+
+/** Function: trace_clock
+ ** Returns the time of a monotonic clock in seconds.
+ **/
+double trace_clock(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/** Function: same_value
+ ** Returns 1 if both values are equal within TRACE_TOL.
+ **/
+static int same_value(double a, double b)
+{
+	return fabs(a - b) <= TRACE_TOL * (1.0 + fabs(a));
+}
+
+
+/** Function: add_times
+ ** Adds the phase times of the record, in seconds, to the totals.
+ **/
+static void add_times(double * totals, const TRACE_RECORD * record)
+{
+	int p;
+
+	for(p = 0; p < TRACE_NPHASES; p++) {
+		totals[p] += record->usec[p] * 1e-6;
+	}
+}
@@ -0,0 +1,735 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+#include "frontier.h"
+#include "perturbation.h"
+#include "verify.h"
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static void * run_checker(void *);
+static void stop_checkers(VERIFIER *);
+static VERIFY_SLOT * find_slot(const VERIFIER *, int);
+static void fill_slot(const VERIFIER *, VERIFY_SLOT *, const SOLVER_ITERATION *);
+static void check_point(const VERIFIER *, const VERIFY_SLOT *, VERIFY_POINT *, double *);
+static void keep_result(VERIFY_POINT *, const VERIFY_POINT *);
+static void fail(VERIFY_POINT *, int, double);
+static int claim_intervals(VERIFIER *);
+static void check_claims(VERIFIER *);
+static int same_point(const VERIFY_POINT *, const VERIFY_POINT *);
+static void check_order(VERIFIER *);
+static int compare_walk(const void *, const void *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: create_verifier
+ ** Creates a verifier for the walk of the loaded context, with up to
+ ** nthreads checkers (at most VERIFY_MAX_THREADS) started at once. Every
+ ** iteration reported to verify_record() is handed on to next with
+ ** next_data. Returns NULL if the network can't be read back from the LP
+ ** objects or the slots can't be allocated.
+ **/
+VERIFIER * create_verifier(const SOLVER_CTX * ctx, int nthreads, SOLVER_CALLBACK next, void * next_data)
+{
+	VERIFIER * verifier;
+	int i;
+
+	if(!ctx || !ctx->lp1 || !ctx->lp2) {
+		return NULL;
+	}
+
+	verifier = calloc(1, sizeof(VERIFIER));
+	if(!verifier) {
+		fprintf(stderr, "Unable to alloc verifier.\n");
+		return NULL;
+	}
+
+	pthread_mutex_init(&verifier->lock, NULL);
+	pthread_cond_init(&verifier->filled, NULL);
+	pthread_cond_init(&verifier->freed, NULL);
+
+	if(get_lp_network(ctx->env1, ctx->lp1, &verifier->topo, &verifier->costs1)) {
+		fprintf(stderr, "Unable to read the network to verify.\n");
+		free_verifier(&verifier);
+		return NULL;
+	}
+
+	verifier->costs2 = malloc(ctx->narcs * sizeof(double));
+	if(!verifier->costs2 || CPXgetobj(ctx->env2, ctx->lp2, verifier->costs2, 0, ctx->narcs - 1)) {
+		fprintf(stderr, "Unable to get costs of objective 2 to verify.\n");
+		free_verifier(&verifier);
+		return NULL;
+	}
+
+	if(ctx->reduction) {
+		verifier->offset1 = ctx->reduction->offset1;
+		verifier->offset2 = ctx->reduction->offset2;
+	}
+
+	/* the walk starts at the perturbation weight and ends at its anchor */
+	verifier->direction = ctx->direction;
+	if(ctx->direction == SOLVER_BACKWARD) {
+		verifier->wmin = 1.0 - PERTURBATION_WEIGHT;
+		verifier->wmax = 1.0;
+	} else {
+		verifier->wmin = 0.0;
+		verifier->wmax = PERTURBATION_WEIGHT;
+	}
+
+	verifier->anytime = ctx->deadline > 0.0 || ctx->iteration_budget > 0;
+	verifier->exact = !(ctx->approx_eps > 0.0 || ctx->approx_points > 0 || verifier->anytime);
+	verifier->next = next;
+	verifier->next_data = next_data;
+
+	if(nthreads < 1) {
+		nthreads = 1;
+	}
+	if(nthreads > VERIFY_MAX_THREADS) {
+		nthreads = VERIFY_MAX_THREADS;
+	}
+
+	/* two slots per checker, so the walk rarely waits for one */
+	verifier->ncheckers = nthreads;
+	verifier->nslots = 2 * nthreads;
+	verifier->checkers = calloc(verifier->ncheckers, sizeof(VERIFY_CHECKER));
+	verifier->slots = calloc(verifier->nslots, sizeof(VERIFY_SLOT));
+	if(!verifier->checkers || !verifier->slots) {
+		fprintf(stderr, "Unable to alloc verification slots.\n");
+		free_verifier(&verifier);
+		return NULL;
+	}
+
+	for(i = 0; i < verifier->nslots; i++) {
+		VERIFY_SLOT * slot = &verifier->slots[i];
+
+		slot->x = malloc(ctx->narcs * sizeof(double));
+		slot->pi1 = malloc(ctx->nnodes * sizeof(double));
+		slot->pi2 = malloc(ctx->nnodes * sizeof(double));
+		slot->status = malloc(ctx->narcs);
+		if(!slot->x || !slot->pi1 || !slot->pi2 || !slot->status) {
+			fprintf(stderr, "Unable to alloc verification slot %d.\n", i);
+			free_verifier(&verifier);
+			return NULL;
+		}
+	}
+
+	for(i = 0; i < verifier->ncheckers; i++) {
+		verifier->checkers[i].verifier = verifier;
+		verifier->checkers[i].residual = malloc(ctx->nnodes * sizeof(double));
+		if(!verifier->checkers[i].residual) {
+			fprintf(stderr, "Unable to alloc verification thread %d.\n", i);
+			free_verifier(&verifier);
+			return NULL;
+		}
+	}
+
+	for(i = 0; i < verifier->ncheckers; i++) {
+		if(pthread_create(&verifier->checkers[i].thread, NULL, run_checker, &verifier->checkers[i])) {
+			fprintf(stderr, "Unable to start verification thread %d.\n", i);
+			break;
+		}
+		verifier->checkers[i].started = 1;
+		verifier->nstarted++;
+	}
+
+	return verifier;
+}
+
+
+/** Function: free_verifier
+ ** Stops the checkers, if verify_frontier() did not, and frees the verifier
+ ** and every point it holds.
+ **/
+void free_verifier(VERIFIER ** verifier_p)
+{
+	VERIFIER * verifier;
+	int i;
+
+	if(!verifier_p || !*verifier_p) {
+		return;
+	}
+
+	verifier = *verifier_p;
+
+	stop_checkers(verifier);
+
+	if(verifier->checkers) {
+		for(i = 0; i < verifier->ncheckers; i++) {
+			free(verifier->checkers[i].residual);
+		}
+		free(verifier->checkers);
+	}
+
+	if(verifier->slots) {
+		for(i = 0; i < verifier->nslots; i++) {
+			free(verifier->slots[i].x);
+			free(verifier->slots[i].pi1);
+			free(verifier->slots[i].pi2);
+			free(verifier->slots[i].status);
+		}
+		free(verifier->slots);
+	}
+
+	free(verifier->points);
+
+	free_topology(&verifier->topo);
+	free(verifier->costs1);
+	free(verifier->costs2);
+
+	pthread_mutex_destroy(&verifier->lock);
+	pthread_cond_destroy(&verifier->filled);
+	pthread_cond_destroy(&verifier->freed);
+
+	free(verifier);
+	*verifier_p = NULL;
+}
+
+
+/** Function: verify_record
+ ** Iteration callback that adds the reported point, copies its certificate
+ ** to a free slot for the checkers and hands the iteration on to the next
+ ** callback. Without checkers the point is checked here and then. A point
+ ** that can't be kept is counted as dropped rather than stopping the walk.
+ **/
+int verify_record(const SOLVER_ITERATION * it, void * data)
+{
+	VERIFIER * verifier = data;
+	VERIFY_POINT * point;
+	VERIFY_SLOT * slot;
+	int index;
+
+	pthread_mutex_lock(&verifier->lock);
+
+	/* the checkers only touch the points under the lock */
+	if(verifier->npoints == verifier->capacity) {
+		int capacity = verifier->capacity ? 2 * verifier->capacity : 64;
+		VERIFY_POINT * points = realloc(verifier->points, capacity * sizeof(VERIFY_POINT));
+		if(!points) {
+			verifier->dropped++;
+			pthread_mutex_unlock(&verifier->lock);
+			goto NEXT;
+		}
+		verifier->points = points;
+		verifier->capacity = capacity;
+	}
+
+	index = verifier->npoints++;
+	point = &verifier->points[index];
+	memset(point, 0, sizeof(VERIFY_POINT));
+	point->iteration = it->iteration;
+	point->obj1 = it->solution1->objval;
+	point->obj2 = it->solution2->objval;
+
+	if(!verifier->nstarted) {
+		VERIFY_POINT result = *point;
+
+		pthread_mutex_unlock(&verifier->lock);
+
+		slot = &verifier->slots[0];
+		fill_slot(verifier, slot, it);
+		check_point(verifier, slot, &result, verifier->checkers[0].residual);
+		keep_result(&verifier->points[index], &result);
+		goto NEXT;
+	}
+
+	while(!(slot = find_slot(verifier, VERIFY_SLOT_FREE))) {
+		pthread_cond_wait(&verifier->freed, &verifier->lock);
+	}
+	slot->state = VERIFY_SLOT_FILLING;
+	slot->point = index;
+
+	pthread_mutex_unlock(&verifier->lock);
+
+	fill_slot(verifier, slot, it);
+
+	pthread_mutex_lock(&verifier->lock);
+	slot->state = VERIFY_SLOT_READY;
+	pthread_cond_signal(&verifier->filled);
+	pthread_mutex_unlock(&verifier->lock);
+
+NEXT:
+
+	return verifier->next ? verifier->next(it, verifier->next_data) : 0;
+}
+
+
+/** Function: verify_frontier
+ ** Waits for the checkers to finish the points of the walk, then checks the
+ ** order of the points along the walk and the weight intervals the frontier
+ ** claims. A line is written to report for every point that fails a check,
+ ** followed by a summary. Returns the number of failed points or -1 if the
+ ** verification could not run.
+ **/
+int verify_frontier(VERIFIER * verifier, FILE * report)
+{
+	int nfailed = 0;
+	int i;
+
+	if(!verifier || !report) {
+		return -1;
+	}
+
+	stop_checkers(verifier);
+
+	/* decreasing objective 2, which is the order of the forward walk */
+	if(verifier->anytime && verifier->npoints > 1) {
+		qsort(verifier->points, verifier->npoints, sizeof(VERIFY_POINT), compare_walk);
+		if(verifier->direction == SOLVER_BACKWARD) {
+			for(i = 0; i < verifier->npoints / 2; i++) {
+				VERIFY_POINT tmp = verifier->points[i];
+				verifier->points[i] = verifier->points[verifier->npoints - 1 - i];
+				verifier->points[verifier->npoints - 1 - i] = tmp;
+			}
+		}
+	}
+
+	if(claim_intervals(verifier)) {
+		return -1;
+	}
+
+	check_claims(verifier);
+	check_order(verifier);
+
+	fprintf(report, "********************************************************************\n");
+	fprintf(report, "Frontier Verification:\n\n");
+
+	for(i = 0; i < verifier->npoints; i++) {
+		const VERIFY_POINT * p = &verifier->points[i];
+
+		if(!p->failures) {
+			continue;
+		}
+
+		nfailed++;
+		fprintf(report, "Point %d (iteration %d)\tz1: %lf\tz2: %lf\tfailed:%s%s%s%s%s%s\tviolation: %e\n",
+		        i, p->iteration, p->obj1, p->obj2,
+		        p->failures & VERIFY_FLOW ? " flow" : "",
+		        p->failures & VERIFY_BOUNDS ? " bounds" : "",
+		        p->failures & VERIFY_OBJECTIVE ? " objective" : "",
+		        p->failures & VERIFY_DUALS ? " duals" : "",
+		        p->failures & VERIFY_WEIGHTS ? " weights" : "",
+		        p->failures & VERIFY_ORDER ? " order" : "",
+		        p->violation);
+	}
+
+	fprintf(report, "Verified %d points: %d failed", verifier->npoints, nfailed);
+	if(verifier->dropped) {
+		fprintf(report, ", %d not kept", verifier->dropped);
+	}
+	fprintf(report, "\n\n");
+
+	return nfailed;
+}
+
+
+/** Function: run_checker
+ ** Thread routine: checks the ready slots until the verifier closes and none
+ ** is left. The point of a slot is copied under the lock and its result is
+ ** stored under the lock, as the walk may move the points meanwhile.
+ **/
+static void * run_checker(void * arg)
+{
+	VERIFY_CHECKER * checker = arg;
+	VERIFIER * verifier = checker->verifier;
+	VERIFY_SLOT * slot;
+
+	pthread_mutex_lock(&verifier->lock);
+
+	for(;;) {
+		VERIFY_POINT result;
+
+		slot = find_slot(verifier, VERIFY_SLOT_READY);
+		if(!slot) {
+			if(verifier->closing) {
+				break;
+			}
+			pthread_cond_wait(&verifier->filled, &verifier->lock);
+			continue;
+		}
+
+		slot->state = VERIFY_SLOT_CHECKING;
+		result = verifier->points[slot->point];
+		pthread_mutex_unlock(&verifier->lock);
+
+		check_point(verifier, slot, &result, checker->residual);
+
+		pthread_mutex_lock(&verifier->lock);
+		keep_result(&verifier->points[slot->point], &result);
+		slot->state = VERIFY_SLOT_FREE;
+		pthread_cond_signal(&verifier->freed);
+	}
+
+	pthread_mutex_unlock(&verifier->lock);
+
+	return NULL;
+}
+
+
+/** Function: stop_checkers
+ ** Lets the checkers finish the ready slots and joins them. Does nothing the
+ ** second time.
+ **/
+static void stop_checkers(VERIFIER * verifier)
+{
+	int i;
+
+	if(!verifier->checkers) {
+		return;
+	}
+
+	pthread_mutex_lock(&verifier->lock);
+	verifier->closing = 1;
+	pthread_cond_broadcast(&verifier->filled);
+	pthread_mutex_unlock(&verifier->lock);
+
+	for(i = 0; i < verifier->ncheckers; i++) {
+		if(verifier->checkers[i].started) {
+			pthread_join(verifier->checkers[i].thread, NULL);
+			verifier->checkers[i].started = 0;
+		}
+	}
+}
+
+
+/** Function: find_slot
+ ** Returns a slot in the given state, or NULL if there is none. Must be
+ ** called under the lock.
+ **/
+static VERIFY_SLOT * find_slot(const VERIFIER * verifier, int state)
+{
+	int i;
+
+	for(i = 0; i < verifier->nslots; i++) {
+		if(verifier->slots[i].state == state) {
+			return &verifier->slots[i];
+		}
+	}
+
+	return NULL;
+}
+
+
+/** Function: fill_slot
+ ** Copies the certificate of the reported point to the slot.
+ **/
+static void fill_slot(const VERIFIER * verifier, VERIFY_SLOT * slot, const SOLVER_ITERATION * it)
+{
+	int narcs = verifier->topo->narcs;
+	int nnodes = verifier->topo->nnodes;
+	int i;
+
+	memcpy(slot->x, it->solution1->x, narcs * sizeof(double));
+	memcpy(slot->pi1, it->solution1->pi, nnodes * sizeof(double));
+	memcpy(slot->pi2, it->solution2->pi, nnodes * sizeof(double));
+	for(i = 0; i < narcs; i++) {
+		slot->status[i] = (char) it->solution1->basis->arc_basis[i];
+	}
+}
+
+
+/** Function: check_point
+ ** Checks the certificate of one point. The flow must satisfy conservation
+ ** and bounds, with every nonbasic arc at its bound, and give back the
+ ** objective values reported. The reduced costs dj = c - pi[tail] + pi[head]
+ ** of both objectives must vanish on basic arcs. The weighted reduced cost
+ ** w*dj1 + (1 - w)*dj2 of a nonbasic arc is linear in w, so the weights for
+ ** which it has the sign its bound needs form an interval; their intersection
+ ** [lo, hi] is where the basis is optimal and must not be empty.
+ **/
+static void check_point(const VERIFIER * verifier, const VERIFY_SLOT * slot, VERIFY_POINT * p,
+                        double * residual)
+{
+	const NET_TOPOLOGY * topo = verifier->topo;
+	double z1 = verifier->offset1;
+	double z2 = verifier->offset2;
+	double lo = verifier->wmin;
+	double hi = verifier->wmax;
+	int a, i;
+
+	memcpy(residual, topo->supply, topo->nnodes * sizeof(double));
+
+	for(a = 0; a < topo->narcs; a++) {
+		double x = slot->x[a];
+		double dj1 = verifier->costs1[a] - slot->pi1[topo->tail[a]] + slot->pi1[topo->head[a]];
+		double dj2 = verifier->costs2[a] - slot->pi2[topo->tail[a]] + slot->pi2[topo->head[a]];
+		double tol = VERIFY_TOL * (1.0 + fabs(verifier->costs1[a]) + fabs(verifier->costs2[a]));
+		double xtol = VERIFY_TOL * (1.0 + fabs(x));
+		double slope, base, w;
+
+		residual[topo->tail[a]] -= x;
+		residual[topo->head[a]] += x;
+		z1 += verifier->costs1[a] * x;
+		z2 += verifier->costs2[a] * x;
+
+		if(x < topo->lb[a] - xtol) {
+			fail(p, VERIFY_BOUNDS, topo->lb[a] - x);
+		}
+		if(x > topo->ub[a] + xtol) {
+			fail(p, VERIFY_BOUNDS, x - topo->ub[a]);
+		}
+
+		switch(slot->status[a]) {
+		case CPX_BASIC:
+			if(fabs(dj1) > tol || fabs(dj2) > tol) {
+				fail(p, VERIFY_DUALS, fabs(dj1) > fabs(dj2) ? fabs(dj1) : fabs(dj2));
+			}
+			continue;
+		case CPX_AT_LOWER:
+			if(fabs(x - topo->lb[a]) > xtol) {
+				fail(p, VERIFY_BOUNDS, fabs(x - topo->lb[a]));
+			}
+			base = dj2;
+			slope = dj1 - dj2;
+			break;
+		case CPX_AT_UPPER:
+			if(fabs(x - topo->ub[a]) > xtol) {
+				fail(p, VERIFY_BOUNDS, fabs(x - topo->ub[a]));
+			}
+			base = -dj2;
+			slope = dj2 - dj1;
+			break;
+		default:
+			continue;
+		}
+
+		/* base + w*slope >= -tol */
+		if(slope > 0.0) {
+			w = (-tol - base) / slope;
+			if(w > lo) lo = w;
+		} else if(slope < 0.0) {
+			w = (-tol - base) / slope;
+			if(w < hi) hi = w;
+		} else if(base < -tol) {
+			lo = 1.0;
+			hi = 0.0;
+		}
+	}
+
+	for(i = 0; i < topo->nnodes; i++) {
+		if(fabs(residual[i]) > VERIFY_TOL * (1.0 + fabs(topo->supply[i]))) {
+			fail(p, VERIFY_FLOW, fabs(residual[i]));
+		}
+	}
+
+	if(fabs(z1 - p->obj1) > VERIFY_TOL * (1.0 + fabs(p->obj1))) {
+		fail(p, VERIFY_OBJECTIVE, fabs(z1 - p->obj1));
+	}
+	if(fabs(z2 - p->obj2) > VERIFY_TOL * (1.0 + fabs(p->obj2))) {
+		fail(p, VERIFY_OBJECTIVE, fabs(z2 - p->obj2));
+	}
+
+	p->lo = lo;
+	p->hi = hi;
+
+	if(lo > hi + VERIFY_TOL) {
+		fail(p, VERIFY_WEIGHTS, lo - hi);
+	}
+}
+
+
+/** Function: keep_result
+ ** Copies the outcome of the checks of a point to the point kept.
+ **/
+static void keep_result(VERIFY_POINT * p, const VERIFY_POINT * result)
+{
+	p->lo = result->lo;
+	p->hi = result->hi;
+	p->failures = result->failures;
+	p->violation = result->violation;
+}
+
+
+/** Function: fail
+ ** Flags the failed check on the point and keeps its largest violation.
+ **/
+static void fail(VERIFY_POINT * p, int check, double violation)
+{
+	p->failures |= check;
+	if(violation > p->violation) {
+		p->violation = violation;
+	}
+}
+
+
+/** Function: claim_intervals
+ ** Sets the weight interval the frontier claims for every kept point, as
+ ** computed by frontier_finalize() and clipped to the weights the walk
+ ** covers. At the anchor end of the walk only the breakpoint is claimed:
+ ** the walk stops as soon as the anchor value is reached, so the last basis
+ ** need not be optimal at the end weight itself. Points merged into an equal
+ ** one and, unless the walk is exact, every point claim no interval.
+ **/
+static int claim_intervals(VERIFIER * verifier)
+{
+	FRONTIER * frontier;
+	int i;
+
+	for(i = 0; i < verifier->npoints; i++) {
+		verifier->points[i].claim_lo = 1.0;
+		verifier->points[i].claim_hi = 0.0;
+	}
+
+	if(!verifier->exact) {
+		return 0;
+	}
+
+	frontier = create_frontier();
+	if(!frontier) {
+		return -1;
+	}
+
+	/* the index of the point is carried as its iteration */
+	for(i = 0; i < verifier->npoints; i++) {
+		if(frontier_add(frontier, verifier->points[i].obj1, verifier->points[i].obj2, i, -1)) {
+			free_frontier(&frontier);
+			return -1;
+		}
+	}
+
+	frontier_finalize(frontier);
+
+	for(i = 0; i < frontier->npoints; i++) {
+		const FRONTIER_POINT * fp = &frontier->points[i];
+		VERIFY_POINT * p = &verifier->points[fp->iteration];
+
+		p->claim_lo = fp->lambda_lo > verifier->wmin ? fp->lambda_lo : verifier->wmin;
+		p->claim_hi = fp->lambda_hi < verifier->wmax ? fp->lambda_hi : verifier->wmax;
+
+		if(verifier->direction == SOLVER_FORWARD && i == frontier->npoints - 1) {
+			p->claim_lo = p->claim_hi;
+		} else if(verifier->direction == SOLVER_BACKWARD && i == 0) {
+			p->claim_hi = p->claim_lo;
+		}
+	}
+
+	free_frontier(&frontier);
+
+	return 0;
+}
+
+
+/** Function: check_claims
+ ** A point reached by degenerate pivots is kept once per basis, each basis
+ ** being optimal over part of the weights of the point. The claimed interval
+ ** must be covered by the union of the intervals [lo, hi] of the run of equal
+ ** points around the one holding the claim. Points failing the check are
+ ** flagged.
+ **/
+static void check_claims(VERIFIER * verifier)
+{
+	int k;
+
+	for(k = 0; k < verifier->npoints; k++) {
+		VERIFY_POINT * p = &verifier->points[k];
+		int first = k, last = k;
+		double covered;
+		int grown, i;
+
+		if(p->claim_lo > p->claim_hi) {
+			continue;
+		}
+
+		while(first > 0 && same_point(&verifier->points[first - 1], p)) first--;
+		while(last < verifier->npoints - 1 && same_point(&verifier->points[last + 1], p)) last++;
+
+		/* sweep the claim from its low end */
+		covered = p->claim_lo - VERIFY_TOL;
+		do {
+			grown = 0;
+			for(i = first; i <= last; i++) {
+				const VERIFY_POINT * q = &verifier->points[i];
+				if(q->lo <= covered + VERIFY_TOL && q->hi > covered && q->lo <= q->hi + VERIFY_TOL) {
+					covered = q->hi;
+					grown = 1;
+				}
+			}
+		} while(grown && covered < p->claim_hi - VERIFY_TOL);
+
+		if(covered < p->claim_hi - VERIFY_TOL) {
+			fail(p, VERIFY_WEIGHTS, p->claim_hi - covered);
+		}
+	}
+}
+
+
+/** Function: same_point
+ ** Returns 1 if both points have the same objective values, as compared by
+ ** frontier_finalize().
+ **/
+static int same_point(const VERIFY_POINT * a, const VERIFY_POINT * b)
+{
+	return fabs(a->obj1 - b->obj1) <= FRONTIER_TOL && fabs(a->obj2 - b->obj2) <= FRONTIER_TOL;
+}
+
+
+/** Function: check_order
+ ** Walking forward objective 2 never increases and objective 1 never
+ ** decreases from one point to the next; walking backward it is the other
+ ** way around. Points breaking that order are flagged.
+ **/
+static void check_order(VERIFIER * verifier)
+{
+	int i;
+
+	for(i = 1; i < verifier->npoints; i++) {
+		const VERIFY_POINT * prev = &verifier->points[i - 1];
+		VERIFY_POINT * p = &verifier->points[i];
+		double d1 = p->obj1 - prev->obj1;
+		double d2 = p->obj2 - prev->obj2;
+		double tol1 = VERIFY_TOL * (1.0 + fabs(prev->obj1));
+		double tol2 = VERIFY_TOL * (1.0 + fabs(prev->obj2));
+
+		if(verifier->direction == SOLVER_BACKWARD) {
+			d1 = -d1;
+			d2 = -d2;
+		}
+
+		if(d1 < -tol1) {
+			fail(p, VERIFY_ORDER, -d1);
+		}
+		if(d2 > tol2) {
+			fail(p, VERIFY_ORDER, d2);
+		}
+	}
+}
+
+
+/** Function: compare_walk
+ ** qsort comparison: decreasing objective 2 value, ties broken by increasing
+ ** objective 1 value.
+ **/
+static int compare_walk(const void * a, const void * b)
+{
+	const VERIFY_POINT * pa = a;
+	const VERIFY_POINT * pb = b;
+
+	if(pa->obj2 > pb->obj2) return -1;
+	if(pa->obj2 < pb->obj2) return 1;
+	if(pa->obj1 < pb->obj1) return -1;
+	if(pa->obj1 > pb->obj1) return 1;
+
+	return 0;
+}
@@ -0,0 +1,991 @@
+/***********************
+ *** CPLEX Interface ***
+ ***********************/
+#include <ilcplex/cplex.h>
+
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "perturbation.h"
+#include "weightspace.h"
+
+
+
+
+/************************
+ *** Type Definitions ***
+ ************************/
+
+/** The WS_JOB struct is one weighted-sum solve of a round: the weights of an
+ ** open vertex, the envelope value there, the basis it is warm started from
+ ** and, once solved, the objective vector and the solution found.
+ **/
+typedef struct ws_job_struct {
+	double weights[WS_MAX_OBJECTIVES];
+	double bound;
+	long vertex;
+	const NET_BASIS * start;
+	NET_SOLUTION * solution;
+	double values[WS_MAX_OBJECTIVES];
+	int iterations;
+	int status;
+} WS_JOB;
+
+/** The WS_ROUND struct is shared by the workers of a round. Workers take the
+ ** jobs in order under the lock.
+ **/
+typedef struct ws_round_struct {
+	pthread_mutex_t lock;
+	WEIGHT_SPACE * ws;
+	WS_JOB * jobs;
+	int njobs;
+	int next;
+} WS_ROUND;
+
+/** The WS_WORKER struct holds the private CPLEX objects of one thread. They
+ ** are kept across rounds, only the objective function changes.
+ **/
+typedef struct ws_worker_struct {
+	WS_ROUND * round;
+	CPXENVptr env;
+	CPXLPptr lp;
+	pthread_t thread;
+	int started;
+} WS_WORKER;
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static int open_worker(WS_WORKER *, const WEIGHT_SPACE *);
+static void close_worker(WS_WORKER *);
+static int run_round(WS_ROUND *, WS_WORKER *, int);
+static void * run_worker(void *);
+static int merge_job(WEIGHT_SPACE *, WS_JOB *);
+static int first_envelope(WEIGHT_SPACE *);
+static int add_cut(WEIGHT_SPACE *, int);
+static void constraint(const WEIGHT_SPACE *, int, double *, double *);
+static int common_tight(const WS_VERTEX *, const int *, int, int *);
+static int contains(const int *, int, const int *, int);
+static int push_vertex(WEIGHT_SPACE *, const double *, const int *, int);
+static int push_point(WEIGHT_SPACE *, const WS_JOB *);
+static void vertex_weights(const WEIGHT_SPACE *, const WS_VERTEX *, double *);
+static int compare_points(const void *, const void *);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: create_weight_space
+ ** Reads the nfiles network files, which must only differ by their arc
+ ** costs, into a new WEIGHT_SPACE object. The weighted sums are solved on
+ ** nthreads threads with the given engine when no warm start is available.
+ ** The racers of the portfolio settings, which may be NULL, are shared among
+ ** those threads. Returns NULL if any error is detected.
+ **/
+WEIGHT_SPACE * create_weight_space(int nfiles, char ** files, int nthreads, int engine,
+                                   const PORTFOLIO_SETTINGS * portfolio)
+{
+	int status = 0;
+	CPXENVptr env = NULL;
+	NET_TOPOLOGY * topo = NULL;
+	WEIGHT_SPACE * ws = NULL;
+	int k;
+
+	if(nfiles < 2 || nfiles > WS_MAX_OBJECTIVES) {
+		fprintf(stderr, "Weight-space decomposition needs 2 to %d networks.\n", WS_MAX_OBJECTIVES);
+		return NULL;
+	}
+
+	ws = calloc(1, sizeof(WEIGHT_SPACE));
+	if(!ws) {
+		fprintf(stderr, "Unable to alloc weight space.\n");
+		return NULL;
+	}
+
+	ws->nobjs = nfiles;
+	ws->engine = engine;
+	ws->nthreads = nthreads < 1 ? 1 : nthreads;
+	if(portfolio) {
+		ws->portfolio.database = portfolio->database;
+		ws->portfolio.threads = portfolio->threads / ws->nthreads;
+	}
+	if(ws->portfolio.threads < 1) {
+		ws->portfolio.threads = 1;
+	}
+
+	env = CPXopenCPLEX(&status);
+	if(!env) {
+		char errmsg[CPXMESSAGEBUFSIZE];
+		CPXgeterrorstring(env, status, errmsg);
+		fprintf(stderr, "Unable to start CPLEX environment, %d, %s\n", status, errmsg);
+		status = -1;
+		goto TERMINATE;
+	}
+
+	for(k = 0; k < nfiles; k++) {
+		status = read_network(env, files[k], k ? &topo : &ws->topo, &ws->costs[k]);
+		if(status) {
+			goto TERMINATE;
+		}
+
+		if(k && !same_topology(ws->topo, topo)) {
+			fprintf(stderr, "Network %s differs from %s in more than its costs.\n", files[k], files[0]);
+			status = -1;
+			goto TERMINATE;
+		}
+		free_topology(&topo);
+	}
+
+	ws->narcs = ws->topo->narcs;
+	ws->nnodes = ws->topo->nnodes;
+
+
+TERMINATE:
+
+	free_topology(&topo);
+	CPXcloseCPLEX(&env);
+
+	if(status) {
+		free_weight_space(&ws);
+	}
+
+	return ws;
+}
+
+
+/** Function: free_weight_space
+ ** Frees the WEIGHT_SPACE object, its points and vertices, and sets the
+ ** pointer to NULL.
+ **/
+void free_weight_space(WEIGHT_SPACE ** ws_p)
+{
+	WEIGHT_SPACE * ws;
+	int i;
+
+	if(!ws_p || !*ws_p) {
+		return;
+	}
+
+	ws = *ws_p;
+
+	for(i = 0; i < ws->npoints; i++) {
+		free_basis(&ws->points[i].basis);
+	}
+	for(i = 0; i < ws->nvertices; i++) {
+		free(ws->vertices[i].tight);
+	}
+	for(i = 0; i < ws->nobjs; i++) {
+		free(ws->costs[i]);
+	}
+
+	free(ws->points);
+	free(ws->vertices);
+	free_topology(&ws->topo);
+	free(ws);
+
+	*ws_p = NULL;
+}
+
+
+/** Function: weight_space_solve
+ ** Finds every extreme supported point of the K objective functions by
+ ** decomposition of the weight simplex. Each point owns the cell of weights
+ ** for which it minimizes the weighted sum; the cells are bounded by the
+ ** lower envelope of the weighted sums of the points found so far, and only
+ ** the vertices of that envelope can hide a missing point. Every round
+ ** solves the weighted sums of all open vertices in parallel, each warm
+ ** started from the basis of a point whose cell the vertex belongs to: only
+ ** the costs change, so the basis stays primal feasible and few pivots are
+ ** needed. A solve that beats the envelope adds its point and cuts the
+ ** envelope, creating new open vertices; otherwise the vertex is confirmed.
+ ** The search ends when every vertex is confirmed.
+ **/
+int weight_space_solve(WEIGHT_SPACE * ws)
+{
+	int status = 0;
+	WS_WORKER * workers = NULL;
+	WS_JOB * jobs = NULL;
+	WS_ROUND round;
+	int nworkers = 0, njobs, capacity = 0;
+	double start, end;
+	int i, j, k;
+
+	memset(&round, 0, sizeof(WS_ROUND));
+	pthread_mutex_init(&round.lock, NULL);
+	round.ws = ws;
+
+	if(!ws || ws->npoints) {
+		status = -1;
+		goto TERMINATE;
+	}
+
+	workers = calloc(ws->nthreads, sizeof(WS_WORKER));
+	if(!workers) {
+		fprintf(stderr, "Unable to alloc workers.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	for(nworkers = 0; nworkers < ws->nthreads; nworkers++) {
+		workers[nworkers].round = &round;
+		status = open_worker(&workers[nworkers], ws);
+		if(status) {
+			fprintf(stderr, "Unable to set up worker %d.\n", nworkers);
+			nworkers++;
+			goto TERMINATE;
+		}
+	}
+
+	CPXgettime(workers[0].env, &start);
+
+	/* The first point comes from a cold solve at the centre of the simplex */
+	capacity = ws->nobjs;
+	jobs = calloc(capacity, sizeof(WS_JOB));
+	if(!jobs) {
+		fprintf(stderr, "Unable to alloc jobs.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	for(k = 0; k < ws->nobjs; k++) {
+		jobs[0].weights[k] = 1.0 / ws->nobjs;
+	}
+	jobs[0].vertex = -1;
+
+	round.jobs = jobs;
+	round.njobs = 1;
+	round.next = 0;
+	status = run_round(&round, workers, nworkers);
+	if(!status) status = jobs[0].status;
+	if(!status) {
+		ws->solves++;
+		ws->iterations += jobs[0].iterations;
+		status = push_point(ws, &jobs[0]);
+	}
+	if(!status) status = first_envelope(ws);
+	free_solution(&jobs[0].solution);
+	if(status) {
+		goto TERMINATE;
+	}
+
+	for(;;) {
+		njobs = 0;
+		for(i = 0; i < ws->nvertices; i++) {
+			njobs += !ws->vertices[i].confirmed;
+		}
+		if(!njobs) {
+			break;
+		}
+
+		if(njobs > capacity) {
+			WS_JOB * tmp = realloc(jobs, njobs * sizeof(WS_JOB));
+			if(!tmp) {
+				fprintf(stderr, "Unable to alloc jobs.\n");
+				status = -1;
+				goto TERMINATE;
+			}
+			jobs = tmp;
+			capacity = njobs;
+		}
+		memset(jobs, 0, njobs * sizeof(WS_JOB));
+
+		/* warm start from the last point found among the cells at the vertex */
+		for(i = 0, j = 0; i < ws->nvertices; i++) {
+			const WS_VERTEX * v = &ws->vertices[i];
+			if(v->confirmed) {
+				continue;
+			}
+			vertex_weights(ws, v, jobs[j].weights);
+			jobs[j].bound = v->u[ws->nobjs - 1];
+			jobs[j].vertex = v->id;
+			jobs[j].start = v->tight[v->ntight - 1] >= ws->nobjs ?
+			                ws->points[v->tight[v->ntight - 1] - ws->nobjs].basis : NULL;
+			j++;
+		}
+
+		round.jobs = jobs;
+		round.njobs = njobs;
+		round.next = 0;
+		status = run_round(&round, workers, nworkers);
+
+		for(j = 0; j < njobs; j++) {
+			if(!status) status = merge_job(ws, &jobs[j]);
+			free_solution(&jobs[j].solution);
+		}
+		if(status) {
+			goto TERMINATE;
+		}
+
+		ws->rounds++;
+	}
+
+	CPXgettime(workers[0].env, &end);
+	ws->elapsed = end - start;
+
+	/* A point whose cell has fewer vertices than a full facet only touches
+	 * the envelope on a face of other cells: it is supported, not extreme.
+	 */
+	for(i = 0; i < ws->nvertices; i++) {
+		for(j = 0; j < ws->vertices[i].ntight; j++) {
+			if(ws->vertices[i].tight[j] >= ws->nobjs) {
+				ws->points[ws->vertices[i].tight[j] - ws->nobjs].facets++;
+			}
+		}
+	}
+
+	for(i = 0, j = 0; i < ws->npoints; i++) {
+		if(ws->points[i].facets < ws->nobjs) {
+			free_basis(&ws->points[i].basis);
+			ws->degenerate++;
+		} else {
+			ws->points[j++] = ws->points[i];
+		}
+	}
+	ws->npoints = j;
+
+	/* the vertices refer to the points by index, which the sort breaks */
+	for(i = 0; i < ws->nvertices; i++) {
+		free(ws->vertices[i].tight);
+	}
+	ws->nvertices = 0;
+
+	qsort(ws->points, ws->npoints, sizeof(WS_POINT), compare_points);
+
+
+TERMINATE:
+
+	if(jobs) {
+		for(j = 0; j < capacity; j++) {
+			free_solution(&jobs[j].solution);
+		}
+		free(jobs);
+	}
+
+	if(workers) {
+		for(i = 0; i < nworkers; i++) {
+			close_worker(&workers[i]);
+		}
+		free(workers);
+	}
+
+	pthread_mutex_destroy(&round.lock);
+
+	return status;
+}
+
+
+/** Function: fprint_weight_space
+ ** Prints one line per extreme supported point to the given stream.
+ **/
+void fprint_weight_space(FILE * out, const WEIGHT_SPACE * ws)
+{
+	int i, k;
+
+	if(!ws || !out) {
+		return;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Supported Extreme Points (%d points, %d objectives):\n\n", ws->npoints, ws->nobjs);
+
+	for(i = 0; i < ws->npoints; i++) {
+		const WS_POINT * p = &ws->points[i];
+
+		fprintf(out, "Point %d", i);
+		for(k = 0; k < ws->nobjs; k++) {
+			fprintf(out, "\tz%d: %lf", k + 1, p->values[k]);
+		}
+		fprintf(out, "\tweights: (");
+		for(k = 0; k < ws->nobjs; k++) {
+			fprintf(out, k ? ", %lf" : "%lf", p->weights[k]);
+		}
+		fprintf(out, ")\n");
+	}
+
+	fprintf(out, "\n");
+}
+
+
+/** Function: weight_space_report
+ ** Prints how the decomposition went: rounds, solves, warm starts, simplex
+ ** iterations and time.
+ **/
+void weight_space_report(FILE * out, const WEIGHT_SPACE * ws)
+{
+	if(!ws || !out) {
+		return;
+	}
+
+	fprintf(out, "********************************************************************\n");
+	fprintf(out, "Weight-Space Decomposition (%d objectives, %d threads):\n\n", ws->nobjs, ws->nthreads);
+	fprintf(out, "Extreme points:\t%d\n", ws->npoints);
+	fprintf(out, "Non-extreme:\t%d\n", ws->degenerate);
+	fprintf(out, "Rounds:\t\t%d\n", ws->rounds);
+	fprintf(out, "Solves:\t\t%ld (%ld warm started)\n", ws->solves, ws->warm_solves);
+	fprintf(out, "Iterations:\t%ld\n", ws->iterations);
+	fprintf(out, "Time:\t\t%lf\n\n", ws->elapsed);
+}
+
+
+/** Function: open_worker
+ ** Opens the CPLEX environment and LP object of a worker, limited to one
+ ** thread as the workers already use every core.
+ **/
+static int open_worker(WS_WORKER * worker, const WEIGHT_SPACE * ws)
+{
+	int status = 0;
+
+	worker->env = CPXopenCPLEX(&status);
+	if(!worker->env) {
+		return status ? status : -1;
+	}
+
+	status = CPXsetintparam(worker->env, CPX_PARAM_SCRIND, CPX_OFF);
+	if(!status) status = CPXsetintparam(worker->env, CPX_PARAM_THREADS, 1);
+	if(status) {
+		return status;
+	}
+
+	worker->lp = CPXcreateprob(worker->env, &status, "lp_weighted");
+	if(!worker->lp) {
+		return status ? status : -1;
+	}
+
+	return copy_topology_to_lp(worker->env, worker->lp, ws->topo, ws->costs[0]);
+}
+
+
+/** Function: close_worker
+ ** Frees the CPLEX objects of a worker.
+ **/
+static void close_worker(WS_WORKER * worker)
+{
+	if(worker->lp) {
+		CPXfreeprob(worker->env, &worker->lp);
+	}
+	if(worker->env) {
+		CPXcloseCPLEX(&worker->env);
+	}
+}
+
+
+/** Function: run_round
+ ** Solves every job of the round on the workers and waits for all of them.
+ ** A round with a single job is solved on the calling thread.
+ **/
+static int run_round(WS_ROUND * round, WS_WORKER * workers, int nworkers)
+{
+	int status = 0;
+	int i;
+
+	if(!round->jobs || round->njobs < 1) {
+		return 0;
+	}
+
+	if(nworkers > round->njobs) {
+		nworkers = round->njobs;
+	}
+
+	if(nworkers == 1) {
+		run_worker(&workers[0]);
+		return 0;
+	}
+
+	for(i = 0; i < nworkers; i++) {
+		workers[i].started = 0;
+		if(pthread_create(&workers[i].thread, NULL, run_worker, &workers[i])) {
+			fprintf(stderr, "Unable to start worker %d.\n", i);
+			status = -1;
+			break;
+		}
+		workers[i].started = 1;
+	}
+
+	/* the jobs left by a worker that failed to start go to the others */
+	for(i = 0; i < nworkers; i++) {
+		if(workers[i].started) {
+			pthread_join(workers[i].thread, NULL);
+		}
+	}
+
+	if(status) {
+		run_worker(&workers[0]);
+		status = 0;
+	}
+
+	return status;
+}
+
+
+/** Function: run_worker
+ ** Thread body: takes the next job of the round, solves its weighted sum on
+ ** the private LP object of the worker and computes the objective vector of
+ ** the solution.
+ **/
+static void * run_worker(void * arg)
+{
+	WS_WORKER * worker = arg;
+	WS_ROUND * round = worker->round;
+	const WEIGHT_SPACE * ws = round->ws;
+	ANCHOR_STATS stats;
+	WS_JOB * job;
+	int k;
+
+	for(;;) {
+		pthread_mutex_lock(&round->lock);
+		job = round->next < round->njobs ? &round->jobs[round->next++] : NULL;
+		pthread_mutex_unlock(&round->lock);
+
+		if(!job) {
+			break;
+		}
+
+		job->solution = get_weighted_solution(worker->env, worker->lp, ws->nobjs, ws->costs, job->weights,
+		                                      job->start ? ANCHOR_SIMPLEX : ws->engine, &ws->portfolio, job->start,
+		                                      &stats);
+		if(!job->solution || job->solution->solstat != CPX_STAT_OPTIMAL) {
+			fprintf(stderr, "Weighted solve failed.\n");
+			job->status = -1;
+			continue;
+		}
+
+		for(k = 0; k < ws->nobjs; k++) {
+			job->values[k] = objective_value(ws->costs[k], job->solution->x, ws->narcs);
+		}
+		job->iterations = stats.iterations;
+	}
+
+	return NULL;
+}
+
+
+/** Function: merge_job
+ ** Adds the result of a solved job to the weight space: its point if the
+ ** weighted sum beats the envelope at the vertex, otherwise the vertex is
+ ** confirmed.
+ **/
+static int merge_job(WEIGHT_SPACE * ws, WS_JOB * job)
+{
+	double value = 0.0;
+	int i, k;
+
+	if(job->status) {
+		return job->status;
+	}
+
+	ws->solves++;
+	ws->warm_solves += job->start != NULL;
+	ws->iterations += job->iterations;
+
+	for(k = 0; k < ws->nobjs; k++) {
+		value += job->weights[k] * job->values[k];
+	}
+
+	if(value < job->bound - WS_TOL * (1.0 + fabs(job->bound))) {
+		if(push_point(ws, job)) {
+			return -1;
+		}
+
+		/* found again by an earlier job of the round: nothing is cut */
+		switch(add_cut(ws, ws->npoints - 1)) {
+		case 0:
+			ws->npoints--;
+			free_basis(&ws->points[ws->npoints].basis);
+			break;
+		case -1:
+			return -1;
+		}
+		return 0;
+	}
+
+	for(i = 0; i < ws->nvertices; i++) {
+		if(ws->vertices[i].id == job->vertex) {
+			ws->vertices[i].confirmed = 1;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+
+/** Function: first_envelope
+ ** Builds the envelope of the first point: one vertex at every corner of the
+ ** weight simplex, where all but one weight are at their floor.
+ **/
+static int first_envelope(WEIGHT_SPACE * ws)
+{
+	const int K = ws->nobjs;
+	double u[WS_MAX_OBJECTIVES];
+	double lambda[WS_MAX_OBJECTIVES];
+	int tight[WS_MAX_OBJECTIVES];
+	int c, i, n;
+
+	for(c = 0; c < K; c++) {
+		for(i = 0; i < K; i++) {
+			lambda[i] = i == c ? 1.0 - (K - 1) * WS_FLOOR : WS_FLOOR;
+		}
+
+		u[K - 1] = 0.0;
+		for(i = 0; i < K; i++) {
+			u[K - 1] += lambda[i] * ws->points[0].values[i];
+		}
+		for(i = 0; i < K - 1; i++) {
+			u[i] = lambda[i];
+		}
+
+		for(i = 0, n = 0; i < K; i++) {
+			if(i != c) {
+				tight[n++] = i;
+			}
+		}
+		tight[n++] = K;
+
+		if(push_vertex(ws, u, tight, n)) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+
+/** Function: add_cut
+ ** Cuts the envelope by the weighted sums of point p, one step of the double
+ ** description method: the vertices above the cut are removed and a new
+ ** vertex is placed where the cut crosses every edge between a removed
+ ** vertex and a kept one. Besides the vertices, the region below the
+ ** envelope has a single ray, straight down, whose edges are the vertical
+ ** lines through the vertices on the border of the simplex. Two generators
+ ** are adjacent when no other one is tight on all the constraints they share.
+ ** Returns the number of vertices removed, 0 if the point doesn't cut the
+ ** envelope, or -1 on error.
+ **/
+static int add_cut(WEIGHT_SPACE * ws, int p)
+{
+	const int K = ws->nobjs;
+	const int cut = K + p;
+	static const int ray_tight[WS_MAX_OBJECTIVES] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+	double a[WS_MAX_OBJECTIVES], b;
+	double * s = NULL;
+	int * side = NULL;
+	int * common = NULL;
+	int nold = ws->nvertices;
+	int removed = 0;
+	int status = 0;
+	int i, j, x, n, d;
+
+	constraint(ws, cut, a, &b);
+
+	s = malloc((nold > 0 ? nold : 1) * sizeof(double));
+	side = malloc((nold > 0 ? nold : 1) * sizeof(int));
+	common = malloc((cut + 1) * sizeof(int));
+	if(!s || !side || !common) {
+		fprintf(stderr, "Unable to alloc envelope cut.\n");
+		status = -1;
+		goto TERMINATE;
+	}
+
+	for(i = 0; i < nold; i++) {
+		const WS_VERTEX * v = &ws->vertices[i];
+		double tol = WS_TOL * (1.0 + fabs(v->u[K - 1]));
+
+		s[i] = -b;
+		for(d = 0; d < K; d++) {
+			s[i] += a[d] * v->u[d];
+		}
+		side[i] = s[i] > tol ? 1 : (s[i] < -tol ? -1 : 0);
+		removed += side[i] > 0;
+	}
+
+	if(!removed) {
+		goto TERMINATE;
+	}
+
+	for(i = 0; i < nold; i++) {
+		if(side[i] <= 0) {
+			continue;
+		}
+
+		/* j == nold stands for the ray */
+		for(j = 0; j <= nold; j++) {
+			const int * tj = j < nold ? ws->vertices[j].tight : ray_tight;
+			int ntj = j < nold ? ws->vertices[j].ntight : K;
+			double u[WS_MAX_OBJECTIVES];
+			int adjacent = 1;
+
+			if(j < nold && side[j] >= 0) {
+				continue;
+			}
+
+			n = common_tight(&ws->vertices[i], tj, ntj, common);
+			if(n < K - 1) {
+				continue;
+			}
+
+			for(x = 0; x <= nold && adjacent; x++) {
+				if(x == i || x == j) {
+					continue;
+				}
+				adjacent = x < nold ? !contains(ws->vertices[x].tight, ws->vertices[x].ntight, common, n)
+				                    : !contains(ray_tight, K, common, n);
+			}
+			if(!adjacent) {
+				continue;
+			}
+
+			for(d = 0; d < K; d++) {
+				u[d] = ws->vertices[i].u[d];
+			}
+			if(j < nold) {
+				double alpha = s[i] / (s[i] - s[j]);
+				for(d = 0; d < K; d++) {
+					u[d] += alpha * (ws->vertices[j].u[d] - u[d]);
+				}
+			} else {
+				u[K - 1] -= s[i];
+			}
+
+			common[n++] = cut;
+			if(push_vertex(ws, u, common, n)) {
+				status = -1;
+				goto TERMINATE;
+			}
+		}
+	}
+
+	/* the new vertices were appended after the old ones */
+	for(i = 0, n = 0; i < ws->nvertices; i++) {
+		WS_VERTEX * v = &ws->vertices[i];
+
+		if(i < nold && side[i] > 0) {
+			free(v->tight);
+			continue;
+		}
+
+		if(i < nold && side[i] == 0) {
+			int * tmp = realloc(v->tight, (v->ntight + 1) * sizeof(int));
+			if(!tmp) {
+				fprintf(stderr, "Unable to alloc vertex.\n");
+				status = -1;
+			} else {
+				v->tight = tmp;
+				v->tight[v->ntight++] = cut;
+			}
+		}
+
+		ws->vertices[n++] = *v;
+	}
+	ws->nvertices = n;
+
+
+TERMINATE:
+
+	free(s);
+	free(side);
+	free(common);
+
+	return status ? status : removed;
+}
+
+
+/** Function: constraint
+ ** Returns constraint j of the region below the envelope as a*u <= b, with
+ ** u the first K-1 weights followed by the envelope value. Constraints
+ ** 0..K-1 are the weight floors and K+p the cut of point p:
+ **		t <= sum_i w_i*y_i,  with w_K = 1 - w_1 - ... - w_K-1
+ **/
+static void constraint(const WEIGHT_SPACE * ws, int j, double * a, double * b)
+{
+	const int K = ws->nobjs;
+	int i;
+
+	for(i = 0; i < K; i++) {
+		a[i] = 0.0;
+	}
+
+	if(j < K - 1) {
+		a[j] = -1.0;
+		*b = -WS_FLOOR;
+	} else if(j == K - 1) {
+		for(i = 0; i < K - 1; i++) {
+			a[i] = 1.0;
+		}
+		*b = 1.0 - WS_FLOOR;
+	} else {
+		const double * y = ws->points[j - K].values;
+		for(i = 0; i < K - 1; i++) {
+			a[i] = -(y[i] - y[K - 1]);
+		}
+		a[K - 1] = 1.0;
+		*b = y[K - 1];
+	}
+}
+
+
+/** Function: common_tight
+ ** Writes the constraints tight at both the vertex and the sorted list t to
+ ** out, in increasing order, and returns their number.
+ **/
+static int common_tight(const WS_VERTEX * v, const int * t, int nt, int * out)
+{
+	int i = 0, j = 0, n = 0;
+
+	while(i < v->ntight && j < nt) {
+		if(v->tight[i] < t[j]) {
+			i++;
+		} else if(v->tight[i] > t[j]) {
+			j++;
+		} else {
+			out[n++] = v->tight[i];
+			i++;
+			j++;
+		}
+	}
+
+	return n;
+}
+
+
+/** Function: contains
+ ** Returns 1 if the sorted list a holds every element of the sorted list b.
+ **/
+static int contains(const int * a, int na, const int * b, int nb)
+{
+	int i = 0, j = 0;
+
+	if(nb > na) {
+		return 0;
+	}
+
+	while(j < nb) {
+		while(i < na && a[i] < b[j]) {
+			i++;
+		}
+		if(i == na || a[i] != b[j]) {
+			return 0;
+		}
+		i++;
+		j++;
+	}
+
+	return 1;
+}
+
+
+/** Function: push_vertex
+ ** Appends an open vertex with the given position and tight constraints.
+ **/
+static int push_vertex(WEIGHT_SPACE * ws, const double * u, const int * tight, int ntight)
+{
+	WS_VERTEX * v;
+
+	if(ws->nvertices == ws->cvertices) {
+		int grown = ws->cvertices ? 2 * ws->cvertices : 64;
+		WS_VERTEX * tmp = realloc(ws->vertices, grown * sizeof(WS_VERTEX));
+		if(!tmp) {
+			fprintf(stderr, "Unable to alloc vertices.\n");
+			return -1;
+		}
+		ws->vertices = tmp;
+		ws->cvertices = grown;
+	}
+
+	v = &ws->vertices[ws->nvertices];
+	memset(v, 0, sizeof(WS_VERTEX));
+	memcpy(v->u, u, ws->nobjs * sizeof(double));
+
+	v->tight = malloc(ntight * sizeof(int));
+	if(!v->tight) {
+		fprintf(stderr, "Unable to alloc vertex.\n");
+		return -1;
+	}
+	memcpy(v->tight, tight, ntight * sizeof(int));
+	v->ntight = ntight;
+	v->id = ws->next_id++;
+
+	ws->nvertices++;
+
+	return 0;
+}
+
+
+/** Function: push_point
+ ** Appends the point found by a job, taking over the basis of its solution.
+ **/
+static int push_point(WEIGHT_SPACE * ws, const WS_JOB * job)
+{
+	WS_POINT * p;
+
+	if(ws->npoints == ws->cpoints) {
+		int grown = ws->cpoints ? 2 * ws->cpoints : 64;
+		WS_POINT * tmp = realloc(ws->points, grown * sizeof(WS_POINT));
+		if(!tmp) {
+			fprintf(stderr, "Unable to alloc points.\n");
+			return -1;
+		}
+		ws->points = tmp;
+		ws->cpoints = grown;
+	}
+
+	p = &ws->points[ws->npoints];
+	memset(p, 0, sizeof(WS_POINT));
+	memcpy(p->values, job->values, ws->nobjs * sizeof(double));
+	memcpy(p->weights, job->weights, ws->nobjs * sizeof(double));
+	p->basis = job->solution->basis;
+	job->solution->basis = NULL;
+
+	ws->npoints++;
+
+	return 0;
+}
+
+
+/** Function: vertex_weights
+ ** Returns the K weights at the vertex, kept above the floor against the
+ ** rounding errors of the cuts.
+ **/
+static void vertex_weights(const WEIGHT_SPACE * ws, const WS_VERTEX * v, double * weights)
+{
+	const int K = ws->nobjs;
+	double last = 1.0;
+	int i;
+
+	for(i = 0; i < K - 1; i++) {
+		weights[i] = v->u[i] < WS_FLOOR ? WS_FLOOR : v->u[i];
+		last -= v->u[i];
+	}
+	weights[K - 1] = last < WS_FLOOR ? WS_FLOOR : last;
+}
+
+
+/** Function: compare_points
+ ** qsort comparison: lexicographic order of the objective vectors.
+ **/
+static int compare_points(const void * a, const void * b)
+{
+	const WS_POINT * pa = a;
+	const WS_POINT * pb = b;
+	int k;
+
+	for(k = 0; k < WS_MAX_OBJECTIVES; k++) {
+		if(pa->values[k] < pb->values[k]) return -1;
+		if(pa->values[k] > pb->values[k]) return 1;
+	}
+
+	return 0;
+}
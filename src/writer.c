@@ -0,0 +1,386 @@
+/*************************
+ *** System Interfaces ***
+ *************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/**************************
+ *** Solver Interfaces ***
+ **************************/
+#include "network.h"
+#include "solver.h"
+#include "writer.h"
+
+
+
+
+/*****************************
+ *** Constants Definitions ***
+ *****************************/
+
+/** Size of the stdio buffer of the output stream, so that the I/O thread
+ ** hands large blocks to the kernel.
+ **/
+#define WRITER_STREAM_BUFFER (1 << 20)
+
+/** Number of busy retries before a waiting side starts to sleep **/
+#define WRITER_SPINS 64
+
+/** Sleep of a waiting side once it stopped spinning, in nanoseconds **/
+#define WRITER_SLEEP_NS 100000L
+
+
+
+
+/****************************
+ *** Forward Declarations ***
+ ****************************/
+static void * drain_records(void *);
+static void write_record(WRITER *, const WRITER_RECORD *);
+static WRITER_RECORD * reserve_slot(WRITER *);
+static void publish_slot(WRITER *);
+static void backoff(unsigned long);
+
+
+
+
+/*** Functions Definitions ***/
+
+/** Function: create_writer
+ ** Creates the ring buffer with room for the given number of records, rounded
+ ** up to a power of two, and starts the I/O thread. Records are written to the
+ ** file with the given name or to the standard output if it is NULL. Returns
+ ** NULL if any error is detected.
+ **/
+WRITER * create_writer(const char * filename, int narcs, int nnodes, unsigned long slots)
+{
+	WRITER * writer = NULL;
+	unsigned long capacity = 1;
+	unsigned long i;
+
+	if(slots == 0) {
+		slots = WRITER_DEFAULT_SLOTS;
+	}
+
+	while(capacity < slots) {
+		capacity <<= 1;
+	}
+
+	writer = calloc(1, sizeof(WRITER));
+	if(!writer) {
+		fprintf(stderr, "Unable to alloc writer.\n");
+		return NULL;
+	}
+
+	writer->capacity = capacity;
+	writer->narcs = narcs;
+	writer->nnodes = nnodes;
+	atomic_init(&writer->head, 0);
+	atomic_init(&writer->tail, 0);
+	atomic_init(&writer->closing, 0);
+
+	writer->slots = calloc(capacity, sizeof(WRITER_RECORD));
+	if(!writer->slots) {
+		fprintf(stderr, "Unable to alloc writer slots.\n");
+		goto TERMINATE;
+	}
+
+	for(i = 0; i < capacity; i++) {
+		writer->slots[i].solution1 = create_solution(narcs, nnodes);
+		writer->slots[i].solution2 = create_solution(narcs, nnodes);
+		if(!writer->slots[i].solution1 || !writer->slots[i].solution2) {
+			fprintf(stderr, "Unable to alloc writer slot %lu.\n", i);
+			goto TERMINATE;
+		}
+	}
+
+	if(filename) {
+		writer->out = fopen(filename, "w");
+		if(!writer->out) {
+			fprintf(stderr, "Unable to open output file %s.\n", filename);
+			goto TERMINATE;
+		}
+		writer->owns_out = 1;
+	} else {
+		writer->out = stdout;
+	}
+
+	setvbuf(writer->out, NULL, _IOFBF, WRITER_STREAM_BUFFER);
+
+	if(pthread_create(&writer->thread, NULL, drain_records, writer)) {
+		fprintf(stderr, "Unable to start writer thread.\n");
+		goto TERMINATE;
+	}
+	writer->running = 1;
+
+	return writer;
+
+TERMINATE:
+
+	close_writer(&writer);
+
+	return NULL;
+}
+
+
+/** Function: close_writer
+ ** Waits until the I/O thread wrote every pending record, flushes and closes
+ ** the output stream and frees the writer. Returns a non-zero value if any
+ ** write to the output stream failed.
+ **/
+int close_writer(WRITER ** writer_p)
+{
+	WRITER * writer;
+	int status = 0;
+	unsigned long i;
+
+	if(!writer_p || !*writer_p) {
+		return 0;
+	}
+
+	writer = *writer_p;
+
+	if(writer->running) {
+		atomic_store_explicit(&writer->closing, 1, memory_order_release);
+		pthread_join(writer->thread, NULL);
+	}
+
+	if(writer->out) {
+		if(fflush(writer->out) || ferror(writer->out)) {
+			fprintf(stderr, "Error writing solver output.\n");
+			status = -1;
+		}
+
+		if(writer->owns_out) {
+			fclose(writer->out);
+		}
+	}
+
+	if(writer->stalls) {
+		fprintf(stderr, "Writer: pivot loop waited for a free slot %lu times.\n", writer->stalls);
+	}
+
+	if(writer->slots) {
+		for(i = 0; i < writer->capacity; i++) {
+			free_solution(&writer->slots[i].solution1);
+			free_solution(&writer->slots[i].solution2);
+		}
+		free(writer->slots);
+	}
+
+	free(writer->slot_flow);
+	free(writer->orig_flow);
+	free(writer);
+	*writer_p = NULL;
+
+	return status;
+}
+
+
+/** Function: writer_iteration
+ ** Iteration callback that queues a copy of both solutions of the iteration
+ ** into the WRITER passed as callback data. Only memory copies are made on the
+ ** calling thread.
+ **/
+int writer_iteration(const SOLVER_ITERATION * it, void * data)
+{
+	WRITER * writer = data;
+	WRITER_RECORD * record = reserve_slot(writer);
+
+	record->kind = WRITER_ITERATION;
+	record->iteration = it->iteration;
+	record->arc = it->arc;
+	record->elapsed = it->elapsed;
+	copy_solution(record->solution1, it->solution1, writer->narcs, writer->nnodes);
+	copy_solution(record->solution2, it->solution2, writer->narcs, writer->nnodes);
+
+	publish_slot(writer);
+
+	return 0;
+}
+
+
+/** Function: writer_text
+ ** Queues a formatted line of text, truncated to WRITER_TEXT_SIZE characters,
+ ** keeping its order relative to the iteration records.
+ **/
+int writer_text(WRITER * writer, const char * format, ...)
+{
+	WRITER_RECORD * record;
+	va_list args;
+
+	if(!writer || !format) {
+		return -1;
+	}
+
+	record = reserve_slot(writer);
+	record->kind = WRITER_TEXT;
+
+	va_start(args, format);
+	vsnprintf(record->text, WRITER_TEXT_SIZE, format, args);
+	va_end(args);
+
+	publish_slot(writer);
+
+	return 0;
+}
+
+
+/** Function: writer_set_reduction
+ ** Makes the I/O thread also write the flow of every arc of the original
+ ** network, expanded from the flows of the reduced one. It must be called
+ ** before any record is queued. The reduction is not copied and must outlive
+ ** the writer.
+ **/
+int writer_set_reduction(WRITER * writer, const NET_REDUCTION * reduction)
+{
+	if(!writer || !reduction) {
+		return -1;
+	}
+
+	writer->slot_flow = malloc(reduction->nslots * sizeof(double));
+	writer->orig_flow = malloc(reduction->orig_narcs * sizeof(double));
+	if(!writer->slot_flow || !writer->orig_flow) {
+		fprintf(stderr, "Unable to alloc writer flow buffers.\n");
+		free_and_null((void **) &writer->slot_flow);
+		free_and_null((void **) &writer->orig_flow);
+		return -1;
+	}
+
+	writer->reduction = reduction;
+
+	return 0;
+}
+
+
+/** Function: drain_records
+ ** Routine of the I/O thread. Records are formatted and written in the order
+ ** they were queued. The stream is flushed whenever the buffer runs empty and
+ ** the thread leaves once closing is set and no record is pending.
+ **/
+static void * drain_records(void * data)
+{
+	WRITER * writer = data;
+	unsigned long tail = atomic_load_explicit(&writer->tail, memory_order_relaxed);
+	unsigned long idle = 0;
+
+	while(1) {
+		unsigned long head = atomic_load_explicit(&writer->head, memory_order_acquire);
+
+		if(tail == head) {
+			if(atomic_load_explicit(&writer->closing, memory_order_acquire)) {
+				if(tail == atomic_load_explicit(&writer->head, memory_order_acquire)) {
+					break;
+				}
+				continue;
+			}
+
+			if(idle++ == 0) {
+				fflush(writer->out);
+			}
+			backoff(idle);
+			continue;
+		}
+
+		idle = 0;
+
+		while(tail != head) {
+			write_record(writer, &writer->slots[tail & (writer->capacity - 1)]);
+			tail++;
+			atomic_store_explicit(&writer->tail, tail, memory_order_release);
+		}
+	}
+
+	fflush(writer->out);
+
+	return NULL;
+}
+
+
+/** Function: write_record
+ ** Formats one record to the output stream of the writer.
+ **/
+static void write_record(WRITER * writer, const WRITER_RECORD * record)
+{
+	if(record->kind == WRITER_TEXT) {
+		fputs(record->text, writer->out);
+		return;
+	}
+
+	if(record->arc >= 0) {
+		fprintf(writer->out, "Entering arc: %d\n", record->arc);
+		fprintf(writer->out, "Time Elapsed: %lf s\n", record->elapsed);
+	}
+
+	fprint_solution(writer->out, record->solution1, writer->narcs, writer->nnodes);
+	fprint_solution(writer->out, record->solution2, writer->narcs, writer->nnodes);
+
+	/* both solutions share the same flow, only the costs differ */
+	if(writer->reduction) {
+		int i;
+
+		expand_flow(writer->reduction, record->solution1->x, writer->slot_flow, writer->orig_flow);
+
+		fprintf(writer->out, "Original Arc Flows:\n");
+		for(i = 0; i < writer->reduction->orig_narcs; i++) {
+			fprintf(writer->out, "Arc %d: %lf\n", i, writer->orig_flow[i]);
+		}
+		fprintf(writer->out, "\n");
+	}
+}
+
+
+/** Function: reserve_slot
+ ** Returns the slot the producer must fill next. If every slot is still
+ ** pending the producer waits for the I/O thread to free one (backpressure).
+ **/
+static WRITER_RECORD * reserve_slot(WRITER * writer)
+{
+	unsigned long head = atomic_load_explicit(&writer->head, memory_order_relaxed);
+	unsigned long spins = 0;
+
+	while(head - atomic_load_explicit(&writer->tail, memory_order_acquire) >= writer->capacity) {
+		if(spins++ == 0) {
+			writer->stalls++;
+		}
+		backoff(spins);
+	}
+
+	return &writer->slots[head & (writer->capacity - 1)];
+}
+
+
+/** Function: publish_slot
+ ** Hands the slot returned by reserve_slot() to the I/O thread.
+ **/
+static void publish_slot(WRITER * writer)
+{
+	unsigned long head = atomic_load_explicit(&writer->head, memory_order_relaxed);
+
+	atomic_store_explicit(&writer->head, head + 1, memory_order_release);
+}
+
+
+/** Function: backoff
+ ** Wait policy of both sides: yield for the first retries and then sleep for
+ ** a short period between retries.
+ **/
+static void backoff(unsigned long retries)
+{
+	struct timespec ts;
+
+	if(retries < WRITER_SPINS) {
+		sched_yield();
+		return;
+	}
+
+	ts.tv_sec = 0;
+	ts.tv_nsec = WRITER_SLEEP_NS;
+	nanosleep(&ts, NULL);
+}